@@ -0,0 +1,49 @@
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifndef BENCH_H
+#define BENCH_H
+
+/* default number of operations per benchmark run */
+#define BENCH_NOPS 1000000
+
+/**
+ * Get monotonic time in seconds
+ */
+static double
+bench_now(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/**
+ * Number of operations from the command line or the default
+ */
+static int
+bench_nops(int argc, char *argv[])
+{
+  if (argc > 1)
+    return atoi(argv[1]);
+  return BENCH_NOPS;
+}
+
+/**
+ * Print a benchmark result line
+ * @param[in] name: benchmark name
+ * @param[in] nops: number of operations performed
+ * @param[in] elapsed: elapsed time in seconds
+ */
+static void
+bench_report(const char *name, long nops, double elapsed)
+{
+  printf("%-32s %10ld ops %10.3f ms %12.0f ops/s\n", name, nops,
+	 elapsed * 1e3, nops / elapsed);
+}
+
+#endif
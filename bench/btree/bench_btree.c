@@ -0,0 +1,83 @@
+
+#include "bench.h"
+
+#include "libutils/btree.h"
+#include "libutils/error.h"
+#include "libutils/list.h"
+
+/* width of the range queries */
+#define RANGE 100
+
+static int
+cmp_long(void *a, void *b)
+{
+  return ((long)a > (long)b) - ((long)a < (long)b);
+}
+
+static int
+range_cbk(void *itm_data, void *args)
+{
+  long *bounds = args;
+
+  if ((long)itm_data >= bounds[0] && (long)itm_data < bounds[1])
+    bounds[2]++;
+  return UTILS_OK;
+}
+
+int
+main(int argc, char *argv[])
+{
+  btree_t tree;
+  list_t lst;
+  double start;
+  long i, k, bounds[3] = {0, 0, 0};
+  int nops = bench_nops(argc, argv);
+  int nkeys = nops / 100;
+
+  /* keys inserted in a scrambled order */
+  btree_init(&tree, cmp_long, NULL, NULL);
+  start = bench_now();
+  for (i = 0; i < nops; i++) {
+    k = (i * 7919) % nops;
+    btree_insert(tree, (void *)k, (void *)k);
+  }
+  bench_report("btree_insert", nops, bench_now() - start);
+
+  start = bench_now();
+  for (i = 0; i < nops; i++)
+    bounds[2] += (long)btree_find(tree, (void *)((i * 104729) % nops));
+  bench_report("btree_find", nops, bench_now() - start);
+
+  start = bench_now();
+  for (i = 0; i < nops / RANGE; i++) {
+    bounds[0] = (i * 104729) % (nops - RANGE);
+    bounds[1] = bounds[0] + RANGE;
+    btree_walk_range(tree, (void *)bounds[0], (void *)bounds[1],
+		     range_cbk, bounds);
+  }
+  bench_report("btree_walk_range 100 keys", nops / RANGE,
+	       bench_now() - start);
+
+  start = bench_now();
+  for (i = 0; i < nops; i++)
+    btree_remove(tree, (void *)((i * 7919) % nops));
+  bench_report("btree_remove", nops, bench_now() - start);
+  btree_destroy(tree);
+
+  /* the same range queries on a list need a full scan each */
+  list_init(&lst, NULL, NULL);
+  for (i = 0; i < nkeys; i++)
+    list_append(lst, (void *)((i * 7919) % nkeys));
+  start = bench_now();
+  for (i = 0; i < nkeys / RANGE; i++) {
+    bounds[0] = (i * 104729) % (nkeys - RANGE);
+    bounds[1] = bounds[0] + RANGE;
+    list_walk(lst, range_cbk, bounds);
+  }
+  bench_report("list_walk range scan", nkeys / RANGE, bench_now() - start);
+  list_destroy(lst);
+
+  if (bounds[2] == 0)
+    printf("unexpected checksum\n");
+  return 0;
+}
@@ -0,0 +1,79 @@
+
+#include "bench.h"
+
+#include <string.h>
+
+#include "libutils/error.h"
+#include "libutils/hashmap.h"
+#include "libutils/list.h"
+
+/* number of keys, the scans are linear in it */
+#define NKEYS 1000
+
+static char keys[NKEYS][16];
+
+int
+main(int argc, char *argv[])
+{
+  list_iter_struct_t iter;
+  hashmap_t map;
+  list_t lst;
+  double start;
+  long i, k, sum = 0;
+  int nops = bench_nops(argc, argv) / 10;
+
+  for (i = 0; i < NKEYS; i++)
+    snprintf(keys[i], sizeof(keys[i]), "key%ld", i);
+
+  /* pointer keys: position lookup against hash lookup */
+  list_init(&lst, NULL, NULL);
+  for (i = 0; i < NKEYS; i++)
+    list_append(lst, keys[i]);
+  start = bench_now();
+  for (i = 0; i < nops; i++)
+    sum += list_indexof(lst, keys[(i * 7919) % NKEYS]);
+  bench_report("list_indexof pointer", nops, bench_now() - start);
+
+  hashmap_init(&map, HASHMAP_KEY_POINTER, NULL, NULL);
+  for (i = 0; i < NKEYS; i++)
+    hashmap_insert(map, keys[i], (void *)i);
+  start = bench_now();
+  for (i = 0; i < nops; i++)
+    sum += (long)hashmap_get(map, keys[(i * 7919) % NKEYS]);
+  bench_report("hashmap_get pointer", nops, bench_now() - start);
+  hashmap_destroy(map);
+
+  /* string keys: strcmp scan against hash lookup */
+  start = bench_now();
+  for (i = 0; i < nops; i++) {
+    k = 0;
+    for (list_iter_init(lst, &iter); !list_iter_end(&iter);
+	 list_iter_next(&iter), k++)
+      if (strcmp(list_iter_data(&iter), keys[(i * 7919) % NKEYS]) == 0)
+	break;
+    sum += k;
+  }
+  bench_report("list strcmp scan", nops, bench_now() - start);
+  list_destroy(lst);
+
+  hashmap_init(&map, HASHMAP_KEY_STRING, NULL, NULL);
+  for (i = 0; i < NKEYS; i++)
+    hashmap_insert(map, keys[i], (void *)i);
+  start = bench_now();
+  for (i = 0; i < nops; i++)
+    sum += (long)hashmap_get(map, keys[(i * 7919) % NKEYS]);
+  bench_report("hashmap_get string", nops, bench_now() - start);
+
+  start = bench_now();
+  for (i = 0; i < nops; i++) {
+    k = (i * 7919) % NKEYS;
+    hashmap_remove(map, keys[k]);
+    hashmap_insert(map, keys[k], (void *)k);
+  }
+  bench_report("hashmap remove and insert", nops, bench_now() - start);
+  hashmap_destroy(map);
+
+  if (sum == 0)
+    printf("unexpected checksum\n");
+  return 0;
+}
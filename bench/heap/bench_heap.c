@@ -0,0 +1,75 @@
+
+#include "bench.h"
+
+#include "libutils/error.h"
+#include "libutils/heap.h"
+#include "libutils/list.h"
+
+static int
+cmp_long(void *a, void *b)
+{
+  return ((long)a > (long)b) - ((long)a < (long)b);
+}
+
+int
+main(int argc, char *argv[])
+{
+  static void *data[1000000];
+  heap_entry_t entry;
+  heap_t heap;
+  list_t lst;
+  double start;
+  long i, sum = 0;
+  int nops = bench_nops(argc, argv);
+  int nlist = nops / 100;
+
+  if (nops > 1000000)
+    nops = 1000000;
+  for (i = 0; i < nops; i++)
+    data[i] = (void *)((i * 7919) % nops);
+
+  /* timer queue: scrambled deadlines in, earliest out */
+  list_init(&lst, NULL, NULL);
+  start = bench_now();
+  for (i = 0; i < nlist; i++)
+    list_insert_sorted(lst, data[i], cmp_long);
+  for (i = 0; i < nlist; i++)
+    sum += (long)list_remove(lst, 0);
+  bench_report("list_insert_sorted and pop", nlist, bench_now() - start);
+  list_destroy(lst);
+
+  heap_init(&heap, cmp_long, NULL, NULL);
+  start = bench_now();
+  for (i = 0; i < nlist; i++)
+    heap_push(heap, data[i], NULL);
+  for (i = 0; i < nlist; i++)
+    sum += (long)heap_pop(heap);
+  bench_report("heap_push and pop", nlist, bench_now() - start);
+
+  start = bench_now();
+  for (i = 0; i < nops; i++)
+    heap_push(heap, data[i], NULL);
+  for (i = 0; i < nops; i++)
+    sum += (long)heap_pop(heap);
+  bench_report("heap_push and pop large", nops, bench_now() - start);
+
+  start = bench_now();
+  heap_push_n(heap, data, nops);
+  bench_report("heap_push_n", nops, bench_now() - start);
+  heap_destroy(heap);
+
+  /* push with handles and remove every other entry */
+  heap_init(&heap, cmp_long, NULL, NULL);
+  start = bench_now();
+  for (i = 0; i < nops; i++) {
+    heap_push(heap, data[i], &entry);
+    if (i % 2)
+      sum += (long)heap_remove(heap, entry);
+  }
+  bench_report("heap_push and heap_remove", nops, bench_now() - start);
+  heap_destroy(heap);
+
+  if (sum == 0)
+    printf("unexpected checksum\n");
+  return 0;
+}
@@ -0,0 +1,73 @@
+
+#include "bench.h"
+
+#include "libutils/error.h"
+#include "libutils/ilist.h"
+#include "libutils/list.h"
+
+struct object {
+  long value;
+  struct ilist_link link;
+};
+
+static int
+list_sum_cbk(void *itm_data, void *args)
+{
+  *(long *)args += ((struct object *)itm_data)->value;
+  return UTILS_OK;
+}
+
+static int
+ilist_sum_cbk(struct ilist_link *link, void *args)
+{
+  *(long *)args += ilist_entry(link, struct object, link)->value;
+  return UTILS_OK;
+}
+
+int
+main(int argc, char *argv[])
+{
+  struct object *objs;
+  struct ilist ilst;
+  list_t lst;
+  double start;
+  long i, sum;
+  int nops = bench_nops(argc, argv);
+
+  objs = malloc(nops * sizeof(struct object));
+  for (i = 0; i < nops; i++)
+    objs[i].value = i;
+
+  sum = 0;
+  list_init(&lst, NULL, NULL);
+  start = bench_now();
+  for (i = 0; i < nops; i++)
+    list_append(lst, &objs[i]);
+  bench_report("list append", nops, bench_now() - start);
+  start = bench_now();
+  list_walk(lst, list_sum_cbk, &sum);
+  bench_report("list walk", nops, bench_now() - start);
+  start = bench_now();
+  for (i = 0; i < nops; i++)
+    list_pop(lst);
+  bench_report("list pop", nops, bench_now() - start);
+  list_destroy(lst);
+
+  ilist_init(&ilst);
+  start = bench_now();
+  for (i = 0; i < nops; i++)
+    ilist_append(&ilst, &objs[i].link);
+  bench_report("ilist append", nops, bench_now() - start);
+  start = bench_now();
+  ilist_walk(&ilst, ilist_sum_cbk, &sum);
+  bench_report("ilist walk", nops, bench_now() - start);
+  start = bench_now();
+  for (i = 0; i < nops; i++)
+    ilist_pop(&ilst);
+  bench_report("ilist pop", nops, bench_now() - start);
+
+  free(objs);
+  if (sum == 0)
+    printf("unexpected checksum\n");
+  return 0;
+}
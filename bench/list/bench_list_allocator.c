@@ -0,0 +1,91 @@
+#include "bench.h"
+
+#include "libutils/error.h"
+#include "libutils/list.h"
+
+/* size of an arena block */
+#define ARENA_BLOCK (1 << 20)
+
+/**
+ * Bump allocator, the objects are released at once with the arena
+ */
+struct arena {
+  char *block;
+  size_t used;
+  void **blocks;
+  size_t nblocks;
+};
+
+static void *
+arena_alloc(size_t size, void *ctx)
+{
+  struct arena *arena = ctx;
+  void *ptr;
+
+  size = (size + 15) & ~(size_t)15;
+  if (arena->block == NULL || arena->used + size > ARENA_BLOCK) {
+    arena->block = malloc(ARENA_BLOCK);
+    arena->blocks = realloc(arena->blocks,
+			    (arena->nblocks + 1) * sizeof(void *));
+    arena->blocks[arena->nblocks++] = arena->block;
+    arena->used = 0;
+  }
+  ptr = arena->block + arena->used;
+  arena->used += size;
+  return ptr;
+}
+
+static void
+arena_free(void *ptr, void *ctx)
+{
+}
+
+static void
+arena_release(struct arena *arena)
+{
+  size_t i;
+
+  for (i = 0; i < arena->nblocks; i++)
+    free(arena->blocks[i]);
+  free(arena->blocks);
+  memset(arena, 0, sizeof(*arena));
+}
+
+static double
+bench_churn(const list_allocator_t *allocator, int nops)
+{
+  list_t lst;
+  double start;
+  long i;
+
+  start = bench_now();
+  list_init_ex(&lst, NULL, NULL, 0, allocator);
+  for (i = 0; i < nops; i++)
+    list_append(lst, (void *)i);
+  for (i = 0; i < nops; i++) {
+    list_pop(lst);
+    list_append(lst, (void *)i);
+  }
+  list_destroy(lst);
+  return bench_now() - start;
+}
+
+int
+main(int argc, char *argv[])
+{
+  struct arena arena;
+  list_allocator_t allocator = {arena_alloc, arena_free, &arena};
+  int nops = bench_nops(argc, argv);
+  double start, secs;
+
+  bench_report("malloc append, pop, destroy", 2 * nops,
+	       bench_churn(NULL, nops));
+
+  memset(&arena, 0, sizeof(arena));
+  secs = bench_churn(&allocator, nops);
+  start = bench_now();
+  arena_release(&arena);
+  secs += bench_now() - start;
+  bench_report("arena append, pop, destroy", 2 * nops, secs);
+  return 0;
+}
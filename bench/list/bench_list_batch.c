@@ -0,0 +1,81 @@
+#include "bench.h"
+
+#include "libutils/error.h"
+#include "libutils/list.h"
+
+/**
+ * Build a list one element at a time
+ */
+static double
+bench_build_single(list_t lst, void **data, int nops)
+{
+  double start;
+  int i;
+
+  start = bench_now();
+  for (i = 0; i < nops; i++)
+    list_append(lst, data[i]);
+  return bench_now() - start;
+}
+
+/**
+ * Build a list with a single batch insertion
+ */
+static double
+bench_build_batch(list_t lst, void **data, int nops)
+{
+  double start;
+
+  start = bench_now();
+  list_append_n(lst, data, nops);
+  return bench_now() - start;
+}
+
+int
+main(int argc, char *argv[])
+{
+  void **data;
+  list_t lst;
+  double start, elapsed;
+  int i;
+  int nops = bench_nops(argc, argv);
+
+  data = malloc(nops * sizeof(void *));
+  for (i = 0; i < nops; i++)
+    data[i] = &data[i];
+
+  /* the list teardown is part of the cost of the node allocation */
+  list_init(&lst, NULL, NULL);
+  elapsed = bench_build_single(lst, data, nops);
+  start = bench_now();
+  list_destroy(lst);
+  bench_report("build/destroy list_append", nops,
+	       elapsed + bench_now() - start);
+
+  list_init(&lst, NULL, NULL);
+  elapsed = bench_build_batch(lst, data, nops);
+  start = bench_now();
+  list_destroy(lst);
+  bench_report("build/destroy list_append_n", nops,
+	       elapsed + bench_now() - start);
+
+  list_init_pool(&lst, NULL, NULL, NULL);
+  elapsed = bench_build_batch(lst, data, nops);
+  start = bench_now();
+  list_destroy(lst);
+  bench_report("build/destroy pool list_append_n", nops,
+	       elapsed + bench_now() - start);
+
+  list_init_mode(&lst, NULL, NULL, LIST_MODE_INDEXED);
+  bench_report("build indexed list_append", nops,
+	       bench_build_single(lst, data, nops));
+  list_destroy(lst);
+
+  list_init_mode(&lst, NULL, NULL, LIST_MODE_INDEXED);
+  bench_report("build indexed list_append_n", nops,
+	       bench_build_batch(lst, data, nops));
+  list_destroy(lst);
+
+  free(data);
+  return 0;
+}
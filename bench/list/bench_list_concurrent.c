@@ -0,0 +1,107 @@
+
+#include "bench.h"
+
+#include <pthread.h>
+
+#include "libutils/error.h"
+#include "libutils/list.h"
+
+/* maximum number of threads */
+#define MAX_THREADS 16
+/* size of the record built by the item constructor */
+#define RECORD_SIZE 64
+/* work items queued before the benchmark starts */
+#define BACKLOG 1024
+
+struct worker_args {
+  list_t lst;
+  pthread_mutex_t *lock;
+  long nops;
+};
+
+static int
+record_ctor(void **itm_data, void *data)
+{
+  *itm_data = malloc(RECORD_SIZE);
+  if (*itm_data == NULL)
+    return UTILS_ERROR;
+  memset(*itm_data, 0, RECORD_SIZE);
+  return UTILS_OK;
+}
+
+static int
+record_dtor(void *itm_data)
+{
+  free(itm_data);
+  return UTILS_OK;
+}
+
+/**
+ * Work queue usage: append work items and pop them from the head,
+ * optionally serialized with an external mutex.
+ */
+static void *
+worker(void *data)
+{
+  struct worker_args *args = data;
+  void *itm_data;
+  long i;
+
+  for (i = 0; i < args->nops; i++) {
+    if (args->lock != NULL)
+      pthread_mutex_lock(args->lock);
+    list_append(args->lst, NULL);
+    itm_data = list_pop(args->lst);
+    record_dtor(itm_data);
+    if (args->lock != NULL)
+      pthread_mutex_unlock(args->lock);
+  }
+  return NULL;
+}
+
+static double
+bench_threads(list_t lst, pthread_mutex_t *lock, int nthreads, long nops)
+{
+  pthread_t threads[MAX_THREADS];
+  struct worker_args args[MAX_THREADS];
+  double start;
+  int i;
+
+  /* keep the queue from running empty, so that producers and
+   * consumers work at different ends of the list */
+  for (i = 0; i < BACKLOG; i++)
+    list_append(lst, NULL);
+  start = bench_now();
+  for (i = 0; i < nthreads; i++) {
+    args[i].lst = lst;
+    args[i].lock = lock;
+    args[i].nops = nops / nthreads;
+    pthread_create(&threads[i], NULL, worker, &args[i]);
+  }
+  for (i = 0; i < nthreads; i++)
+    pthread_join(threads[i], NULL);
+  return bench_now() - start;
+}
+
+int
+main(int argc, char *argv[])
+{
+  pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+  char label[64];
+  list_t lst;
+  int nthreads;
+  long nops = bench_nops(argc, argv);
+
+  for (nthreads = 1; nthreads <= MAX_THREADS; nthreads *= 2) {
+    list_init(&lst, record_ctor, record_dtor);
+    snprintf(label, sizeof(label), "global mutex %2d threads", nthreads);
+    bench_report(label, 2 * nops, bench_threads(lst, &lock, nthreads, nops));
+    list_destroy(lst);
+
+    list_init_mode(&lst, record_ctor, record_dtor, LIST_MODE_CONCURRENT);
+    snprintf(label, sizeof(label), "concurrent %2d threads", nthreads);
+    bench_report(label, 2 * nops, bench_threads(lst, NULL, nthreads, nops));
+    list_destroy(lst);
+  }
+  return 0;
+}
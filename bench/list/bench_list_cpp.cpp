@@ -0,0 +1,102 @@
+#include "bench.h"
+
+#include <list>
+
+#include "libutils/list.hpp"
+
+/* number of walks over the list */
+#define NWALKS 10
+
+/* keeps the walks from being optimized out */
+static volatile double sink;
+
+struct point {
+  double x;
+  double y;
+};
+
+static int
+point_dtor(void *data)
+{
+  delete static_cast<point *>(data);
+  return UTILS_OK;
+}
+
+static int
+sum_cbk(void *itm_data, void *args)
+{
+  point *p = static_cast<point *>(itm_data);
+
+  *static_cast<double *>(args) += p->x + p->y;
+  return UTILS_OK;
+}
+
+/**
+ * C list of points boxed with new, as wrapped by hand
+ */
+static void
+bench_boxed(int nops)
+{
+  double start, sum = 0;
+  list_t lst;
+  int i;
+
+  start = bench_now();
+  list_init(&lst, NULL, point_dtor);
+  for (i = 0; i < nops; i++)
+    list_append(lst, new point{(double)i, (double)-i});
+  bench_report("boxed C list append", nops, bench_now() - start);
+
+  start = bench_now();
+  for (i = 0; i < NWALKS; i++)
+    list_walk(lst, sum_cbk, &sum);
+  bench_report("boxed C list walk", NWALKS * nops, bench_now() - start);
+  sink = sum;
+
+  start = bench_now();
+  list_destroy(lst);
+  bench_report("boxed C list destroy", nops, bench_now() - start);
+}
+
+/**
+ * Build, iterate and destroy a C++ list of points
+ */
+template <typename List>
+static void
+bench_cpp(const char *name, int nops)
+{
+  char label[64];
+  double start, sum = 0;
+  int i;
+
+  start = bench_now();
+  List *lst = new List();
+  for (i = 0; i < nops; i++)
+    lst->push_back(point{(double)i, (double)-i});
+  snprintf(label, sizeof(label), "%s push_back", name);
+  bench_report(label, nops, bench_now() - start);
+
+  start = bench_now();
+  for (i = 0; i < NWALKS; i++)
+    for (const point &p : *lst)
+      sum += p.x + p.y;
+  snprintf(label, sizeof(label), "%s range-for", name);
+  bench_report(label, NWALKS * nops, bench_now() - start);
+  sink = sum;
+
+  start = bench_now();
+  delete lst;
+  snprintf(label, sizeof(label), "%s destroy", name);
+  bench_report(label, nops, bench_now() - start);
+}
+
+int
+main(int argc, char *argv[])
+{
+  int nops = bench_nops(argc, argv);
+
+  bench_boxed(nops);
+  bench_cpp<std::list<point>>("std::list", nops);
+  bench_cpp<libutils::list<point>>("libutils::list", nops);
+  return 0;
+}
@@ -0,0 +1,48 @@
+#include "bench.h"
+
+#include "libutils/error.h"
+#include "libutils/list.h"
+
+/* stride of the sparse loop */
+#define STRIDE 3
+
+int
+main(int argc, char *argv[])
+{
+  list_t lst;
+  double start;
+  long sum = 0;
+  int i, nitems;
+  int nops = bench_nops(argc, argv);
+
+  /* indexed loops used to be quadratic, keep the list short */
+  nitems = nops / 20;
+  list_init(&lst, NULL, NULL);
+  for (i = 0; i < nitems; i++)
+    list_append(lst, &sum);
+
+  start = bench_now();
+  for (i = 0; i < nitems; i++)
+    sum += list_get(lst, i) != NULL;
+  bench_report("forward list_get loop", nitems, bench_now() - start);
+
+  start = bench_now();
+  for (i = nitems - 1; i >= 0; i--)
+    sum += list_get(lst, i) != NULL;
+  bench_report("backward list_get loop", nitems, bench_now() - start);
+
+  start = bench_now();
+  for (i = 0; i < nitems; i += STRIDE)
+    sum += list_get(lst, i) != NULL;
+  bench_report("strided list_get loop", nitems / STRIDE, bench_now() - start);
+
+  start = bench_now();
+  for (i = 0; i < nitems / 2; i++)
+    sum += list_remove(lst, i) != NULL;
+  bench_report("forward list_remove loop", nitems / 2, bench_now() - start);
+
+  list_destroy(lst);
+  if (sum == 0)
+    printf("unexpected checksum\n");
+  return 0;
+}
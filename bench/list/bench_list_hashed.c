@@ -0,0 +1,58 @@
+#include "bench.h"
+
+#include "libutils/error.h"
+#include "libutils/list.h"
+
+/**
+ * Look up random list members by data pointer
+ */
+static double
+bench_lookup(list_t lst, long *values, int nitems, int nops)
+{
+  double start;
+  long sum = 0;
+  int i;
+
+  srand(1);
+  start = bench_now();
+  for (i = 0; i < nops; i++)
+    sum += list_find_item(lst, &values[rand() % nitems]) != NULL;
+  if (sum != nops)
+    printf("unexpected lookup failure\n");
+  return bench_now() - start;
+}
+
+static void
+bench_mode(const char *name, int mode, long *values, int nitems, int nops)
+{
+  char label[64];
+  list_t lst;
+  size_t bytes;
+  int i;
+
+  list_init_mode(&lst, NULL, NULL, mode);
+  for (i = 0; i < nitems; i++)
+    list_append(lst, &values[i]);
+  list_index_memory(lst, &bytes);
+  snprintf(label, sizeof(label), "%s lookup", name);
+  bench_report(label, nops, bench_lookup(lst, values, nitems, nops));
+  printf("%-30s %10zu bytes\n", "  index memory", bytes);
+  list_destroy(lst);
+}
+
+int
+main(int argc, char *argv[])
+{
+  long *values;
+  int nitems;
+  int nops = bench_nops(argc, argv);
+
+  /* the plain list scan is quadratic, keep it short */
+  nitems = nops / 20;
+  values = malloc(nitems * sizeof(long));
+
+  bench_mode("plain", 0, values, nitems, nops / 100);
+  bench_mode("hashed", LIST_MODE_HASHED, values, nitems, nops);
+  free(values);
+  return 0;
+}
@@ -0,0 +1,68 @@
+
+#include "bench.h"
+
+#include "libutils/error.h"
+#include "libutils/list.h"
+
+/**
+ * Indexed loop over the whole list with list_get
+ */
+static double
+bench_get_loop(list_t lst)
+{
+  double start;
+  int i, len;
+
+  len = list_length(lst);
+  start = bench_now();
+  for (i = 0; i < len; i++)
+    list_get(lst, i);
+  return bench_now() - start;
+}
+
+/**
+ * Insert and remove in the middle of the list
+ */
+static double
+bench_insert_remove(list_t lst, int nops)
+{
+  double start;
+  int i, pos;
+
+  start = bench_now();
+  for (i = 0; i < nops; i++) {
+    pos = rand() % list_length(lst);
+    list_insert(lst, &i, pos);
+    list_remove(lst, pos);
+  }
+  return bench_now() - start;
+}
+
+static void
+bench_mode(const char *name, int mode, int nitems)
+{
+  char label[64];
+  list_t lst;
+  int i;
+
+  list_init_mode(&lst, NULL, NULL, mode);
+  for (i = 0; i < nitems; i++)
+    list_append(lst, &i);
+
+  snprintf(label, sizeof(label), "get loop %s", name);
+  bench_report(label, nitems, bench_get_loop(lst));
+  snprintf(label, sizeof(label), "mid insert/remove %s", name);
+  bench_report(label, 2000, bench_insert_remove(lst, 1000));
+  list_destroy(lst);
+}
+
+int
+main(int argc, char *argv[])
+{
+  int nitems = bench_nops(argc, argv) / 20;
+
+  srand(1);
+  bench_mode("plain", 0, nitems);
+  bench_mode("indexed", LIST_MODE_INDEXED, nitems);
+  return 0;
+}
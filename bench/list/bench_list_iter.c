@@ -0,0 +1,76 @@
+
+#include "bench.h"
+
+#include "libutils/error.h"
+#include "libutils/list.h"
+
+static void
+fill(list_t lst, int nitems)
+{
+  long i;
+
+  for (i = 0; i < nitems; i++)
+    list_append(lst, (void *)i);
+}
+
+int
+main(int argc, char *argv[])
+{
+  list_iter_struct_t iter;
+  list_item_t *victims;
+  list_t lst;
+  double start;
+  int i, count;
+  int nops = bench_nops(argc, argv);
+
+  /* collect the odd items in a first pass and remove them in a second */
+  victims = malloc(nops / 2 * sizeof(list_item_t));
+  list_init(&lst, NULL, NULL);
+  fill(lst, nops);
+  start = bench_now();
+  count = 0;
+  for (list_iter_init(lst, &iter); !list_iter_end(&iter);
+       list_iter_next(&iter))
+    if ((long)list_iter_data(&iter) % 2)
+      victims[count++] = list_iter_item(&iter);
+  for (i = 0; i < count; i++)
+    list_item_remove(lst, victims[i]);
+  bench_report("two pass filter", nops, bench_now() - start);
+  list_destroy(lst);
+  free(victims);
+
+  list_init(&lst, NULL, NULL);
+  fill(lst, nops);
+  start = bench_now();
+  for (list_iter_init(lst, &iter); !list_iter_end(&iter);
+       list_iter_next(&iter))
+    if ((long)list_iter_data(&iter) % 2)
+      list_iter_remove(&iter);
+  bench_report("list_iter_remove filter", nops, bench_now() - start);
+  list_destroy(lst);
+
+  list_init_mode(&lst, NULL, NULL, LIST_MODE_UNROLLED);
+  fill(lst, nops);
+  start = bench_now();
+  for (list_iter_init(lst, &iter); !list_iter_end(&iter);
+       list_iter_next(&iter))
+    if ((long)list_iter_data(&iter) % 2)
+      list_iter_remove(&iter);
+  bench_report("unrolled list_iter_remove filter", nops, bench_now() - start);
+  list_destroy(lst);
+
+  list_init(&lst, NULL, NULL);
+  fill(lst, nops);
+  list_iter_init(lst, &iter);
+  start = bench_now();
+  for (i = nops - 1; i >= 0; i -= 97) {
+    list_iter_seek(&iter, i);
+    count += list_iter_data(&iter) != NULL;
+  }
+  bench_report("list_iter_seek near tail", nops / 97, bench_now() - start);
+  list_destroy(lst);
+
+  if (count == 0)
+    printf("unexpected checksum\n");
+  return 0;
+}
@@ -0,0 +1,101 @@
+
+#include "bench.h"
+
+#include "libutils/error.h"
+#include "libutils/list.h"
+
+static bool
+is_even(void *itm_data, void *args)
+{
+  return (long)itm_data % 2 == 0;
+}
+
+static void *
+square(void *itm_data, void *args)
+{
+  return (void *)((long)itm_data * (long)itm_data);
+}
+
+static int
+sum(void *itm_data, void *acc)
+{
+  *(long *)acc += (long)itm_data;
+  return UTILS_OK;
+}
+
+/* walk callbacks of the multi pass version */
+static int
+filter_cbk(void *itm_data, void *args)
+{
+  if (is_even(itm_data, NULL))
+    return list_append(args, itm_data);
+  return UTILS_OK;
+}
+
+static int
+map_cbk(void *itm_data, void *args)
+{
+  return list_append(args, square(itm_data, NULL));
+}
+
+static int
+sum_cbk(void *itm_data, void *args)
+{
+  return sum(args, itm_data);
+}
+
+static void
+fill(list_t lst, int nitems)
+{
+  long i;
+
+  for (i = 0; i < nitems; i++)
+    list_append(lst, (void *)((i * 7919) % nitems));
+}
+
+int
+main(int argc, char *argv[])
+{
+  list_t lst, evens, squares;
+  double start;
+  long total = 0, check = 0;
+  int nops = bench_nops(argc, argv);
+  list_stage_t stages[] = {
+    LIST_FILTER(is_even, NULL),
+    LIST_MAP(square, NULL),
+    LIST_REDUCE(sum, &check),
+  };
+
+  list_init(&lst, NULL, NULL);
+  fill(lst, nops);
+
+  /* sum of the squares of the even items */
+  start = bench_now();
+  list_init(&evens, NULL, NULL);
+  list_init(&squares, NULL, NULL);
+  list_walk(lst, filter_cbk, evens);
+  list_walk(evens, map_cbk, squares);
+  list_walk(squares, sum_cbk, &total);
+  list_destroy(evens);
+  list_destroy(squares);
+  bench_report("three list_walk passes", nops, bench_now() - start);
+
+  start = bench_now();
+  list_pipeline(lst, stages, 3, NULL);
+  bench_report("list_pipeline", nops, bench_now() - start);
+  if (check != total)
+    printf("unexpected checksum\n");
+
+  start = bench_now();
+  list_filter(lst, is_even, NULL);
+  bench_report("list_filter", nops, bench_now() - start);
+  list_destroy(lst);
+
+  list_init_mode(&lst, NULL, NULL, LIST_MODE_UNROLLED);
+  fill(lst, nops);
+  start = bench_now();
+  list_filter(lst, is_even, NULL);
+  bench_report("unrolled list_filter", nops, bench_now() - start);
+  list_destroy(lst);
+  return 0;
+}
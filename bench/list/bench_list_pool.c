@@ -0,0 +1,68 @@
+
+#include "bench.h"
+
+#include "libutils/error.h"
+#include "libutils/list.h"
+
+/* number of items kept in the queue while cycling push/pop */
+#define QUEUE_DEPTH 64
+
+/**
+ * Fill the list and then drain it
+ */
+static double
+bench_fill_drain(list_t lst, int nops)
+{
+  double start;
+  int i;
+
+  start = bench_now();
+  for (i = 0; i < nops; i++)
+    list_push(lst, &i);
+  for (i = 0; i < nops; i++)
+    list_pop(lst);
+  return bench_now() - start;
+}
+
+/**
+ * Short-lived entries: keep the queue shallow and cycle push/pop
+ */
+static double
+bench_cycle(list_t lst, int nops)
+{
+  double start;
+  int i;
+
+  for (i = 0; i < QUEUE_DEPTH; i++)
+    list_push(lst, &i);
+  start = bench_now();
+  for (i = 0; i < nops; i++) {
+    list_push(lst, &i);
+    list_pop(lst);
+  }
+  return bench_now() - start;
+}
+
+int
+main(int argc, char *argv[])
+{
+  list_t lst;
+  int nops = bench_nops(argc, argv);
+
+  list_init(&lst, NULL, NULL);
+  bench_report("fill/drain malloc", 2L * nops, bench_fill_drain(lst, nops));
+  list_destroy(lst);
+
+  list_init_pool(&lst, NULL, NULL, NULL);
+  bench_report("fill/drain pool", 2L * nops, bench_fill_drain(lst, nops));
+  list_destroy(lst);
+
+  list_init(&lst, NULL, NULL);
+  bench_report("push/pop cycle malloc", 2L * nops, bench_cycle(lst, nops));
+  list_destroy(lst);
+
+  list_init_pool(&lst, NULL, NULL, NULL);
+  bench_report("push/pop cycle pool", 2L * nops, bench_cycle(lst, nops));
+  list_destroy(lst);
+  return 0;
+}
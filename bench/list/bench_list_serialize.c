@@ -0,0 +1,107 @@
+#include "bench.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "libutils/error.h"
+#include "libutils/list.h"
+
+struct point {
+  long id;
+  double x;
+  double y;
+};
+
+static int
+encode_point(void *itm_data, void *record, void *args)
+{
+  memcpy(record, itm_data, sizeof(struct point));
+  return UTILS_OK;
+}
+
+static int
+decode_point(const void *record, void **data, void *args)
+{
+  *data = malloc(sizeof(struct point));
+  if (*data == NULL)
+    return UTILS_ERROR;
+  memcpy(*data, record, sizeof(struct point));
+  return UTILS_OK;
+}
+
+static int
+free_point(void *data)
+{
+  free(data);
+  return UTILS_OK;
+}
+
+static int
+sum_id(void *itm_data, void *args)
+{
+  *(long *)args += ((struct point *)itm_data)->id;
+  return UTILS_OK;
+}
+
+int
+main(int argc, char *argv[])
+{
+  char path[] = "/tmp/bench_list_serialize_XXXXXX";
+  struct point *p, rec;
+  list_t lst;
+  FILE *stream;
+  double start;
+  long i, total = 0;
+  int fd, nops = bench_nops(argc, argv);
+
+  list_init(&lst, NULL, free_point);
+  for (i = 0; i < nops; i++) {
+    p = malloc(sizeof(struct point));
+    p->id = i;
+    p->x = i;
+    p->y = -i;
+    list_append(lst, p);
+  }
+  fd = mkstemp(path);
+  stream = fdopen(fd, "w+b");
+  start = bench_now();
+  list_serialize(lst, stream, sizeof(struct point), encode_point, NULL);
+  fflush(stream);
+  bench_report("list_serialize", nops, bench_now() - start);
+  list_destroy(lst);
+
+  /* load the records one at a time */
+  start = bench_now();
+  rewind(stream);
+  fseek(stream, 32, SEEK_SET);
+  list_init(&lst, NULL, free_point);
+  while (fread(&rec, sizeof(rec), 1, stream) == 1) {
+    p = malloc(sizeof(struct point));
+    *p = rec;
+    list_append(lst, p);
+  }
+  list_walk(lst, sum_id, &total);
+  bench_report("fread and list_append, walk", nops, bench_now() - start);
+  list_destroy(lst);
+
+  start = bench_now();
+  rewind(stream);
+  list_init(&lst, NULL, free_point);
+  list_deserialize(lst, stream, decode_point, NULL);
+  list_walk(lst, sum_id, &total);
+  bench_report("list_deserialize, walk", nops, bench_now() - start);
+  list_destroy(lst);
+
+  start = bench_now();
+  list_init_mapped(&lst, path);
+  list_walk(lst, sum_id, &total);
+  bench_report("list_init_mapped, walk", nops, bench_now() - start);
+  list_destroy(lst);
+
+  if (total != 3 * ((long)nops * (nops - 1) / 2))
+    printf("unexpected checksum\n");
+  fclose(stream);
+  unlink(path);
+  return 0;
+}
@@ -0,0 +1,130 @@
+#include "bench.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+
+#include "libutils/error.h"
+#include "libutils/list.h"
+
+/* maximum number of reader threads */
+#define MAX_THREADS 16
+/* number of items of the read list */
+#define NITEMS 64
+/* pause of the writer between two updates, in microseconds */
+#define WRITER_PAUSE 100
+
+struct bench_args {
+  list_t lst;
+  int mode;
+  long nops;
+  atomic_bool done;
+};
+
+static int
+sum_cbk(void *itm_data, void *args)
+{
+  *(long *)args += (long)itm_data;
+  return UTILS_OK;
+}
+
+/**
+ * Read the whole list through the internal lock
+ */
+static void *
+locked_reader(void *data)
+{
+  struct bench_args *args = data;
+  long i, sum = 0;
+
+  for (i = 0; i < args->nops; i++)
+    list_walk(args->lst, sum_cbk, &sum);
+  return (void *)sum;
+}
+
+/**
+ * Read the whole list from the current version
+ */
+static void *
+snapshot_reader(void *data)
+{
+  struct bench_args *args = data;
+  list_iter_struct_t iter;
+  list_t snap;
+  long i, sum = 0;
+
+  for (i = 0; i < args->nops; i++) {
+    snap = list_snapshot(args->lst);
+    for (list_iter_init(snap, &iter); !list_iter_end(&iter);
+	 list_iter_next(&iter))
+      sum += (long)list_iter_data(&iter);
+    list_snapshot_release(snap);
+  }
+  return (void *)sum;
+}
+
+/**
+ * Rotate the list until the readers are done, publishing
+ * each change of a snapshot list
+ */
+static void *
+writer(void *data)
+{
+  struct bench_args *args = data;
+  struct timespec pause = {0, WRITER_PAUSE * 1000};
+
+  while (!atomic_load(&args->done)) {
+    list_append(args->lst, list_pop(args->lst));
+    if (args->mode & LIST_MODE_SNAPSHOT)
+      list_publish(args->lst);
+    nanosleep(&pause, NULL);
+  }
+  return NULL;
+}
+
+static double
+bench_readers(int mode, void *(*reader)(void *), int nthreads, long nops)
+{
+  pthread_t threads[MAX_THREADS], wthread;
+  struct bench_args args;
+  double start;
+  long i;
+
+  list_init_mode(&args.lst, NULL, NULL, mode);
+  for (i = 0; i < NITEMS; i++)
+    list_append(args.lst, (void *)i);
+  if (mode & LIST_MODE_SNAPSHOT)
+    list_publish(args.lst);
+  args.mode = mode;
+  args.nops = nops / nthreads;
+  atomic_init(&args.done, false);
+
+  pthread_create(&wthread, NULL, writer, &args);
+  start = bench_now();
+  for (i = 0; i < nthreads; i++)
+    pthread_create(&threads[i], NULL, reader, &args);
+  for (i = 0; i < nthreads; i++)
+    pthread_join(threads[i], NULL);
+  start = bench_now() - start;
+  atomic_store(&args.done, true);
+  pthread_join(wthread, NULL);
+  list_destroy(args.lst);
+  return start;
+}
+
+int
+main(int argc, char *argv[])
+{
+  char label[64];
+  int nthreads;
+  long nops = bench_nops(argc, argv);
+
+  for (nthreads = 1; nthreads <= MAX_THREADS; nthreads *= 2) {
+    snprintf(label, sizeof(label), "concurrent walk %2d readers", nthreads);
+    bench_report(label, nops, bench_readers(LIST_MODE_CONCURRENT,
+					    locked_reader, nthreads, nops));
+    snprintf(label, sizeof(label), "snapshot iter %2d readers", nthreads);
+    bench_report(label, nops, bench_readers(LIST_MODE_SNAPSHOT,
+					    snapshot_reader, nthreads, nops));
+  }
+  return 0;
+}
@@ -0,0 +1,89 @@
+#include "bench.h"
+
+#include "libutils/error.h"
+#include "libutils/list.h"
+
+static int
+long_cmp(void *a, void *b)
+{
+  return (*(long *)a > *(long *)b) - (*(long *)a < *(long *)b);
+}
+
+static int
+qsort_cmp(const void *a, const void *b)
+{
+  return long_cmp(*(void **)a, *(void **)b);
+}
+
+/**
+ * Sort by copying the data in an array and rebuilding the list
+ */
+static double
+bench_qsort_rebuild(list_t *lst, int nops)
+{
+  list_iter_struct_t iter;
+  void **data;
+  double start;
+  int i;
+
+  start = bench_now();
+  data = malloc(nops * sizeof(void *));
+  i = 0;
+  for (list_iter_init(*lst, &iter); !list_iter_end(&iter);
+       list_iter_next(&iter))
+    data[i++] = list_iter_data(&iter);
+  qsort(data, nops, sizeof(void *), qsort_cmp);
+  list_destroy(*lst);
+  list_init(lst, NULL, NULL);
+  for (i = 0; i < nops; i++)
+    list_append(*lst, data[i]);
+  free(data);
+  return bench_now() - start;
+}
+
+static double
+bench_sort(list_t *lst, int nops)
+{
+  double start;
+
+  start = bench_now();
+  list_sort(*lst, long_cmp);
+  return bench_now() - start;
+}
+
+static list_t
+build_list(long *keys, int nops)
+{
+  list_t lst;
+  int i;
+
+  list_init(&lst, NULL, NULL);
+  for (i = 0; i < nops; i++)
+    list_append(lst, &keys[i]);
+  return lst;
+}
+
+int
+main(int argc, char *argv[])
+{
+  long *keys;
+  list_t lst;
+  int i;
+  int nops = bench_nops(argc, argv);
+
+  keys = malloc(nops * sizeof(long));
+  srand(1);
+  for (i = 0; i < nops; i++)
+    keys[i] = rand();
+
+  lst = build_list(keys, nops);
+  bench_report("qsort and rebuild", nops, bench_qsort_rebuild(&lst, nops));
+  list_destroy(lst);
+
+  lst = build_list(keys, nops);
+  bench_report("list_sort", nops, bench_sort(&lst, nops));
+  list_destroy(lst);
+
+  free(keys);
+  return 0;
+}
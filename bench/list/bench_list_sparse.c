@@ -0,0 +1,37 @@
+
+#include "bench.h"
+
+#include "libutils/error.h"
+#include "libutils/list.h"
+
+/* number of far insertions */
+#define NINSERT 16
+
+static double
+bench_far(int mode, int nops)
+{
+  list_t lst;
+  double start;
+  int i;
+
+  list_init_mode(&lst, NULL, NULL, mode);
+  start = bench_now();
+  for (i = 1; i <= NINSERT; i++)
+    list_insert(lst, &lst, i * (nops / NINSERT));
+  for (i = 0; i < NINSERT; i++)
+    list_get(lst, (nops / NINSERT) * i + i);
+  start = bench_now() - start;
+  list_destroy(lst);
+  return start;
+}
+
+int
+main(int argc, char *argv[])
+{
+  int nops = bench_nops(argc, argv);
+
+  bench_report("far insert", NINSERT, bench_far(0, nops));
+  bench_report("sparse far insert", NINSERT,
+	       bench_far(LIST_MODE_SPARSE, nops));
+  return 0;
+}
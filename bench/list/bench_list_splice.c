@@ -0,0 +1,46 @@
+#include "bench.h"
+
+#include "libutils/error.h"
+#include "libutils/list.h"
+
+static void
+build(list_t *dst, list_t *src, int nops)
+{
+  int i;
+
+  list_init(dst, NULL, NULL);
+  list_init(src, NULL, NULL);
+  for (i = 0; i < nops / 2; i++) {
+    list_append(*dst, dst);
+    list_append(*src, src);
+  }
+}
+
+int
+main(int argc, char *argv[])
+{
+  list_t dst, src;
+  double start;
+  int i;
+  int nops = bench_nops(argc, argv);
+
+  /* move the elements one at a time */
+  build(&dst, &src, nops);
+  start = bench_now();
+  for (i = 0; i < nops / 2; i++)
+    list_append(dst, list_pop(src));
+  bench_report("pop/append merge", nops / 2, bench_now() - start);
+  list_destroy(dst);
+  list_destroy(src);
+
+  build(&dst, &src, nops);
+  start = bench_now();
+  list_concat(dst, src);
+  bench_report("list_concat merge", nops / 2, bench_now() - start);
+  start = bench_now();
+  list_split(dst, nops / 2, &src);
+  bench_report("list_split", nops / 2, bench_now() - start);
+  list_destroy(dst);
+  list_destroy(src);
+  return 0;
+}
@@ -0,0 +1,97 @@
+#include "bench.h"
+
+#include "libutils/error.h"
+#include "libutils/list.h"
+#include "libutils/list_typed.h"
+
+/* number of list items, the list stays in cache so that the walks
+ * measure the per item overhead rather than the memory latency
+ */
+#define NITEMS 4096
+
+LIST_DECLARE(longs, long)
+
+/* keeps the walks from being optimized out */
+static volatile long sink;
+
+static int
+sum_cbk(void *itm_data, void *args)
+{
+  *(long *)args += (long)itm_data;
+  return UTILS_OK;
+}
+
+static int
+value_sum_cbk(void *itm_data, void *args)
+{
+  *(long *)args += *(long *)itm_data;
+  return UTILS_OK;
+}
+
+static void
+bench_generic(int nops)
+{
+  list_iter_struct_t iter;
+  double start;
+  list_t lst;
+  long i, sum = 0;
+
+  list_init(&lst, NULL, NULL);
+  for (i = 0; i < NITEMS; i++)
+    list_append(lst, (void *)i);
+
+  start = bench_now();
+  for (i = 0; i < nops / NITEMS; i++)
+    list_walk(lst, sum_cbk, &sum);
+  bench_report("void * list walk", nops, bench_now() - start);
+
+  start = bench_now();
+  for (i = 0; i < nops / NITEMS; i++)
+    for (list_iter_init(lst, &iter); !list_iter_end(&iter);
+	 list_iter_next(&iter))
+      sum += (long)list_iter_data(&iter);
+  bench_report("void * list iter", nops, bench_now() - start);
+  list_destroy(lst);
+
+  list_init_value(&lst, sizeof(long), 0);
+  for (i = 0; i < NITEMS; i++)
+    list_append(lst, &i);
+  start = bench_now();
+  for (i = 0; i < nops / NITEMS; i++)
+    list_walk(lst, value_sum_cbk, &sum);
+  bench_report("value list walk", nops, bench_now() - start);
+  list_destroy(lst);
+  sink = sum;
+}
+
+static void
+bench_typed(int nops)
+{
+  longs_iter_struct_t iter;
+  double start;
+  longs_t lst;
+  long i, sum = 0;
+
+  longs_init(&lst);
+  for (i = 0; i < NITEMS; i++)
+    longs_append(lst, i);
+
+  start = bench_now();
+  for (i = 0; i < nops / NITEMS; i++)
+    for (longs_iter_init(lst, &iter); !longs_iter_end(&iter);
+	 longs_iter_next(&iter))
+      sum += *longs_iter_data(&iter);
+  bench_report("typed list iter", nops, bench_now() - start);
+  longs_destroy(lst);
+  sink = sum;
+}
+
+int
+main(int argc, char *argv[])
+{
+  int nops = bench_nops(argc, argv);
+
+  bench_generic(nops);
+  bench_typed(nops);
+  return 0;
+}
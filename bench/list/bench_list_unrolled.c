@@ -0,0 +1,61 @@
+
+#include "bench.h"
+
+#include "libutils/error.h"
+#include "libutils/list.h"
+
+/* number of passes over the list */
+#define NPASSES 10
+
+static int
+sum_cbk(void *itm_data, void *args)
+{
+  *(long *)args += (long)itm_data;
+  return UTILS_OK;
+}
+
+static void
+bench_mode(const char *name, int mode, int nitems)
+{
+  list_iter_struct_t iter;
+  char label[64];
+  list_t lst;
+  double start;
+  long i, sum;
+
+  list_init_mode(&lst, NULL, NULL, mode);
+  start = bench_now();
+  for (i = 0; i < nitems; i++)
+    list_append(lst, (void *)i);
+  snprintf(label, sizeof(label), "append %s", name);
+  bench_report(label, nitems, bench_now() - start);
+
+  sum = 0;
+  start = bench_now();
+  for (i = 0; i < NPASSES; i++)
+    list_walk(lst, sum_cbk, &sum);
+  snprintf(label, sizeof(label), "walk %s", name);
+  bench_report(label, (long)NPASSES * nitems, bench_now() - start);
+
+  start = bench_now();
+  for (i = 0; i < NPASSES; i++)
+    for (list_iter_init(lst, &iter); !list_iter_end(&iter);
+	 list_iter_next(&iter))
+      sum += (long)list_iter_data(&iter);
+  snprintf(label, sizeof(label), "iter %s", name);
+  bench_report(label, (long)NPASSES * nitems, bench_now() - start);
+
+  list_destroy(lst);
+  if (sum == 0)
+    printf("unexpected checksum\n");
+}
+
+int
+main(int argc, char *argv[])
+{
+  int nitems = bench_nops(argc, argv);
+
+  bench_mode("plain", 0, nitems);
+  bench_mode("unrolled", LIST_MODE_UNROLLED, nitems);
+  return 0;
+}
@@ -0,0 +1,82 @@
+#include "bench.h"
+
+#include "libutils/error.h"
+#include "libutils/list.h"
+
+/* number of walks over the list */
+#define NWALKS 10
+
+struct point {
+  double x;
+  double y;
+};
+
+static int
+sum_cbk(void *itm_data, void *args)
+{
+  struct point *p = itm_data;
+
+  *(double *)args += p->x + p->y;
+  return UTILS_OK;
+}
+
+static int
+point_dtor(void *data)
+{
+  free(data);
+  return UTILS_OK;
+}
+
+/**
+ * Build a list of points, each point allocated apart or stored
+ * in its item, and walk it
+ */
+static void
+bench_points(bool inline_values, int nops)
+{
+  struct point p, *ptr;
+  double start, sum = 0;
+  list_t lst;
+  int i;
+
+  start = bench_now();
+  if (inline_values)
+    list_init_value(&lst, sizeof(struct point), 0);
+  else
+    list_init(&lst, NULL, point_dtor);
+  for (i = 0; i < nops; i++) {
+    p.x = i;
+    p.y = -i;
+    if (inline_values) {
+      list_append(lst, &p);
+    }
+    else {
+      ptr = malloc(sizeof(struct point));
+      *ptr = p;
+      list_append(lst, ptr);
+    }
+  }
+  bench_report(inline_values ? "inline append" : "pointer append", nops,
+	       bench_now() - start);
+
+  start = bench_now();
+  for (i = 0; i < NWALKS; i++)
+    list_walk(lst, sum_cbk, &sum);
+  bench_report(inline_values ? "inline walk" : "pointer walk",
+	       NWALKS * nops, bench_now() - start);
+
+  start = bench_now();
+  list_destroy(lst);
+  bench_report(inline_values ? "inline destroy" : "pointer destroy", nops,
+	       bench_now() - start);
+}
+
+int
+main(int argc, char *argv[])
+{
+  int nops = bench_nops(argc, argv);
+
+  bench_points(false, nops);
+  bench_points(true, nops);
+  return 0;
+}
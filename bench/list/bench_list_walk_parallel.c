@@ -0,0 +1,89 @@
+#include "bench.h"
+
+#include "libutils/error.h"
+#include "libutils/list.h"
+
+/* maximum number of threads */
+#define MAX_THREADS 16
+/* iterations of the per-item work */
+#define WORK_ROUNDS 200
+
+/**
+ * CPU bound callback, the result is stored in the item
+ */
+static int
+work_cbk(void *itm_data, void *args)
+{
+  unsigned long *value = itm_data;
+  unsigned long x = *value;
+  int i;
+
+  for (i = 0; i < WORK_ROUNDS; i++) {
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+  }
+  *value = x;
+  return UTILS_OK;
+}
+
+/**
+ * Empty callback, the walk time is the cost of the thread start-up
+ * and of the range split
+ */
+static int
+nop_cbk(void *itm_data, void *args)
+{
+  return UTILS_OK;
+}
+
+int
+main(int argc, char *argv[])
+{
+  unsigned long *values;
+  char label[64];
+  list_t lst, indexed;
+  double start;
+  int i, nthreads;
+  int nops = bench_nops(argc, argv);
+
+  values = malloc(nops * sizeof(unsigned long));
+  list_init(&lst, NULL, NULL);
+  list_init_mode(&indexed, NULL, NULL, LIST_MODE_INDEXED);
+  for (i = 0; i < nops; i++) {
+    values[i] = i + 1;
+    list_append(lst, &values[i]);
+    list_append(indexed, &values[i]);
+  }
+
+  start = bench_now();
+  list_walk(lst, work_cbk, NULL);
+  bench_report("list_walk", nops, bench_now() - start);
+
+  for (nthreads = 1; nthreads <= MAX_THREADS; nthreads *= 2) {
+    snprintf(label, sizeof(label), "list_walk_parallel %2d threads",
+	     nthreads);
+    start = bench_now();
+    list_walk_parallel(lst, work_cbk, NULL, nthreads);
+    bench_report(label, nops, bench_now() - start);
+  }
+
+  /* the ranges of a plain list are found by a serial walk, those
+   * of an indexed list by rank lookups */
+  for (nthreads = 1; nthreads <= MAX_THREADS; nthreads *= 2) {
+    snprintf(label, sizeof(label), "no work plain %2d threads", nthreads);
+    start = bench_now();
+    list_walk_parallel(lst, nop_cbk, NULL, nthreads);
+    bench_report(label, nops, bench_now() - start);
+    snprintf(label, sizeof(label), "no work indexed %2d threads",
+	     nthreads);
+    start = bench_now();
+    list_walk_parallel(indexed, nop_cbk, NULL, nthreads);
+    bench_report(label, nops, bench_now() - start);
+  }
+
+  list_destroy(indexed);
+  list_destroy(lst);
+  free(values);
+  return 0;
+}
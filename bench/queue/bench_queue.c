@@ -0,0 +1,108 @@
+
+#include "bench.h"
+
+#include <pthread.h>
+
+#include "libutils/error.h"
+#include "libutils/list.h"
+#include "libutils/queue.h"
+
+/* maximum number of threads */
+#define MAX_THREADS 16
+
+struct worker_args {
+  list_t lst;
+  queue_t queue;
+  pthread_mutex_t *lock;
+  long nops;
+};
+
+/**
+ * Work queue usage: each thread pushes a work item and pops one
+ * from the head, the list is optionally serialized with an
+ * external mutex.
+ */
+static void *
+list_worker(void *data)
+{
+  struct worker_args *args = data;
+  long i;
+
+  for (i = 0; i < args->nops; i++) {
+    if (args->lock != NULL)
+      pthread_mutex_lock(args->lock);
+    list_append(args->lst, (void *)(i + 1));
+    list_pop(args->lst);
+    if (args->lock != NULL)
+      pthread_mutex_unlock(args->lock);
+  }
+  return NULL;
+}
+
+static void *
+queue_worker(void *data)
+{
+  struct worker_args *args = data;
+  long i;
+
+  for (i = 0; i < args->nops; i++) {
+    queue_push(args->queue, (void *)(i + 1));
+    queue_pop(args->queue);
+  }
+  return NULL;
+}
+
+static double
+bench_threads(void *(*worker)(void *), struct worker_args *proto,
+	      int nthreads, long nops)
+{
+  pthread_t threads[MAX_THREADS];
+  struct worker_args args[MAX_THREADS];
+  double start;
+  int i;
+
+  start = bench_now();
+  for (i = 0; i < nthreads; i++) {
+    args[i] = *proto;
+    args[i].nops = nops / nthreads;
+    pthread_create(&threads[i], NULL, worker, &args[i]);
+  }
+  for (i = 0; i < nthreads; i++)
+    pthread_join(threads[i], NULL);
+  return bench_now() - start;
+}
+
+int
+main(int argc, char *argv[])
+{
+  pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+  struct worker_args proto;
+  char label[64];
+  int nthreads;
+  long nops = bench_nops(argc, argv);
+
+  for (nthreads = 1; nthreads <= MAX_THREADS; nthreads *= 2) {
+    memset(&proto, 0, sizeof(proto));
+    list_init(&proto.lst, NULL, NULL);
+    proto.lock = &lock;
+    snprintf(label, sizeof(label), "list mutex %2d threads", nthreads);
+    bench_report(label, 2 * nops,
+		 bench_threads(list_worker, &proto, nthreads, nops));
+    list_destroy(proto.lst);
+
+    memset(&proto, 0, sizeof(proto));
+    list_init_mode(&proto.lst, NULL, NULL, LIST_MODE_CONCURRENT);
+    snprintf(label, sizeof(label), "list concurrent %2d threads", nthreads);
+    bench_report(label, 2 * nops,
+		 bench_threads(list_worker, &proto, nthreads, nops));
+    list_destroy(proto.lst);
+
+    memset(&proto, 0, sizeof(proto));
+    queue_init(&proto.queue, NULL);
+    snprintf(label, sizeof(label), "queue lock-free %2d threads", nthreads);
+    bench_report(label, 2 * nops,
+		 bench_threads(queue_worker, &proto, nthreads, nops));
+    queue_destroy(proto.queue);
+  }
+  return 0;
+}
@@ -0,0 +1,54 @@
+
+#include "bench.h"
+
+#include "libutils/error.h"
+#include "libutils/list.h"
+#include "libutils/vec.h"
+
+static int
+sum_cbk(void *itm_data, void *args)
+{
+  *(long *)args += (long)itm_data;
+  return UTILS_OK;
+}
+
+int
+main(int argc, char *argv[])
+{
+  list_t lst;
+  vec_t vec;
+  double start;
+  long i, sum;
+  int nops = bench_nops(argc, argv);
+
+  /* append-then-iterate with the list */
+  sum = 0;
+  list_init(&lst, NULL, NULL);
+  start = bench_now();
+  for (i = 0; i < nops; i++)
+    list_append(lst, (void *)i);
+  bench_report("list append", nops, bench_now() - start);
+  start = bench_now();
+  list_walk(lst, sum_cbk, &sum);
+  bench_report("list walk", nops, bench_now() - start);
+  list_destroy(lst);
+
+  /* append-then-iterate with the vector */
+  vec_init(&vec, NULL, NULL);
+  start = bench_now();
+  for (i = 0; i < nops; i++)
+    vec_append(vec, (void *)i);
+  bench_report("vec append", nops, bench_now() - start);
+  start = bench_now();
+  vec_walk(vec, sum_cbk, &sum);
+  bench_report("vec walk", nops, bench_now() - start);
+  start = bench_now();
+  for (i = 0; i < nops; i++)
+    sum += (long)vec_get(vec, i);
+  bench_report("vec get loop", nops, bench_now() - start);
+  vec_destroy(vec);
+
+  if (sum == 0)
+    printf("unexpected checksum\n");
+  return 0;
+}
@@ -0,0 +1,189 @@
+/**
+ * @file
+ * Ordered map.
+ * The map associates keys to data pointers and keeps the keys sorted
+ * with a user comparison function. It is stored in a B+ tree: wide
+ * nodes hold many sorted keys in contiguous arrays and the leaves are
+ * chained in key order, so lookups touch few cache lines and ordered
+ * and range walks scan the leaves sequentially.
+ * Items are constructed and destructed with the same callbacks used
+ * by the generic list, see list.h.
+ */
+
+#ifndef UTILS_BTREE_H
+#define UTILS_BTREE_H
+
+#include <stdbool.h>
+
+#include "libutils/list.h"
+
+/**
+ * Opaque ordered map handle
+ */
+struct btree_handle;
+typedef struct btree_handle * btree_t;
+
+/**
+ * Opaque ordered map iterator structure
+ */
+struct btree_node;
+struct btree_iterator {
+  struct btree_node *node;
+  int slot;
+  bool end;
+};
+typedef struct btree_iterator btree_iter_struct_t;
+typedef struct btree_iterator * btree_iter_t;
+
+/* ordered map setup API functions */
+
+/**
+ * initialise ordered map handle with key comparison function
+ * and per-item constructor and destructor.
+ * The map stores the key pointer and does not copy the key,
+ * the key must stay valid while it is in the map.
+ * @param[in]: handle pointer to an ordered map handle
+ * @param[in]: cmp key comparison function, negative if the first
+ * key is lower, zero if the keys are equal, positive otherwise
+ * @param[in]: ctor item constructor callback
+ * @param[in]: dtor item destructor callback
+ * @return: utils error code
+ */
+int btree_init(btree_t *handle, list_cmp_t cmp, list_ctor_t ctor,
+	       list_dtor_t dtor);
+
+/**
+ * Deallocate ordered map, the destructor is called for each item.
+ * @param[in]: handle ordered map handle
+ * @return: utils error code
+ */
+int btree_destroy(btree_t handle);
+
+/* ordered map data API functions */
+
+/**
+ * Get the number of items in the map
+ * @param[in] handle: ordered map handle
+ * @return: number of items or negative error value
+ */
+int btree_length(btree_t handle);
+
+/**
+ * Insert an item in the map in O(log n) time, the insertion
+ * fails if the key is already in the map.
+ * @param[in] handle: ordered map handle
+ * @param[in] key: the item key
+ * @param[in] data: the data given to the constructor
+ * @return: utils error code
+ */
+int btree_insert(btree_t handle, const void *key, void *data);
+
+/**
+ * Get the data associated with a key in O(log n) time
+ * @param[in] handle: ordered map handle
+ * @param[in] key: the item key
+ * @return: data pointer or NULL if the key is not in the map
+ */
+void * btree_find(btree_t handle, const void *key);
+
+/**
+ * Check whether a key is in the map
+ * @param[in] handle: ordered map handle
+ * @param[in] key: the item key
+ * @return: bool, true if the key is in the map
+ */
+bool btree_contains(btree_t handle, const void *key);
+
+/**
+ * Remove an item from the map
+ * @param[in] handle: ordered map handle
+ * @param[in] key: the item key
+ * @return: data of the removed item or NULL
+ */
+void * btree_remove(btree_t handle, const void *key);
+
+/**
+ * Remove and deallocate an item from the map
+ * @param[in] handle: ordered map handle
+ * @param[in] key: the item key
+ * @return: utils error code, error if the key is not in the map
+ */
+int btree_delete(btree_t handle, const void *key);
+
+/**
+ * Walk the map in increasing key order executing given callback,
+ * if the callback returns UTILS_ITER_STOP the iteration stops and
+ * no error is returned, if the callback returns an error code the
+ * iteration stops and the error is propagated.
+ * The callback must not modify the map.
+ * @param[in] handle: ordered map handle to iterate
+ * @param[in] cbk: callback to be run for each item
+ * @param[in,out] args: extra arguments given to the callback
+ * @return: utils error code
+ */
+int btree_walk(btree_t handle, list_cbk_t cbk, void *args);
+
+/**
+ * Walk the items with keys in the range [from, to) in increasing key
+ * order, the callback is handled as in btree_walk.
+ * @param[in] handle: ordered map handle to iterate
+ * @param[in] from: the lowest key of the range, NULL for no lower bound
+ * @param[in] to: the key past the range, NULL for no upper bound
+ * @param[in] cbk: callback to be run for each item
+ * @param[in,out] args: extra arguments given to the callback
+ * @return: utils error code
+ */
+int btree_walk_range(btree_t handle, const void *from, const void *to,
+		     list_cbk_t cbk, void *args);
+
+/* ordered map iterator API functions */
+
+/**
+ * Initialize a static iterator struct on the item with the lowest key,
+ * modifying the map invalidates the iterator.
+ * @param[in] handle: the map to iterate
+ * @param[in,out] iter: iterator handle
+ * @return: zero on success, error value on failure
+ */
+int btree_iter_init(btree_t handle, btree_iter_t iter);
+
+/**
+ * Initialize a static iterator struct on the first item with a key
+ * greater than or equal to the given key, the iterator is at the end
+ * if there is no such item.
+ * @param[in] handle: the map to iterate
+ * @param[in] key: the key to look for
+ * @param[in,out] iter: iterator handle
+ * @return: zero on success, error value on failure
+ */
+int btree_lower_bound(btree_t handle, const void *key, btree_iter_t iter);
+
+/**
+ * Advance the iterator to the next key.
+ * @param[in] iter: the iterator handle
+ * @return: zero on success, negative error value
+ */
+int btree_iter_next(btree_iter_t iter);
+
+/**
+ * Check if the iterator has reached the end
+ * @param[in] iter: iterator handle
+ * @return: bool, true if the iterator has finished
+ */
+bool btree_iter_end(btree_iter_t iter);
+
+/**
+ * Get the key of the current item
+ * @param[in] iter: iterator handle
+ * @return: key pointer or NULL
+ */
+const void * btree_iter_key(btree_iter_t iter);
+
+/**
+ * Get the data of the current item
+ * @param[in] iter: iterator handle
+ * @return: data pointer or NULL
+ */
+void * btree_iter_data(btree_iter_t iter);
+
+#endif /* UTILS_BTREE_H */
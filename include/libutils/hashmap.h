@@ -0,0 +1,181 @@
+/**
+ * @file
+ * Open addressing hash map.
+ * The map associates string or pointer keys to data pointers, the
+ * entries are stored in a single array with Robin Hood linear probing.
+ * Items are constructed and destructed with the same callbacks used
+ * by the generic list, see list.h.
+ */
+
+#ifndef UTILS_HASHMAP_H
+#define UTILS_HASHMAP_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "libutils/list.h"
+
+/**
+ * Key types, see hashmap_init
+ *
+ * HASHMAP_KEY_STRING: keys are nul-terminated strings compared by value.
+ *
+ * HASHMAP_KEY_POINTER: keys are compared by address.
+ *
+ * The map stores the key pointer and does not copy the key,
+ * the key must stay valid while it is in the map.
+ */
+#define HASHMAP_KEY_STRING 0
+#define HASHMAP_KEY_POINTER 1
+
+/**
+ * Opaque hash map handle
+ */
+struct hashmap_handle;
+typedef struct hashmap_handle * hashmap_t;
+
+/**
+ * Opaque hash map iterator structure
+ */
+struct hashmap_iterator {
+  struct hashmap_handle *map;
+  size_t slot;
+  bool end;
+};
+typedef struct hashmap_iterator hashmap_iter_struct_t;
+typedef struct hashmap_iterator * hashmap_iter_t;
+
+/* hash map setup API functions */
+
+/**
+ * initialise hash map handle with per-item constructor and
+ * destructor.
+ * @param[in]: handle pointer to a hash map handle
+ * @param[in]: key_type one of the HASHMAP_KEY_* types
+ * @param[in]: ctor item constructor callback
+ * @param[in]: dtor item destructor callback
+ * @return: utils error code
+ */
+int hashmap_init(hashmap_t *handle, int key_type, list_ctor_t ctor,
+		 list_dtor_t dtor);
+
+/**
+ * Deallocate hash map, the destructor is called for each item.
+ * @param[in]: handle hash map handle
+ * @return: utils error code
+ */
+int hashmap_destroy(hashmap_t handle);
+
+/**
+ * Make sure that the map can hold at least the given number of
+ * items without growing.
+ * @param[in] handle: hash map handle
+ * @param[in] count: the number of items to reserve
+ * @return: utils error code
+ */
+int hashmap_reserve(hashmap_t handle, size_t count);
+
+/* hash map data API functions */
+
+/**
+ * Get the number of items in the map
+ * @param[in] handle: hash map handle
+ * @return: number of items or negative error value
+ */
+int hashmap_length(hashmap_t handle);
+
+/**
+ * Insert an item in the map in amortized O(1) time, the
+ * insertion fails if the key is already in the map.
+ * @param[in] handle: hash map handle
+ * @param[in] key: the item key
+ * @param[in] data: the data given to the constructor
+ * @return: utils error code
+ */
+int hashmap_insert(hashmap_t handle, const void *key, void *data);
+
+/**
+ * Get the data associated with a key in O(1) average time
+ * @param[in] handle: hash map handle
+ * @param[in] key: the item key
+ * @return: data pointer or NULL if the key is not in the map
+ */
+void * hashmap_get(hashmap_t handle, const void *key);
+
+/**
+ * Check whether a key is in the map
+ * @param[in] handle: hash map handle
+ * @param[in] key: the item key
+ * @return: bool, true if the key is in the map
+ */
+bool hashmap_contains(hashmap_t handle, const void *key);
+
+/**
+ * Remove an item from the map
+ * @param[in] handle: hash map handle
+ * @param[in] key: the item key
+ * @return: data of the removed item or NULL
+ */
+void * hashmap_remove(hashmap_t handle, const void *key);
+
+/**
+ * Remove and deallocate an item from the map
+ * @param[in] handle: hash map handle
+ * @param[in] key: the item key
+ * @return: utils error code, error if the key is not in the map
+ */
+int hashmap_delete(hashmap_t handle, const void *key);
+
+/**
+ * Walk the map executing given callback in no particular order,
+ * if the callback returns UTILS_ITER_STOP the iteration stops and
+ * no error is returned, if the callback returns an error code the
+ * iteration stops and the error is propagated.
+ * The callback must not modify the map.
+ * @param[in] handle: hash map handle to iterate
+ * @param[in] cbk: callback to be run for each item
+ * @param[in,out] args: extra arguments given to the callback
+ * @return: utils error code
+ */
+int hashmap_walk(hashmap_t handle, list_cbk_t cbk, void *args);
+
+/* hash map iterator API functions */
+
+/**
+ * Initialize a static iterator struct on the first item of the map,
+ * modifying the map invalidates the iterator.
+ * @param[in] handle: the map to iterate
+ * @param[in,out] iter: iterator handle
+ * @return: zero on success, error value on failure
+ */
+int hashmap_iter_init(hashmap_t handle, hashmap_iter_t iter);
+
+/**
+ * Advance the iterator.
+ * @param[in] iter: the iterator handle
+ * @return: zero on success, negative error value
+ */
+int hashmap_iter_next(hashmap_iter_t iter);
+
+/**
+ * Check if the iterator has reached the end
+ * @param[in] iter: iterator handle
+ * @return: bool, true if the iterator has finished
+ */
+bool hashmap_iter_end(hashmap_iter_t iter);
+
+/**
+ * Get the key of the current item
+ * @param[in] iter: iterator handle
+ * @return: key pointer or NULL
+ */
+const void * hashmap_iter_key(hashmap_iter_t iter);
+
+/**
+ * Get the data of the current item
+ * @param[in] iter: iterator handle
+ * @return: data pointer or NULL
+ */
+void * hashmap_iter_data(hashmap_iter_t iter);
+
+#endif /* UTILS_HASHMAP_H */
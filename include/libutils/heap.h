@@ -0,0 +1,132 @@
+/**
+ * @file
+ * Priority queue.
+ * The queue is a 4-ary min heap stored in a contiguous array, the
+ * order of the items is given by a user comparison function and the
+ * item with the lowest priority value is popped first. Items pushed
+ * with an entry handle can be updated or removed in O(log n) time.
+ * Items are constructed and destructed with the same callbacks used
+ * by the generic list, see list.h.
+ */
+
+#ifndef UTILS_HEAP_H
+#define UTILS_HEAP_H
+
+#include <stddef.h>
+
+#include "libutils/list.h"
+
+/**
+ * Opaque priority queue handle
+ */
+struct heap_handle;
+typedef struct heap_handle * heap_t;
+
+/**
+ * Opaque priority queue entry handle
+ */
+struct heap_entry;
+typedef struct heap_entry * heap_entry_t;
+
+/* priority queue setup API functions */
+
+/**
+ * initialise priority queue handle with item comparison function
+ * and per-item constructor and destructor.
+ * @param[in]: handle pointer to a priority queue handle
+ * @param[in]: cmp comparison function, negative if the first item
+ * must be popped before the second one
+ * @param[in]: ctor item constructor callback
+ * @param[in]: dtor item destructor callback
+ * @return: utils error code
+ */
+int heap_init(heap_t *handle, list_cmp_t cmp, list_ctor_t ctor,
+	      list_dtor_t dtor);
+
+/**
+ * Deallocate priority queue, the destructor is called for each item
+ * and the entry handles are released.
+ * @param[in]: handle priority queue handle
+ * @return: utils error code
+ */
+int heap_destroy(heap_t handle);
+
+/**
+ * Make sure that the queue can hold at least the given number of
+ * items without reallocating.
+ * @param[in] handle: priority queue handle
+ * @param[in] capacity: the number of items to reserve
+ * @return: utils error code
+ */
+int heap_reserve(heap_t handle, size_t capacity);
+
+/* priority queue data API functions */
+
+/**
+ * Get the number of items in the queue
+ * @param[in] handle: priority queue handle
+ * @return: number of items or negative error value
+ */
+int heap_length(heap_t handle);
+
+/**
+ * Push an item in O(log n) time.
+ * @param[in] handle: priority queue handle
+ * @param[in] data: the data given to the constructor
+ * @param[out] entry: the entry handle of the item, valid until the
+ * item leaves the queue, NULL if the handle is not needed
+ * @return: utils error code
+ */
+int heap_push(heap_t handle, void *data, heap_entry_t *entry);
+
+/**
+ * Push an array of items, the queue is rebuilt in O(n) time
+ * when the array is larger than the queue.
+ * @param[in] handle: priority queue handle
+ * @param[in] data: array of data pointers given to the constructor
+ * @param[in] count: the number of data pointers in the array
+ * @return: utils error code
+ */
+int heap_push_n(heap_t handle, void **data, size_t count);
+
+/**
+ * Remove the first item from the queue in O(log n) time
+ * @param[in] handle: priority queue handle
+ * @return: data of the removed item or NULL if the queue is empty
+ */
+void * heap_pop(heap_t handle);
+
+/**
+ * Get the first item of the queue without removing it
+ * @param[in] handle: priority queue handle
+ * @return: data of the first item or NULL if the queue is empty
+ */
+void * heap_peek(heap_t handle);
+
+/**
+ * Restore the order of an item after the caller changed its
+ * priority, e.g. to decrease its key.
+ * @param[in] handle: priority queue handle
+ * @param[in] entry: the entry handle of the item
+ * @return: utils error code
+ */
+int heap_update(heap_t handle, heap_entry_t entry);
+
+/**
+ * Remove an item from the queue by entry handle in O(log n) time,
+ * the entry handle is released.
+ * @param[in] handle: priority queue handle
+ * @param[in] entry: the entry handle of the item
+ * @return: data of the removed item or NULL
+ */
+void * heap_remove(heap_t handle, heap_entry_t entry);
+
+/**
+ * Get the data of an item by entry handle
+ * @param[in] handle: priority queue handle
+ * @param[in] entry: the entry handle of the item
+ * @return: data pointer or NULL
+ */
+void * heap_entry_data(heap_t handle, heap_entry_t entry);
+
+#endif /* UTILS_HEAP_H */
@@ -0,0 +1,209 @@
+/**
+ * @file
+ * Intrusive list implementation.
+ * The list links are embedded in the user objects, so inserting and
+ * removing items never allocates memory. The object holding a link
+ * is recovered with ilist_entry.
+ *
+ * struct object {
+ *   int value;
+ *   struct ilist_link link;
+ * };
+ *
+ * struct object *obj = ilist_entry(link, struct object, link);
+ */
+
+#ifndef UTILS_ILIST_H
+#define UTILS_ILIST_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * List link embedded in the list items
+ */
+struct ilist_link {
+  struct ilist_link *next;
+  struct ilist_link *prev;
+};
+
+/**
+ * Intrusive list head, the list is circular and the
+ * head link is the sentinel of the list.
+ */
+struct ilist {
+  struct ilist_link head;
+  size_t len;
+};
+
+/**
+ * Intrusive list iterator structure
+ */
+struct ilist_iterator {
+  struct ilist *list;
+  struct ilist_link *cursor;
+  struct ilist_link *next;
+};
+typedef struct ilist_iterator ilist_iter_struct_t;
+typedef struct ilist_iterator * ilist_iter_t;
+
+/**
+ * Callback used for walking, see ilist_walk
+ */
+typedef int (*ilist_cbk_t)(struct ilist_link *link, void *args);
+
+/**
+ * Get the object containing a list link
+ * @param[in] link: pointer to the link
+ * @param[in] type: type of the object containing the link
+ * @param[in] member: name of the link member in the object
+ */
+#define ilist_entry(link, type, member)				\
+  ((type *)((char *)(link) - offsetof(type, member)))
+
+/**
+ * Iterate over the list links, the current link
+ * must not be removed from the list in the loop body.
+ * @param[in] list: pointer to the list
+ * @param[out] link: pointer to the current link
+ */
+#define ilist_foreach(list, link)					\
+  for ((link) = (list)->head.next; (link) != &(list)->head;		\
+       (link) = (link)->next)
+
+/* list setup API functions */
+
+/**
+ * Initialise an empty list
+ * @param[in,out] list: pointer to the list
+ * @return: utils error code
+ */
+int ilist_init(struct ilist *list);
+
+/**
+ * Get length of the list
+ * @param[in] list: pointer to the list
+ * @return: length of the list or negative error value
+ */
+int ilist_length(struct ilist *list);
+
+/**
+ * Check if the list is empty
+ * @param[in] list: pointer to the list
+ * @return: true if the list has no items
+ */
+bool ilist_empty(struct ilist *list);
+
+/* list data API functions */
+
+/**
+ * Push a link at the head of the list
+ * @param[in,out] list: pointer to the list
+ * @param[in] link: the link to insert, not in any list
+ * @return: utils error code
+ */
+int ilist_push(struct ilist *list, struct ilist_link *link);
+
+/**
+ * Append a link at the end of the list
+ * @param[in,out] list: pointer to the list
+ * @param[in] link: the link to insert, not in any list
+ * @return: utils error code
+ */
+int ilist_append(struct ilist *list, struct ilist_link *link);
+
+/**
+ * Insert a link after a link in the list
+ * @param[in,out] list: pointer to the list
+ * @param[in] pos: a link in the list
+ * @param[in] link: the link to insert, not in any list
+ * @return: utils error code
+ */
+int ilist_insert_after(struct ilist *list, struct ilist_link *pos,
+		       struct ilist_link *link);
+
+/**
+ * Insert a link before a link in the list
+ * @param[in,out] list: pointer to the list
+ * @param[in] pos: a link in the list
+ * @param[in] link: the link to insert, not in any list
+ * @return: utils error code
+ */
+int ilist_insert_before(struct ilist *list, struct ilist_link *pos,
+			struct ilist_link *link);
+
+/**
+ * Remove a link from the list
+ * @param[in,out] list: pointer to the list
+ * @param[in] link: a link in the list
+ * @return: utils error code
+ */
+int ilist_remove(struct ilist *list, struct ilist_link *link);
+
+/**
+ * Remove the first link of the list
+ * @param[in,out] list: pointer to the list
+ * @return: the removed link or NULL
+ */
+struct ilist_link * ilist_pop(struct ilist *list);
+
+/**
+ * Get the first link of the list
+ * @param[in] list: pointer to the list
+ * @return: the first link or NULL
+ */
+struct ilist_link * ilist_first(struct ilist *list);
+
+/**
+ * Get the last link of the list
+ * @param[in] list: pointer to the list
+ * @return: the last link or NULL
+ */
+struct ilist_link * ilist_last(struct ilist *list);
+
+/**
+ * Walk list executing given callback, if the callback returns
+ * UTILS_ITER_STOP the iteration stops and no error is returned,
+ * if the callback returns an error code the iteration stops
+ * and the error is propagated.
+ * The callback may remove the current link from the list.
+ * @param[in] list: pointer to the list to iterate
+ * @param[in] cbk: callback to be run for each link
+ * @param[in,out] args: extra arguments given to the callback
+ * @return: utils error code
+ */
+int ilist_walk(struct ilist *list, ilist_cbk_t cbk, void *args);
+
+/* list iterator API functions */
+
+/**
+ * Initialize an iterator struct, the current link
+ * can be removed from the list during iteration.
+ * @param[in] list: the list to iterate
+ * @param[in,out] iter: iterator handle
+ * @return: zero on success, error value on failure
+ */
+int ilist_iter_init(struct ilist *list, ilist_iter_t iter);
+
+/**
+ * Advance the iterator.
+ * @param[in] iter: the iterator handle
+ * @return: zero on success, negative error value
+ */
+int ilist_iter_next(ilist_iter_t iter);
+
+/**
+ * Check if the iterator has reached the end
+ * @param[in] iter: iterator handle
+ * @return: bool, true if the iterator has finished
+ */
+bool ilist_iter_end(ilist_iter_t iter);
+
+/**
+ * Get the current link from the iterator
+ * @param[in] iter: iterator handle
+ * @return: link pointer or NULL
+ */
+struct ilist_link * ilist_iter_link(ilist_iter_t iter);
+
+#endif /* UTILS_ILIST_H */
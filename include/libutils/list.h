@@ -7,6 +7,8 @@
 #define UTILS_LIST_H
 
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
 
 /* Opaque types and data structures */
 
@@ -22,7 +24,10 @@ typedef struct list_handle * list_t;
 struct list_iterator {
   struct list_handle *list;
   struct list_item *cursor;
-  struct list_item *guard;
+  struct list_chunk *chunk;
+  int slot;
+  /* the current element was removed, cursor refers to the next one */
+  bool removed;
   bool end;
 };
 typedef struct list_iterator list_iter_struct_t;
@@ -40,6 +45,29 @@ typedef struct list_iterator * list_iter_t;
 struct list_item;
 typedef struct list_item * list_item_t;
 
+/**
+ * Opaque list node pool handle. A node pool hands out
+ * list items from slabs and recycles them when they are
+ * removed from the list, avoiding a malloc/free pair for
+ * each insertion and removal. A pool can be shared by
+ * multiple lists, it is not thread-safe.
+ */
+struct list_pool;
+typedef struct list_pool * list_pool_t;
+
+/**
+ * Memory allocator of a list, see list_init_ex. The list handle,
+ * list items, chunks, indexes and iterators of the list are allocated
+ * with alloc and released with free, both receive the ctx pointer.
+ * The allocator of a LIST_MODE_CONCURRENT list must be thread-safe.
+ */
+struct list_allocator {
+  void * (*alloc)(size_t size, void *ctx);
+  void (*free)(void *ptr, void *ctx);
+  void *ctx;
+};
+typedef struct list_allocator list_allocator_t;
+
 
 /**
  * Callback used for constructor, destructors and walking
@@ -49,6 +77,128 @@ typedef int (*list_dtor_t)(void *itm_data);
 typedef int (*list_cbk_t)(void *itm_data, void *args);
 typedef int (*list_item_cbk_t)(list_item_t itm, void *args);
 
+/**
+ * Comparator used for sorting, returns a negative value, zero or
+ * a positive value if the first item data is respectively less than,
+ * equal to or greater than the second.
+ */
+typedef int (*list_cmp_t)(void *itm_data_a, void *itm_data_b);
+
+/**
+ * Callbacks used by filters, maps and reductions: a predicate returns
+ * true for the items to keep, a map returns the transformed data and a
+ * reduction folds the item data in the accumulator and returns a utils
+ * error code, see list_pipeline.
+ */
+typedef bool (*list_pred_t)(void *itm_data, void *args);
+typedef void * (*list_map_t)(void *itm_data, void *args);
+typedef int (*list_reduce_t)(void *itm_data, void *acc);
+
+/**
+ * Pipeline stage operations, see list_pipeline
+ *
+ * LIST_STAGE_FILTER: drop the items for which the predicate is false.
+ *
+ * LIST_STAGE_MAP: replace the item data with the map result.
+ *
+ * LIST_STAGE_REDUCE: fold the item data in the accumulator given as
+ * stage argument, the item is passed unchanged to the next stage.
+ */
+#define LIST_STAGE_FILTER 0
+#define LIST_STAGE_MAP 1
+#define LIST_STAGE_REDUCE 2
+
+/**
+ * Pipeline stage, build stages with the LIST_FILTER, LIST_MAP and
+ * LIST_REDUCE initializers
+ */
+struct list_stage {
+  int op;
+  union {
+    list_pred_t filter;
+    list_map_t map;
+    list_reduce_t reduce;
+  } fn;
+  void *args;
+};
+typedef struct list_stage list_stage_t;
+
+/**
+ * Callbacks used to store the list data in fixed-size records, see
+ * list_serialize: the encoder writes the item data to a record and the
+ * decoder builds the data given to the list constructor from a record.
+ * Both return a utils error code.
+ */
+typedef int (*list_encode_t)(void *itm_data, void *record, void *args);
+typedef int (*list_decode_t)(const void *record, void **data, void *args);
+
+#define LIST_FILTER(cbk, args) {LIST_STAGE_FILTER, {.filter = (cbk)}, (args)}
+#define LIST_MAP(cbk, args) {LIST_STAGE_MAP, {.map = (cbk)}, (args)}
+#define LIST_REDUCE(cbk, acc) {LIST_STAGE_REDUCE, {.reduce = (cbk)}, (acc)}
+
+/**
+ * List modes, see list_init_mode
+ *
+ * LIST_MODE_INDEXED: maintain a position index alongside the list
+ * so that list_get, list_insert, list_remove and the other positional
+ * functions run in O(log n) instead of walking the list.
+ * The index costs three pointers, a size_t and an int per item,
+ * 40 bytes on LP64 platforms, see list_index_memory.
+ *
+ * LIST_MODE_UNROLLED: store the list data in chunks holding a small
+ * array of data pointers instead of one list item per element,
+ * improving memory footprint and walk/iteration throughput.
+ * Unrolled lists have no list item handles: the list_item_* functions
+ * and list_iter_item fail. Can not be combined with LIST_MODE_INDEXED.
+ *
+ * LIST_MODE_CONCURRENT: the list functions can be called concurrently
+ * from multiple threads. list_push and list_pop hold a head lock and
+ * list_append a tail lock, two-lock queue style, so producers
+ * appending to the list do not contend with consumers popping from
+ * it: the appended items wait in a tail chain that list_pop takes
+ * over only when the rest of the list is empty. The other functions
+ * lock the whole list: lookups, list_length and walks run in parallel
+ * with each other and with list_append, positional and structural
+ * functions run alone. Items are allocated, constructed and
+ * destructed outside the locks. Walk callbacks must not modify the
+ * list. Iterators and list item handles are not protected and
+ * require external synchronization. Combined with LIST_MODE_INDEXED,
+ * LIST_MODE_HASHED or LIST_MODE_UNROLLED, whose indexes are shared by
+ * both ends, list_push, list_append and list_pop lock the whole list.
+ * Only available when the library is built with pthread support.
+ *
+ * LIST_MODE_HASHED: maintain a hash index of the item data pointers
+ * so that list_find_item and the lookup of list_indexof run in O(1)
+ * average time, list_indexof still counts the position of the item
+ * unless the list is also indexed. The index costs between 32 and
+ * 64 bytes per distinct data pointer, see list_index_memory.
+ * Can not be combined with LIST_MODE_UNROLLED.
+ *
+ * LIST_MODE_SPARSE: the empty elements created by inserting past
+ * the end of the list are stored as runs in a single node, instead of
+ * one item each. An empty element is materialized, with its data
+ * built by the constructor from NULL, when it is accessed by position,
+ * by an iterator or by a walk; without a constructor list_get,
+ * list_remove and list_walk read empty elements as NULL without
+ * materializing them. list_sort and list_insert_sorted materialize
+ * the whole list. Can not be combined with the other modes.
+ *
+ * LIST_MODE_SNAPSHOT: the list is the working copy of a list read by
+ * many threads. list_publish makes an immutable copy of the list the
+ * current version, list_snapshot returns the current version without
+ * locking and the version is freed when it has been replaced and the
+ * last snapshot of it is released. Each version constructs its own
+ * items with the list constructor, which must copy or reference count
+ * the data when the destructor releases it. The list itself is
+ * modified as usual, by one thread or with LIST_MODE_CONCURRENT.
+ */
+#define LIST_MODE_INDEXED 0x01
+#define LIST_MODE_UNROLLED 0x02
+#define LIST_MODE_CONCURRENT 0x04
+#define LIST_MODE_HASHED 0x08
+#define LIST_MODE_SPARSE 0x10
+#define LIST_MODE_SNAPSHOT 0x20
+
 /* list setup API functions */
 
 /**
@@ -61,6 +211,50 @@ typedef int (*list_item_cbk_t)(list_item_t itm, void *args);
  */
 int list_init(list_t *handle, list_ctor_t ctor, list_dtor_t dtor);
 
+/**
+ * initialise list handle with per-item constructor and
+ * destructor in the given list mode.
+ * @param[in]: handle pointer to a list handle
+ * @param[in]: ctor item constructor callback
+ * @param[in]: dtor item destructor callback
+ * @param[in]: mode bitmask of LIST_MODE_* flags
+ * @return: utils error code
+ */
+int list_init_mode(list_t *handle, list_ctor_t ctor, list_dtor_t dtor,
+		   int mode);
+
+/**
+ * initialise list handle with per-item constructor and
+ * destructor in the given list mode, with a list allocator.
+ * The items of two lists can be moved from one list to the other
+ * by list_concat and list_splice only when they use the same
+ * allocator, list_split gives its allocator to the new list.
+ * @param[in]: handle pointer to a list handle
+ * @param[in]: ctor item constructor callback
+ * @param[in]: dtor item destructor callback
+ * @param[in]: mode bitmask of LIST_MODE_* flags
+ * @param[in]: allocator the allocator, copied in the list handle,
+ * NULL for malloc and free
+ * @return: utils error code
+ */
+int list_init_ex(list_t *handle, list_ctor_t ctor, list_dtor_t dtor,
+		 int mode, const list_allocator_t *allocator);
+
+/**
+ * initialise list handle with per-item constructor and
+ * destructor, list items are allocated from a node pool.
+ * If the pool is NULL a private pool is created for the list,
+ * it is released with the list and its slabs are freed in bulk.
+ * A shared pool must outlive all the lists that use it.
+ * @param[in]: handle pointer to a list handle
+ * @param[in]: ctor item constructor callback
+ * @param[in]: dtor item destructor callback
+ * @param[in]: pool node pool or NULL
+ * @return: utils error code
+ */
+int list_init_pool(list_t *handle, list_ctor_t ctor, list_dtor_t dtor,
+		   list_pool_t pool);
+
 /**
  * Deallocate list, the destructor is called for each list
  * item.
@@ -69,6 +263,128 @@ int list_init(list_t *handle, list_ctor_t ctor, list_dtor_t dtor);
  */
 int list_destroy(list_t handle);
 
+/**
+ * initialise a read-only list over the records of a file written by
+ * list_serialize. The file is mapped in memory when the platform
+ * supports it, otherwise it is read at once; no list item is allocated
+ * and the item data are pointers to the records. The list can be read
+ * by position, walked and iterated, and serialized again. The functions
+ * modifying the list and the list_item_* functions fail.
+ * @param[in]: handle pointer to a list handle
+ * @param[in]: path the path of the record file
+ * @return: utils error code
+ */
+int list_init_mapped(list_t *handle, const char *path);
+
+/**
+ * initialise a list storing values of a fixed size in its items.
+ * The value is copied in the item when it is inserted, the data
+ * given to the insertion functions points to the value to copy or is
+ * NULL for a zeroed value. The item data are pointers to the values
+ * stored in the items, valid until the item is removed, so that the
+ * list is walked without following a pointer per item. The values are
+ * copied out with list_get_value and list_remove_value; list_remove,
+ * list_pop, list_iter_remove and list_item_remove would return the
+ * address of a released value and fail, the delete functions remove
+ * the items as usual.
+ * @param[in]: handle pointer to a list handle
+ * @param[in]: value_size the size of a value in bytes
+ * @param[in]: mode bitmask of LIST_MODE_INDEXED, LIST_MODE_CONCURRENT
+ * and LIST_MODE_HASHED flags
+ * @return: utils error code
+ */
+int list_init_value(list_t *handle, size_t value_size, int mode);
+
+/* list serialization API functions */
+
+/**
+ * Write the list to a stream as a header followed by one fixed-size
+ * record per item, in list order. The header holds the record size
+ * and count in host byte order, the file is not portable across
+ * architectures with different endianness.
+ * @param[in] handle: list handle
+ * @param[in] stream: the output stream
+ * @param[in] record_size: the size of a record in bytes
+ * @param[in] encode: record encoder run for each item
+ * @param[in,out] args: extra arguments given to the encoder
+ * @return: utils error code
+ */
+int list_serialize(list_t handle, FILE *stream, size_t record_size,
+		   list_encode_t encode, void *args);
+
+/**
+ * Append the records of a stream written by list_serialize to
+ * the list, the decoded data are given to the list constructor and
+ * the items are allocated in blocks as in list_append_n.
+ * @param[in] handle: list handle
+ * @param[in] stream: the input stream
+ * @param[in] decode: record decoder run for each record
+ * @param[in,out] args: extra arguments given to the decoder
+ * @return: utils error code
+ */
+int list_deserialize(list_t handle, FILE *stream, list_decode_t decode,
+		     void *args);
+
+/* list snapshot API functions */
+
+/**
+ * Publish a copy of a LIST_MODE_SNAPSHOT list as its current version,
+ * the snapshots taken before keep reading the previous version.
+ * The copy takes O(n) time, changes are meant to be batched
+ * between two calls.
+ * @param[in] handle: list handle
+ * @return: utils error code
+ */
+int list_publish(list_t handle);
+
+/**
+ * Get the current version of a LIST_MODE_SNAPSHOT list without
+ * locking, the version is an empty list until the first call to
+ * list_publish. The snapshot is a read-only list: it can be read
+ * by position, walked and iterated by any number of threads, while
+ * the functions modifying it fail. It stays valid until it is
+ * released, even after the list is destroyed.
+ * @param[in] handle: list handle
+ * @return: the snapshot or NULL
+ */
+list_t list_snapshot(list_t handle);
+
+/**
+ * Release a snapshot returned by list_snapshot, the last release of
+ * a replaced version frees it.
+ * @param[in] snapshot: the snapshot to release
+ * @return: utils error code
+ */
+int list_snapshot_release(list_t snapshot);
+
+/* list node pool API functions */
+
+/**
+ * Initialise a node pool that can be shared between lists.
+ * @param[in,out]: pool pointer to a node pool handle
+ * @param[in]: slab_items number of list items allocated at once,
+ * zero selects the default slab size
+ * @return: utils error code
+ */
+int list_pool_init(list_pool_t *pool, size_t slab_items);
+
+/**
+ * Release a node pool and all its slabs, the pool
+ * must not be in use by any list.
+ * @param[in]: pool node pool handle
+ * @return: utils error code
+ */
+int list_pool_destroy(list_pool_t pool);
+
+/**
+ * Get the memory used by the list indexes, the position index
+ * of LIST_MODE_INDEXED and the data index of LIST_MODE_HASHED.
+ * @param[in] handle: list handle
+ * @param[out] bytes: size of the indexes in bytes
+ * @return: utils error code
+ */
+int list_index_memory(list_t handle, size_t *bytes);
+
 /* list data API functions */
 
 /**
@@ -135,6 +451,26 @@ int list_indexof(list_t handle, void *data);
  */
 int list_delete(list_t handle, int position);
 
+/**
+ * Copy the value at the given position of a list initialised
+ * by list_init_value.
+ * @param[in] handle: list handle
+ * @param[in] position: index in the list of the value
+ * @param[out] value: the buffer receiving the value
+ * @return: utils error code
+ */
+int list_get_value(list_t handle, int position, void *value);
+
+/**
+ * Remove the value at the given position of a list initialised
+ * by list_init_value, copying it out first.
+ * @param[in,out] handle: list handle
+ * @param[in] position: index in the list from which the value is removed
+ * @param[out] value: the buffer receiving the value or NULL
+ * @return: utils error code
+ */
+int list_remove_value(list_t handle, int position, void *value);
+
 /**
  * Walk list executing given callback, if the callback returns
  * UTILS_ITER_STOP the iteration stops and no error is returned,
@@ -147,6 +483,86 @@ int list_delete(list_t handle, int position);
  */
 int list_walk(list_t handle, list_cbk_t cbk, void *args);
 
+/**
+ * Walk the list with multiple threads, see list_walk.
+ * The list is split in contiguous ranges and the callback runs
+ * concurrently on the items of each range, the callback and its
+ * extra arguments must be thread-safe. A callback returning
+ * UTILS_ITER_STOP or an error stops all the threads as soon as
+ * possible, items past the stopping one may still be visited.
+ * The list must not be modified during the walk.
+ * Each call creates up to nthreads - 1 threads, the calling thread
+ * walks the first range, and joins them before returning: the walk
+ * pays off only when the callbacks outweigh the thread start-up.
+ * The ranges of plain lists are found by a serial walk from the
+ * head in O(n) time, indexed lists find them in O(log n) time per
+ * range and unrolled lists skip whole chunks.
+ * Without pthreads the list is walked serially.
+ * @param[in] handle: list handle to iterate
+ * @param[in] cbk: callback to be run for each item
+ * @param[in,out] args: extra arguments given to the callback
+ * @param[in] nthreads: the maximum number of threads to use
+ * @return: utils error code
+ */
+int list_walk_parallel(list_t handle, list_cbk_t cbk, void *args,
+		       int nthreads);
+
+/**
+ * Remove in place the items for which the predicate returns false,
+ * the destructor is called for each removed item. The list is
+ * traversed once, unrolled lists are compacted as they are scanned
+ * and the empty elements of sparse lists are materialized.
+ * The predicate and the destructor must not access the list.
+ * @param[in] handle: list handle
+ * @param[in] pred: predicate run for each item
+ * @param[in,out] args: extra arguments given to the predicate
+ * @return: utils error code
+ */
+int list_filter(list_t handle, list_pred_t pred, void *args);
+
+/**
+ * Append the result of a map function for each item to another
+ * list, the destination list constructor is called for each result.
+ * @param[in] handle: list handle to iterate
+ * @param[in] dst: the destination list, not the same as handle
+ * @param[in] map: map function run for each item
+ * @param[in,out] args: extra arguments given to the map function
+ * @return: utils error code
+ */
+int list_map(list_t handle, list_t dst, list_map_t map, void *args);
+
+/**
+ * Fold the list data in an accumulator, in list order. If the
+ * reduction returns UTILS_ITER_STOP the iteration stops and no error
+ * is returned, if it returns an error code the iteration stops and
+ * the error is propagated.
+ * @param[in] handle: list handle to iterate
+ * @param[in] reduce: reduction run for each item
+ * @param[in,out] acc: the accumulator given to the reduction
+ * @return: utils error code
+ */
+int list_reduce(list_t handle, list_reduce_t reduce, void *acc);
+
+/**
+ * Run a sequence of filter, map and reduce stages in a single walk
+ * of the list: each item goes through the stages in order until a
+ * filter drops it, then the resulting data is appended to the
+ * destination list if any. The source list is not modified.
+ * e.g. the sum of the squares of the even items:
+ *   list_stage_t stages[] = {LIST_FILTER(is_even, NULL),
+ *			      LIST_MAP(square, NULL),
+ *			      LIST_REDUCE(sum, &total)};
+ *   list_pipeline(lst, stages, 3, NULL);
+ * Reductions stop or fail the walk as in list_reduce.
+ * @param[in] handle: list handle to iterate
+ * @param[in] stages: the array of stages
+ * @param[in] nstages: the number of stages
+ * @param[in] dst: the destination list or NULL, not the same as handle
+ * @return: utils error code
+ */
+int list_pipeline(list_t handle, const list_stage_t *stages, size_t nstages,
+		  list_t dst);
+
 /**
  * Append element to the end of the list
  * @param[in] handle: pointer to a list handle
@@ -155,6 +571,91 @@ int list_walk(list_t handle, list_cbk_t cbk, void *args);
  */
 int list_append(list_t handle, void *data);
 
+/**
+ * Append an array of elements to the end of the list, the list
+ * nodes missing from the node pool of the list, see list_init_pool,
+ * are allocated with a single slab; the nodes of a list without a
+ * pool are allocated one by one. The elements are stored in array
+ * order and linked with a single lock acquisition.
+ * @param[in] handle: list handle
+ * @param[in] data: array of data pointers to append
+ * @param[in] count: the number of data pointers in the array
+ * @return: utils error code
+ */
+int list_append_n(list_t handle, void **data, size_t count);
+
+/**
+ * Push an array of elements to the head of the list, see
+ * list_append_n. data[0] becomes the first element of the list.
+ * @param[in] handle: list handle
+ * @param[in] data: array of data pointers to push
+ * @param[in] count: the number of data pointers in the array
+ * @return: utils error code
+ */
+int list_push_n(list_t handle, void **data, size_t count);
+
+/**
+ * Sort the list with a stable merge sort in O(n log n) time.
+ * The list items are relinked in place without allocating memory,
+ * item handles stay valid. Unrolled lists sort their data with a
+ * temporary buffer.
+ * @param[in] handle: list handle
+ * @param[in] cmp: item data comparator
+ * @return: utils error code
+ */
+int list_sort(list_t handle, list_cmp_t cmp);
+
+/**
+ * Insert element in a sorted list, after the elements that
+ * compare equal. The comparator is given the constructed item data.
+ * Appending in order takes constant time, indexed lists find the
+ * position in O(log n) time.
+ * @param[in] handle: list handle
+ * @param[in] data: the data to insert
+ * @param[in] cmp: item data comparator
+ * @return: utils error code
+ */
+int list_insert_sorted(list_t handle, void *data, list_cmp_t cmp);
+
+/**
+ * Move all the elements of a list to the end of another list.
+ * The list items are relinked without allocating memory, in O(1)
+ * time, see list_splice.
+ * @param[in] dst: list handle receiving the elements
+ * @param[in] src: list handle giving the elements, empty on success
+ * @return: utils error code
+ */
+int list_concat(list_t dst, list_t src);
+
+/**
+ * Move all the elements of a list in another list at the given
+ * position. The lists must be different and have the same mode,
+ * the moved elements are destructed by the destination list.
+ * Relinking takes O(1) time plus the time to find the position,
+ * indexed lists update their index in O(log n) and hashed lists
+ * move the index entries of the moved elements. A source list
+ * using a node pool shared with other lists can be moved only to
+ * a list using the same pool.
+ * @param[in] dst: list handle receiving the elements
+ * @param[in] position: the position of the first moved element,
+ *   at most the length of dst
+ * @param[in] src: list handle giving the elements, empty on success
+ * @return: utils error code
+ */
+int list_splice(list_t dst, int position, list_t src);
+
+/**
+ * Split a list in two, the elements from the given position to
+ * the end of the list are moved to a new list with the same
+ * constructor, destructor, mode and node pool, see list_splice.
+ * @param[in] handle: list handle to split
+ * @param[in] position: the position of the first moved element,
+ *   at most the list length
+ * @param[out] out: the new list handle
+ * @return: utils error code
+ */
+int list_split(list_t handle, int position, list_t *out);
+
 /* list iterator API functions */
 
 /**
@@ -165,7 +666,8 @@ int list_append(list_t handle, void *data);
 list_iter_t list_iter(list_t handle);
 
 /**
- * Free an iterator
+ * Free an iterator, also after the list it was allocated for
+ * is destroyed
  * @param[in] iter: iterator handle to free.
  * @return: zero on success, negative error value
  */
@@ -178,17 +680,41 @@ int list_iter_free(list_iter_t iter);
  */
 int list_iter_next(list_iter_t iter);
 
+/**
+ * Move the iterator back to the previous element, the
+ * iterator ends when it moves before the list head.
+ * @param[in] iter: the iterator handle
+ * @return: zero on success, negative error value
+ */
+int list_iter_prev(list_iter_t iter);
+
 /**
  * Get next data object in the list from iterator
- * XXX the iterator can be made deletion-safe if it stores
- * a pointer to the head pointer in struct list_handle or a
- * pointer to the whole list_handle instead of a pointer to
- * the head element.
  * @param[in,out] iter: iterator handle
- * @return: data pointer or NULL
+ * @return: data pointer or NULL, NULL after the current
+ * element has been removed
  */
 void * list_iter_data(list_iter_t iter);
 
+/**
+ * Remove the current element of the iterator from the list.
+ * The iterator stays valid: the following list_iter_next moves
+ * to the element after the removed one and list_iter_prev to
+ * the element before it, so a list can be filtered in a single
+ * pass. Other modifications of the list invalidate the iterator.
+ * @param[in] iter: iterator handle
+ * @return: the removed data or NULL
+ */
+void * list_iter_remove(list_iter_t iter);
+
+/**
+ * Remove and deallocate the current element of the iterator,
+ * see list_iter_remove.
+ * @param[in] iter: iterator handle
+ * @return: utils error code
+ */
+int list_iter_delete(list_iter_t iter);
+
 /**
  * Check if the iterator has reached the end
  * @param[in] iter: iterator handle
@@ -197,7 +723,8 @@ void * list_iter_data(list_iter_t iter);
 bool list_iter_end(list_iter_t iter);
 
 /**
- * Seek iterator to the given index
+ * Seek iterator to the given index, the list is scanned
+ * from the closest end.
  * @param[in] iter: iterator handle
  * @param[in] index: the index to seek to
  * @return: zero on success, negative error value
@@ -213,6 +740,15 @@ int list_iter_seek(list_iter_t iter, int index);
  */
 int list_iter_init(list_t handle, list_iter_t iter);
 
+/**
+ * Initialize a static iterator struct on the last
+ * element of the list, for reverse iteration.
+ * @param[in] handle: the list to iterate
+ * @param[in,out] iter: iterator handle
+ * @return: zero on success, error value on failure
+ */
+int list_iter_init_tail(list_t handle, list_iter_t iter);
+
 /* list item handle API functions */
 
 /**
@@ -229,6 +765,14 @@ void * list_item_getdata(list_item_t item);
  */
 void * list_item_remove(list_t handle, list_item_t item);
 
+/**
+ * Get item handle for the first item holding the given data
+ * @param[in] handle: list handle
+ * @param[in] data: the item data to look for
+ * @return: list item holding the data or NULL
+ */
+list_item_t list_find_item(list_t handle, void *data);
+
 /**
  * Get item handle for the item at the given position
  * @param[in,out] handle: list handle
@@ -0,0 +1,410 @@
+/**
+ * @file
+ * Header-only C++ layer over the generic list, see list.h.
+ * The values of a libutils::list<T> are constructed in place in the
+ * items of a list initialised by list_init_value, so that a value
+ * costs a single allocation and no destructor callback.
+ */
+
+#ifndef UTILS_LIST_HPP
+#define UTILS_LIST_HPP
+
+#include <cstddef>
+#include <iterator>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+extern "C" {
+#include "libutils/error.h"
+#include "libutils/list.h"
+}
+
+namespace libutils {
+
+/**
+ * List of values of type T owning its values. The list is movable
+ * but not copyable, a moved-from list is empty. The list is not
+ * thread-safe. The values do not move while they are in the list,
+ * references and iterators stay valid until the value is removed.
+ */
+template <typename T>
+class list {
+  static_assert(alignof(T) <= 8, "list values are aligned to 8 bytes");
+
+public:
+  /**
+   * Forward iterator over the values, maps to list_iter_*.
+   * V is T or const T.
+   */
+  template <typename V>
+  class basic_iterator {
+  public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef T value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef V *pointer;
+    typedef V &reference;
+
+    basic_iterator()
+    {
+      iter_.list = NULL;
+      iter_.cursor = NULL;
+      iter_.chunk = NULL;
+      iter_.slot = 0;
+      iter_.removed = false;
+      iter_.end = true;
+    }
+
+    /* copies an iterator, or converts it to a const iterator */
+    basic_iterator(const basic_iterator<T> &other) : iter_(other.iter_)
+    {
+    }
+
+    reference operator*() const
+    {
+      return *static_cast<pointer>(list_iter_data(
+	const_cast<list_iter_t>(&iter_)));
+    }
+
+    pointer operator->() const
+    {
+      return &**this;
+    }
+
+    basic_iterator &operator++()
+    {
+      list_iter_next(&iter_);
+      return *this;
+    }
+
+    basic_iterator operator++(int)
+    {
+      basic_iterator prev(*this);
+
+      list_iter_next(&iter_);
+      return prev;
+    }
+
+    bool operator==(const basic_iterator &other) const
+    {
+      if (iter_.end || other.iter_.end)
+	return iter_.end == other.iter_.end;
+      return iter_.cursor == other.iter_.cursor;
+    }
+
+    bool operator!=(const basic_iterator &other) const
+    {
+      return !(*this == other);
+    }
+
+  private:
+    friend class list;
+    template <typename> friend class basic_iterator;
+
+    explicit basic_iterator(const list_iter_struct_t &iter) : iter_(iter)
+    {
+    }
+
+    list_iter_struct_t iter_;
+  };
+
+  typedef T value_type;
+  typedef std::size_t size_type;
+  typedef T &reference;
+  typedef const T &const_reference;
+  typedef basic_iterator<T> iterator;
+  typedef basic_iterator<const T> const_iterator;
+
+  /**
+   * Create an empty list.
+   * @param[in] mode: 0 or LIST_MODE_INDEXED for O(log n) access
+   * by position
+   */
+  explicit list(int mode = 0) : handle_(NULL), mode_(mode)
+  {
+    if (mode & ~LIST_MODE_INDEXED)
+      throw std::invalid_argument("libutils::list: unsupported list mode");
+  }
+
+  list(list &&other) noexcept : handle_(other.handle_), mode_(other.mode_)
+  {
+    other.handle_ = NULL;
+  }
+
+  list &operator=(list &&other) noexcept
+  {
+    if (this != &other) {
+      destroy();
+      handle_ = other.handle_;
+      mode_ = other.mode_;
+      other.handle_ = NULL;
+    }
+    return *this;
+  }
+
+  list(const list &) = delete;
+  list &operator=(const list &) = delete;
+
+  ~list()
+  {
+    destroy();
+  }
+
+  /**
+   * Construct a value at the end of the list.
+   * @return: the new value
+   */
+  template <typename... Args>
+  T &emplace_back(Args &&... args)
+  {
+    list_iter_struct_t iter;
+
+    if (list_append(native(), NULL))
+      throw std::bad_alloc();
+    list_iter_init_tail(handle_, &iter);
+    return construct(&iter, std::forward<Args>(args)...);
+  }
+
+  /**
+   * Construct a value at the front of the list.
+   * @return: the new value
+   */
+  template <typename... Args>
+  T &emplace_front(Args &&... args)
+  {
+    list_iter_struct_t iter;
+
+    if (list_push(native(), NULL))
+      throw std::bad_alloc();
+    list_iter_init(handle_, &iter);
+    return construct(&iter, std::forward<Args>(args)...);
+  }
+
+  void push_back(T &&value)
+  {
+    emplace_back(std::move(value));
+  }
+
+  void push_back(const T &value)
+  {
+    emplace_back(value);
+  }
+
+  void push_front(T &&value)
+  {
+    emplace_front(std::move(value));
+  }
+
+  void push_front(const T &value)
+  {
+    emplace_front(value);
+  }
+
+  void pop_front()
+  {
+    list_iter_struct_t iter;
+
+    list_iter_init(handle_, &iter);
+    remove(&iter);
+  }
+
+  void pop_back()
+  {
+    list_iter_struct_t iter;
+
+    list_iter_init_tail(handle_, &iter);
+    remove(&iter);
+  }
+
+  /**
+   * Remove the value of an iterator.
+   * @return: an iterator on the value following the removed one
+   */
+  iterator erase(const_iterator pos)
+  {
+    iterator next(pos.iter_);
+
+    remove(&next.iter_);
+    list_iter_next(&next.iter_);
+    return next;
+  }
+
+  /**
+   * Remove all the values, the list stays usable.
+   */
+  void clear() noexcept
+  {
+    if (handle_ != NULL)
+      list_filter(handle_, destroy_value, NULL);
+  }
+
+  T &front()
+  {
+    return *begin();
+  }
+
+  const T &front() const
+  {
+    return *begin();
+  }
+
+  T &back()
+  {
+    list_iter_struct_t iter;
+
+    list_iter_init_tail(handle_, &iter);
+    return *static_cast<T *>(list_iter_data(&iter));
+  }
+
+  const T &back() const
+  {
+    return const_cast<list *>(this)->back();
+  }
+
+  /**
+   * Value at a position, in O(log n) time for indexed lists
+   * and O(n) time otherwise. As with std::vector, the position
+   * is not checked, see at.
+   */
+  T &operator[](size_type position)
+  {
+    return *static_cast<T *>(list_get(handle_, position));
+  }
+
+  const T &operator[](size_type position) const
+  {
+    return *static_cast<const T *>(list_get(handle_, position));
+  }
+
+  T &at(size_type position)
+  {
+    if (position >= size())
+      throw std::out_of_range("libutils::list::at");
+    return (*this)[position];
+  }
+
+  const T &at(size_type position) const
+  {
+    return const_cast<list *>(this)->at(position);
+  }
+
+  size_type size() const noexcept
+  {
+    return (handle_ != NULL) ? list_length(handle_) : 0;
+  }
+
+  bool empty() const noexcept
+  {
+    return size() == 0;
+  }
+
+  iterator begin() noexcept
+  {
+    return iterator(first());
+  }
+
+  iterator end() noexcept
+  {
+    return iterator();
+  }
+
+  const_iterator begin() const noexcept
+  {
+    return const_iterator(first());
+  }
+
+  const_iterator end() const noexcept
+  {
+    return const_iterator();
+  }
+
+  const_iterator cbegin() const noexcept
+  {
+    return begin();
+  }
+
+  const_iterator cend() const noexcept
+  {
+    return end();
+  }
+
+  /**
+   * Get the underlying list, created on first use, for the C
+   * functions reading the list. The values must not be inserted
+   * or removed through the C API.
+   */
+  list_t native()
+  {
+    if (handle_ == NULL && list_init_value(&handle_, sizeof(T), mode_))
+      throw std::bad_alloc();
+    return handle_;
+  }
+
+private:
+  /**
+   * Construct a value in the zeroed storage of a new list
+   * element, the element is removed if the constructor throws.
+   */
+  template <typename... Args>
+  static T &construct(list_iter_t iter, Args &&... args)
+  {
+    void *storage = list_iter_data(iter);
+
+    try {
+      return *new (storage) T(std::forward<Args>(args)...);
+    }
+    catch (...) {
+      list_iter_delete(iter);
+      throw;
+    }
+  }
+
+  /**
+   * Destroy and remove the value of an iterator
+   */
+  static void remove(list_iter_t iter)
+  {
+    static_cast<T *>(list_iter_data(iter))->~T();
+    list_iter_delete(iter);
+  }
+
+  static bool destroy_value(void *itm_data, void *args)
+  {
+    static_cast<T *>(itm_data)->~T();
+    return false;
+  }
+
+  static int destroy_cbk(void *itm_data, void *args)
+  {
+    static_cast<T *>(itm_data)->~T();
+    return UTILS_OK;
+  }
+
+  void destroy() noexcept
+  {
+    if (handle_ == NULL)
+      return;
+    if (!std::is_trivially_destructible<T>::value)
+      list_walk(handle_, destroy_cbk, NULL);
+    list_destroy(handle_);
+    handle_ = NULL;
+  }
+
+  list_iter_struct_t first() const noexcept
+  {
+    list_iter_struct_t iter = basic_iterator<T>().iter_;
+
+    if (handle_ != NULL)
+      list_iter_init(handle_, &iter);
+    return iter;
+  }
+
+  list_t handle_;
+  int mode_;
+};
+
+} /* namespace libutils */
+
+#endif /* UTILS_LIST_HPP */
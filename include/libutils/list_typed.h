@@ -0,0 +1,476 @@
+/**
+ * @file
+ * Typed lists generated by macros.
+ * LIST_DECLARE(name, type) declares a list storing values of the given
+ * type in its items, with static inline functions mirroring the data,
+ * walk and iterator functions of list.h under the name_ prefix. The
+ * values are given and returned by value or by typed pointers, and the
+ * value constructor and destructor are expanded in the generated
+ * functions, so that the loops over a typed list compile down to
+ * direct accesses to the values.
+ *
+ * LIST_DECLARE(points, struct point)
+ *
+ * points_t lst;
+ * points_iter_struct_t iter;
+ *
+ * points_init(&lst);
+ * points_append(lst, (struct point){1, 2});
+ * for (points_iter_init(lst, &iter); !points_iter_end(&iter);
+ *      points_iter_next(&iter))
+ *   sum += points_iter_data(&iter)->x;
+ *
+ * The functions behave as their list.h counterpart in the default
+ * list mode, except that name_pop, name_remove and name_iter_remove
+ * move the removed value to a buffer without destructing it, and
+ * name_indexof looks for the address of a value in the list.
+ * Typed lists are not thread-safe.
+ */
+
+#ifndef UTILS_LIST_TYPED_H
+#define UTILS_LIST_TYPED_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "libutils/error.h"
+
+/**
+ * Default value constructor, the value is copied
+ */
+#define LIST_TYPED_COPY(dst, src) (*(dst) = (src))
+
+/**
+ * Default value destructor, nothing is released
+ */
+#define LIST_TYPED_NONE(value) ((void)(value))
+
+/**
+ * Declare a typed list copying its values, see LIST_DECLARE_EX
+ * @param[in] name: prefix of the generated types and functions
+ * @param[in] type: the value type
+ */
+#define LIST_DECLARE(name, type)					\
+  LIST_DECLARE_EX(name, type, LIST_TYPED_COPY, LIST_TYPED_NONE)
+
+/**
+ * Declare a typed list, in a single translation unit or in a header.
+ * @param[in] name: prefix of the generated types and functions
+ * @param[in] type: the value type
+ * @param[in] ctor: the value constructor, a function or function-like
+ * macro called as ctor(type *itm_data, type data)
+ * @param[in] dtor: the value destructor, a function or function-like
+ * macro called as dtor(type *itm_data)
+ */
+#define LIST_DECLARE_EX(name, type, ctor, dtor)				\
+									\
+/* list item holding a value */						\
+struct name##_item {							\
+  struct name##_item *next;						\
+  struct name##_item *prev;						\
+  type data;								\
+};									\
+									\
+/* list handle, the items form a circular list starting at base */	\
+struct name##_handle {							\
+  struct name##_item *base;						\
+  size_t len;								\
+};									\
+typedef struct name##_handle * name##_t;				\
+									\
+/* list iterator, see list_iter_init. The flags are apart so that	\
+ * their tests are not merged in a load spanning both of them,		\
+ * which keeps the iterator out of registers in inlined loops		\
+ */									\
+struct name##_iterator {						\
+  struct name##_handle *list;						\
+  bool end;								\
+  struct name##_item *cursor;						\
+  bool removed;								\
+};									\
+typedef struct name##_iterator name##_iter_struct_t;			\
+typedef struct name##_iterator * name##_iter_t;				\
+									\
+/* callback used for walking, see list_walk */				\
+typedef int (*name##_cbk_t)(type *itm_data, void *args);		\
+									\
+static inline int							\
+name##_init(name##_t *phandle)						\
+{									\
+  if (phandle == NULL)							\
+    return UTILS_ERROR;							\
+  *phandle = malloc(sizeof(struct name##_handle));			\
+  if (*phandle == NULL)							\
+    return UTILS_ERROR;							\
+  (*phandle)->base = NULL;						\
+  (*phandle)->len = 0;							\
+  return UTILS_OK;							\
+}									\
+									\
+static inline int							\
+name##_destroy(name##_t handle)						\
+{									\
+  struct name##_item *item, *next;					\
+  size_t i;								\
+									\
+  if (handle == NULL)							\
+    return UTILS_ERROR;							\
+  item = handle->base;							\
+  for (i = 0; i < handle->len; i++) {					\
+    next = item->next;							\
+    dtor(&item->data);							\
+    free(item);								\
+    item = next;							\
+  }									\
+  free(handle);								\
+  return UTILS_OK;							\
+}									\
+									\
+static inline int							\
+name##_length(name##_t handle)						\
+{									\
+  if (handle == NULL)							\
+    return -UTILS_ERROR;						\
+  return (int)handle->len;						\
+}									\
+									\
+/* find the item at a valid position from the closest end */		\
+static inline struct name##_item *					\
+name##_item_find(name##_t handle, size_t position)			\
+{									\
+  struct name##_item *item = handle->base;				\
+  size_t i;								\
+									\
+  if (position <= handle->len / 2)					\
+    for (i = 0; i < position; i++)					\
+      item = item->next;						\
+  else									\
+    for (i = handle->len; i > position; i--)				\
+      item = item->prev;						\
+  return item;								\
+}									\
+									\
+/* link an item at a position at most the list length */		\
+static inline void							\
+name##_item_link(name##_t handle, struct name##_item *item,		\
+		 size_t position)					\
+{									\
+  struct name##_item *next;						\
+									\
+  if (handle->base == NULL) {						\
+    item->next = item;							\
+    item->prev = item;							\
+    handle->base = item;						\
+  }									\
+  else {								\
+    next = (position == handle->len) ? handle->base :			\
+      name##_item_find(handle, position);				\
+    item->next = next;							\
+    item->prev = next->prev;						\
+    next->prev->next = item;						\
+    next->prev = item;							\
+    if (position == 0)							\
+      handle->base = item;						\
+  }									\
+  handle->len++;							\
+}									\
+									\
+static inline void							\
+name##_item_unlink(name##_t handle, struct name##_item *item)		\
+{									\
+  if (item->next == item) {						\
+    handle->base = NULL;						\
+  }									\
+  else {								\
+    item->prev->next = item->next;					\
+    item->next->prev = item->prev;					\
+    if (handle->base == item)						\
+      handle->base = item->next;					\
+  }									\
+  handle->len--;							\
+}									\
+									\
+/* construct a value in a new item linked at the given position */	\
+static inline int							\
+name##_place(name##_t handle, type data, size_t position)		\
+{									\
+  struct name##_item *item;						\
+									\
+  item = malloc(sizeof(struct name##_item));				\
+  if (item == NULL)							\
+    return UTILS_ERROR;							\
+  ctor(&item->data, data);						\
+  name##_item_link(handle, item, position);				\
+  return UTILS_OK;							\
+}									\
+									\
+/* unlink the item at the given position */				\
+static inline struct name##_item *					\
+name##_take(name##_t handle, int position)				\
+{									\
+  struct name##_item *item;						\
+									\
+  if (handle == NULL || position < 0 || (size_t)position >= handle->len) \
+    return NULL;							\
+  item = name##_item_find(handle, position);				\
+  name##_item_unlink(handle, item);					\
+  return item;								\
+}									\
+									\
+static inline int							\
+name##_insert(name##_t handle, type data, int position)			\
+{									\
+  type zero;								\
+									\
+  if (handle == NULL || position < 0)					\
+    return UTILS_ERROR;							\
+  if ((size_t)position > handle->len) {					\
+    memset(&zero, 0, sizeof(type));					\
+    while ((size_t)position > handle->len)				\
+      if (name##_place(handle, zero, handle->len))			\
+	return UTILS_ERROR;						\
+  }									\
+  return name##_place(handle, data, position);				\
+}									\
+									\
+static inline int							\
+name##_push(name##_t handle, type data)					\
+{									\
+  return name##_insert(handle, data, 0);				\
+}									\
+									\
+static inline int							\
+name##_append(name##_t handle, type data)				\
+{									\
+  if (handle == NULL)							\
+    return UTILS_ERROR;							\
+  return name##_place(handle, data, handle->len);			\
+}									\
+									\
+static inline int							\
+name##_remove(name##_t handle, int position, type *data)		\
+{									\
+  struct name##_item *item;						\
+									\
+  if (data == NULL)							\
+    return UTILS_ERROR;							\
+  item = name##_take(handle, position);					\
+  if (item == NULL)							\
+    return UTILS_ERROR;							\
+  *data = item->data;							\
+  free(item);								\
+  return UTILS_OK;							\
+}									\
+									\
+static inline int							\
+name##_pop(name##_t handle, type *data)					\
+{									\
+  return name##_remove(handle, 0, data);				\
+}									\
+									\
+static inline int							\
+name##_delete(name##_t handle, int position)				\
+{									\
+  struct name##_item *item;						\
+									\
+  item = name##_take(handle, position);					\
+  if (item == NULL)							\
+    return UTILS_ERROR;							\
+  dtor(&item->data);							\
+  free(item);								\
+  return UTILS_OK;							\
+}									\
+									\
+static inline type *							\
+name##_get(name##_t handle, int position)				\
+{									\
+  if (handle == NULL || position < 0 || (size_t)position >= handle->len) \
+    return NULL;							\
+  return &name##_item_find(handle, position)->data;			\
+}									\
+									\
+static inline int							\
+name##_indexof(name##_t handle, const type *data)			\
+{									\
+  struct name##_item *item;						\
+  size_t i;								\
+									\
+  if (handle == NULL)							\
+    return -UTILS_ERROR;						\
+  item = handle->base;							\
+  for (i = 0; i < handle->len; i++, item = item->next)			\
+    if (&item->data == data)						\
+      return (int)i;							\
+  return -UTILS_ERROR;							\
+}									\
+									\
+static inline int							\
+name##_walk(name##_t handle, name##_cbk_t cbk, void *args)		\
+{									\
+  struct name##_item *item;						\
+  size_t i;								\
+  int err;								\
+									\
+  if (handle == NULL || cbk == NULL)					\
+    return UTILS_ERROR;							\
+  item = handle->base;							\
+  for (i = 0; i < handle->len; i++, item = item->next) {		\
+    err = cbk(&item->data, args);					\
+    if (err == UTILS_ITER_STOP)						\
+      break;								\
+    if (err != UTILS_OK)						\
+      return UTILS_ERROR;						\
+  }									\
+  return UTILS_OK;							\
+}									\
+									\
+static inline int							\
+name##_iter_init(name##_t handle, name##_iter_t iter)			\
+{									\
+  if (handle == NULL || iter == NULL)					\
+    return UTILS_ERROR;							\
+  iter->list = handle;							\
+  iter->cursor = handle->base;						\
+  iter->removed = false;						\
+  iter->end = (handle->len == 0);					\
+  return UTILS_OK;							\
+}									\
+									\
+static inline int							\
+name##_iter_init_tail(name##_t handle, name##_iter_t iter)		\
+{									\
+  if (handle == NULL || iter == NULL)					\
+    return UTILS_ERROR;							\
+  iter->list = handle;							\
+  iter->cursor = (handle->base != NULL) ? handle->base->prev : NULL;	\
+  iter->removed = false;						\
+  iter->end = (handle->len == 0);					\
+  return UTILS_OK;							\
+}									\
+									\
+static inline bool							\
+name##_iter_end(name##_iter_t iter)					\
+{									\
+  return (iter == NULL || iter->end);					\
+}									\
+									\
+static inline type *							\
+name##_iter_data(name##_iter_t iter)					\
+{									\
+  if (iter == NULL || iter->end || iter->removed)			\
+    return NULL;							\
+  return &iter->cursor->data;						\
+}									\
+									\
+static inline int							\
+name##_iter_next(name##_iter_t iter)					\
+{									\
+  if (iter == NULL)							\
+    return UTILS_ERROR;							\
+  if (iter->removed) {							\
+    /* the iterator already refers to the value after the removed one */ \
+    iter->removed = false;						\
+    if (iter->cursor == NULL)						\
+      iter->end = true;							\
+    return UTILS_OK;							\
+  }									\
+  if (iter->cursor == NULL)						\
+    return UTILS_ERROR;							\
+  if (iter->end)							\
+    return UTILS_OK;							\
+  if (iter->cursor->next == iter->list->base)				\
+    iter->end = true;							\
+  else									\
+    iter->cursor = iter->cursor->next;					\
+  return UTILS_OK;							\
+}									\
+									\
+static inline int							\
+name##_iter_prev(name##_iter_t iter)					\
+{									\
+  if (iter == NULL)							\
+    return UTILS_ERROR;							\
+  if (iter->removed) {							\
+    /* step back from the value after the removed one, the end */	\
+    /* of the list if the removed value was the last */			\
+    iter->removed = false;						\
+    if (iter->list->len == 0) {						\
+      iter->end = true;							\
+      return UTILS_OK;							\
+    }									\
+    if (iter->cursor == NULL) {						\
+      iter->cursor = iter->list->base->prev;				\
+      return UTILS_OK;							\
+    }									\
+  }									\
+  if (iter->cursor == NULL)						\
+    return UTILS_ERROR;							\
+  if (iter->end)							\
+    return UTILS_OK;							\
+  if (iter->cursor == iter->list->base)					\
+    iter->end = true;							\
+  else									\
+    iter->cursor = iter->cursor->prev;					\
+  return UTILS_OK;							\
+}									\
+									\
+static inline int							\
+name##_iter_seek(name##_iter_t iter, int index)				\
+{									\
+  if (iter == NULL)							\
+    return UTILS_ERROR;							\
+  if (index < 0 || (size_t)index >= iter->list->len) {			\
+    if (iter->list->len > 0)						\
+      iter->end = true;							\
+    return UTILS_ERROR;							\
+  }									\
+  iter->cursor = name##_item_find(iter->list, index);			\
+  iter->removed = false;						\
+  iter->end = false;							\
+  return UTILS_OK;							\
+}									\
+									\
+/* unlink the current item of the iterator, see list_iter_remove */	\
+static inline struct name##_item *					\
+name##_iter_take(name##_iter_t iter)					\
+{									\
+  struct name##_item *item = iter->cursor;				\
+									\
+  if (item->next == iter->list->base)					\
+    iter->cursor = NULL;						\
+  else									\
+    iter->cursor = item->next;						\
+  name##_item_unlink(iter->list, item);					\
+  iter->removed = true;							\
+  return item;								\
+}									\
+									\
+static inline int							\
+name##_iter_remove(name##_iter_t iter, type *data)			\
+{									\
+  struct name##_item *item;						\
+									\
+  if (iter == NULL || iter->end || iter->removed || data == NULL)	\
+    return UTILS_ERROR;							\
+  item = name##_iter_take(iter);					\
+  *data = item->data;							\
+  free(item);								\
+  return UTILS_OK;							\
+}									\
+									\
+static inline int							\
+name##_iter_delete(name##_iter_t iter)					\
+{									\
+  struct name##_item *item;						\
+									\
+  if (iter == NULL || iter->end || iter->removed)			\
+    return UTILS_ERROR;							\
+  item = name##_iter_take(iter);					\
+  dtor(&item->data);							\
+  free(item);								\
+  return UTILS_OK;							\
+}
+
+#endif /* UTILS_LIST_TYPED_H */
@@ -0,0 +1,65 @@
+/**
+ * @file
+ * Lock-free multi-producer multi-consumer FIFO queue.
+ * Any number of threads can push and pop concurrently without
+ * locking, unlinked nodes are reclaimed with hazard pointers.
+ * Data items have the same semantics as the list_push/list_pop
+ * data pointers, see list.h.
+ */
+
+#ifndef UTILS_QUEUE_H
+#define UTILS_QUEUE_H
+
+#include "libutils/list.h"
+
+/**
+ * Opaque queue handle
+ */
+struct queue_handle;
+typedef struct queue_handle * queue_t;
+
+/* queue setup API functions */
+
+/**
+ * initialise queue handle with an optional per-item destructor.
+ * @param[in]: handle pointer to a queue handle
+ * @param[in]: dtor item destructor callback, called on destroy for
+ *   the items left in the queue
+ * @return: utils error code
+ */
+int queue_init(queue_t *handle, list_dtor_t dtor);
+
+/**
+ * Deallocate queue, the destructor is called for each item.
+ * The queue must not be in use by other threads.
+ * @param[in]: handle queue handle
+ * @return: utils error code
+ */
+int queue_destroy(queue_t handle);
+
+/* queue data API functions, safe to call from any thread */
+
+/**
+ * Get the number of items in the queue, the value is only a
+ * snapshot while other threads are using the queue.
+ * @param[in] handle: queue handle
+ * @return: length of the queue or negative error value
+ */
+int queue_length(queue_t handle);
+
+/**
+ * Push data at the tail of the queue
+ * @param[in] handle: queue handle
+ * @param[in] data: the data to push
+ * @return: utils error code
+ */
+int queue_push(queue_t handle, void *data);
+
+/**
+ * Pop data from the head of the queue
+ * @param[in] handle: queue handle
+ * @return: data pointer or NULL if the queue is empty
+ */
+void * queue_pop(queue_t handle);
+
+#endif /* UTILS_QUEUE_H */
@@ -0,0 +1,204 @@
+/**
+ * @file
+ * Growable contiguous vector.
+ * The vector stores data pointers in a contiguous array, items
+ * are constructed and destructed with the same callbacks used by
+ * the generic list, see list.h.
+ */
+
+#ifndef UTILS_VEC_H
+#define UTILS_VEC_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "libutils/list.h"
+
+/**
+ * Opaque vector handle
+ */
+struct vec_handle;
+typedef struct vec_handle * vec_t;
+
+/**
+ * Opaque vector iterator structure, see vec_iter_init
+ */
+struct vec_iterator {
+  struct vec_handle *vec;
+  size_t index;
+};
+typedef struct vec_iterator vec_iter_struct_t;
+typedef struct vec_iterator * vec_iter_t;
+
+/* vector setup API functions */
+
+/**
+ * initialise vector handle with per-item constructor and
+ * destructor.
+ * @param[in]: handle pointer to a vector handle
+ * @param[in]: ctor item constructor callback
+ * @param[in]: dtor item destructor callback
+ * @return: utils error code
+ */
+int vec_init(vec_t *handle, list_ctor_t ctor, list_dtor_t dtor);
+
+/**
+ * Deallocate vector, the destructor is called for each item.
+ * @param[in]: handle vector handle
+ * @return: utils error code
+ */
+int vec_destroy(vec_t handle);
+
+/**
+ * Make sure that the vector can hold at least the given number of
+ * items without reallocating.
+ * @param[in] handle: vector handle
+ * @param[in] capacity: the number of items to reserve
+ * @return: utils error code
+ */
+int vec_reserve(vec_t handle, size_t capacity);
+
+/**
+ * Release the storage that is not used by the vector items.
+ * @param[in] handle: vector handle
+ * @return: utils error code
+ */
+int vec_shrink(vec_t handle);
+
+/**
+ * Get the number of items the vector can hold without reallocating.
+ * @param[in] handle: vector handle
+ * @return: vector capacity or negative error value
+ */
+int vec_capacity(vec_t handle);
+
+/* vector data API functions */
+
+/**
+ * Get length of the vector
+ * @param[in] handle: vector handle
+ * @return: length of the vector or negative error value
+ */
+int vec_length(vec_t handle);
+
+/**
+ * Append element to the end of the vector in amortized O(1) time
+ * @param[in] handle: vector handle
+ * @param[in] data: the data to append
+ * @return: utils error code
+ */
+int vec_append(vec_t handle, void *data);
+
+/**
+ * Push element at the head of the vector, the other items
+ * are moved in O(n) time
+ * @param[in] handle: vector handle
+ * @param[in] data: the data to push
+ * @return: utils error code
+ */
+int vec_push(vec_t handle, void *data);
+
+/**
+ * Insert generic item to the vector at given position, the vector is
+ * extended until the requested position is reached as in list_insert.
+ * @param[in,out] handle: vector handle
+ * @param[in] data: data pointer to insert
+ * @param[in] position: index in the vector where data is inserted
+ * @return: utils error code
+ */
+int vec_insert(vec_t handle, void *data, int position);
+
+/**
+ * Remove generic item from the vector at given position
+ * @param[in,out] handle: vector handle
+ * @param[in] position: index in the vector from which data is removed
+ * @return: data at given position or NULL
+ */
+void * vec_remove(vec_t handle, int position);
+
+/**
+ * Remove the first item of the vector as list_pop, the other items
+ * are moved in O(n) time. The last item is removed in O(1) time
+ * with vec_remove.
+ * @param[in,out] handle: vector handle
+ * @return: data pointer or NULL
+ */
+void * vec_pop(vec_t handle);
+
+/**
+ * Get generic item from the vector at given position in O(1) time
+ * @param[in] handle: vector handle
+ * @param[in] position: index in the vector from which data is taken
+ * @return: data at given position or NULL
+ */
+void * vec_get(vec_t handle, int position);
+
+/**
+ * Get index of an element in the vector
+ * @param[in] handle: vector handle
+ * @param[in] data: data object to search
+ * @return: the item index or negative value if the item is not found
+ */
+int vec_indexof(vec_t handle, void *data);
+
+/**
+ * Remove and deallocate generic item from the vector at given position
+ * @param[in,out] handle: vector handle
+ * @param[in] position: index in the vector from which data is removed
+ * @return: utils error code
+ */
+int vec_delete(vec_t handle, int position);
+
+/**
+ * Get the vector storage, the array is valid until the vector
+ * is modified.
+ * @param[in] handle: vector handle
+ * @return: array of vec_length data pointers or NULL
+ */
+void ** vec_data(vec_t handle);
+
+/**
+ * Walk vector executing given callback, if the callback returns
+ * UTILS_ITER_STOP the iteration stops and no error is returned,
+ * if the callback returns an error code the iteration stops
+ * and the error is propagated.
+ * @param[in] handle: vector handle to iterate
+ * @param[in] cbk: callback to be run for each item
+ * @param[in,out] args: extra arguments given to the callback
+ * @return: utils error code
+ */
+int vec_walk(vec_t handle, list_cbk_t cbk, void *args);
+
+/* vector iterator API functions */
+
+/**
+ * Initialize an iterator struct at the head of the vector.
+ * The iterator is valid until the vector is modified.
+ * @param[in] handle: the vector to iterate
+ * @param[in,out] iter: iterator handle
+ * @return: zero on success, error value on failure
+ */
+int vec_iter_init(vec_t handle, vec_iter_t iter);
+
+/**
+ * Advance the iterator.
+ * @param[in] iter: the iterator handle
+ * @return: zero on success, negative error value
+ */
+int vec_iter_next(vec_iter_t iter);
+
+/**
+ * Get the current data object from the iterator
+ * @param[in] iter: iterator handle
+ * @return: data pointer or NULL
+ */
+void * vec_iter_data(vec_iter_t iter);
+
+/**
+ * Check if the iterator has reached the end
+ * @param[in] iter: iterator handle
+ * @return: bool, true if the iterator has finished
+ */
+bool vec_iter_end(vec_iter_t iter);
+
+#endif /* UTILS_VEC_H */
@@ -0,0 +1,709 @@
+/**
+ * @file
+ * Ordered map implementation.
+ * The map is a B+ tree: the items live in the leaves, which are
+ * chained in key order, and the inner nodes only hold separator keys.
+ * The separator between two children is always the lowest key of the
+ * right child subtree, so that separators are keys still in the map
+ * and can be compared safely although keys are not copied.
+ * See btree.h for API specification
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "libutils/error.h"
+#include "libutils/btree.h"
+
+#define ASSERT_HANDLE_VALID(hnd) if (hnd == NULL) return UTILS_ERROR
+#define ASSERT_HANDLE_VALID_PTR(hnd) if (hnd == NULL) return NULL
+
+/* maximum number of keys in a node, must be even */
+#define BTREE_MAX 32
+/* minimum number of keys in a node other than the root */
+#define BTREE_MIN (BTREE_MAX / 2)
+/* maximum height of a tree, more than enough for SIZE_MAX items */
+#define BTREE_MAX_HEIGHT 24
+
+/**
+ * B+ tree node, the arrays have a spare slot so that
+ * a node can overflow before it is split.
+ */
+struct btree_node {
+  int count;
+  bool leaf;
+  const void *keys[BTREE_MAX + 1];
+  union {
+    /* leaves */
+    void *data[BTREE_MAX + 1];
+    /* inner nodes, count + 1 children */
+    struct btree_node *child[BTREE_MAX + 2];
+  };
+  /* next leaf in key order */
+  struct btree_node *next;
+};
+
+/**
+ * nodes allocated before an insertion for the splits it causes
+ */
+struct btree_spare {
+  struct btree_node *nodes[BTREE_MAX_HEIGHT + 1];
+  int count;
+};
+
+/**
+ * ordered map internal representation
+ */
+struct btree_handle {
+  struct btree_node *root;
+  size_t len;
+  list_cmp_t cmp;
+  list_ctor_t ctor;
+  list_dtor_t dtor;
+};
+
+static int
+btree_cmp(struct btree_handle *handle, const void *a, const void *b)
+{
+  return handle->cmp((void *)a, (void *)b);
+}
+
+/**
+ * Index of the first key of a node greater than or equal to the key
+ */
+static int
+btree_lower(struct btree_handle *handle, struct btree_node *node,
+	    const void *key)
+{
+  int low = 0, high = node->count, mid;
+
+  while (low < high) {
+    mid = (low + high) / 2;
+    if (btree_cmp(handle, node->keys[mid], key) < 0)
+      low = mid + 1;
+    else
+      high = mid;
+  }
+  return low;
+}
+
+/**
+ * Index of the first key of a node greater than the key,
+ * which is also the index of the child holding the key.
+ */
+static int
+btree_upper(struct btree_handle *handle, struct btree_node *node,
+	    const void *key)
+{
+  int low = 0, high = node->count, mid;
+
+  while (low < high) {
+    mid = (low + high) / 2;
+    if (btree_cmp(handle, node->keys[mid], key) <= 0)
+      low = mid + 1;
+    else
+      high = mid;
+  }
+  return low;
+}
+
+static struct btree_node *
+btree_node_new(bool leaf)
+{
+  struct btree_node *node;
+
+  node = malloc(sizeof(struct btree_node));
+  if (node == NULL)
+    return NULL;
+  node->count = 0;
+  node->leaf = leaf;
+  node->next = NULL;
+  return node;
+}
+
+/**
+ * Find the leaf that holds or would hold a key
+ */
+static struct btree_node *
+btree_leaf(struct btree_handle *handle, const void *key)
+{
+  struct btree_node *node = handle->root;
+
+  while (!node->leaf)
+    node = node->child[btree_upper(handle, node, key)];
+  return node;
+}
+
+/**
+ * Allocate the nodes an insertion needs for its splits before the
+ * tree is modified, so that the insertion can not fail midway.
+ *
+ * @param[out] spare: the allocated nodes
+ * @param[in] count: the number of nodes
+ * @return: utils error code
+ */
+static int
+btree_spare_alloc(struct btree_spare *spare, int count)
+{
+  if (count > BTREE_MAX_HEIGHT + 1)
+    return UTILS_ERROR;
+  for (spare->count = 0; spare->count < count; spare->count++) {
+    spare->nodes[spare->count] = btree_node_new(false);
+    if (spare->nodes[spare->count] == NULL) {
+      while (spare->count > 0)
+	free(spare->nodes[--spare->count]);
+      return UTILS_ERROR;
+    }
+  }
+  return UTILS_OK;
+}
+
+/**
+ * Split an overflowing node, the upper half is moved to a new
+ * right sibling.
+ *
+ * @param[in] node: the node holding BTREE_MAX + 1 keys
+ * @param[in] right: the empty node becoming the right sibling
+ * @param[out] sep: the separator of the new sibling
+ */
+static void
+btree_split(struct btree_node *node, struct btree_node *right,
+	    const void **sep)
+{
+  int mid = node->count / 2;
+
+  right->leaf = node->leaf;
+  if (node->leaf) {
+    /* the lowest key of the right leaf is copied up */
+    right->count = node->count - mid;
+    memcpy(right->keys, &node->keys[mid], right->count * sizeof(void *));
+    memcpy(right->data, &node->data[mid], right->count * sizeof(void *));
+    right->next = node->next;
+    node->next = right;
+    *sep = right->keys[0];
+  }
+  else {
+    /* the middle separator is moved up */
+    right->count = node->count - mid - 1;
+    memcpy(right->keys, &node->keys[mid + 1], right->count * sizeof(void *));
+    memcpy(right->child, &node->child[mid + 1],
+	   (right->count + 1) * sizeof(void *));
+    *sep = node->keys[mid];
+  }
+  node->count = mid;
+}
+
+/**
+ * Insert an item in a subtree, a node that overflows is split
+ * and the new sibling is returned to the parent.
+ *
+ * @param[in] handle: the ordered map handle
+ * @param[in] node: the subtree root
+ * @param[in] key: the item key
+ * @param[in] data: the data given to the constructor
+ * @param[in] full: the number of full nodes right above the subtree
+ * root, which split if the subtree root splits
+ * @param[in] depth: the depth of the subtree root
+ * @param[in,out] spare: the nodes allocated for the splits
+ * @param[out] sep: the separator of the new sibling
+ * @param[out] right: the new sibling, NULL if the node was not split
+ * @return: utils error code, error if the key is already in the map
+ */
+static int
+btree_node_insert(struct btree_handle *handle, struct btree_node *node,
+		  const void *key, void *data, int full, int depth,
+		  struct btree_spare *spare, const void **sep,
+		  struct btree_node **right)
+{
+  struct btree_node *child_right;
+  const void *child_sep;
+  int i, err;
+
+  *right = NULL;
+  if (node->leaf) {
+    i = btree_lower(handle, node, key);
+    if (i < node->count && btree_cmp(handle, node->keys[i], key) == 0)
+      return UTILS_ERROR;
+    /* the leaf and the full nodes above it split, with the
+     * root a new root is needed */
+    if (node->count == BTREE_MAX &&
+	btree_spare_alloc(spare, full + 1 + (full == depth)))
+      return UTILS_ERROR;
+    memmove(&node->keys[i + 1], &node->keys[i],
+	    (node->count - i) * sizeof(void *));
+    memmove(&node->data[i + 1], &node->data[i],
+	    (node->count - i) * sizeof(void *));
+    node->keys[i] = key;
+    if (handle->ctor != NULL)
+      handle->ctor(&node->data[i], data);
+    else
+      node->data[i] = data;
+    node->count++;
+  }
+  else {
+    i = btree_upper(handle, node, key);
+    err = btree_node_insert(handle, node->child[i], key, data,
+			    (node->count == BTREE_MAX) ? full + 1 : 0,
+			    depth + 1, spare, &child_sep, &child_right);
+    if (err || child_right == NULL)
+      return err;
+    memmove(&node->keys[i + 1], &node->keys[i],
+	    (node->count - i) * sizeof(void *));
+    memmove(&node->child[i + 2], &node->child[i + 1],
+	    (node->count - i) * sizeof(void *));
+    node->keys[i] = child_sep;
+    node->child[i + 1] = child_right;
+    node->count++;
+  }
+
+  if (node->count > BTREE_MAX) {
+    *right = spare->nodes[--spare->count];
+    btree_split(node, *right, sep);
+  }
+  return UTILS_OK;
+}
+
+/**
+ * Move the last item of the left sibling of a child to the child
+ */
+static void
+btree_borrow_left(struct btree_node *parent, int i)
+{
+  struct btree_node *child = parent->child[i];
+  struct btree_node *left = parent->child[i - 1];
+
+  memmove(&child->keys[1], &child->keys[0], child->count * sizeof(void *));
+  if (child->leaf) {
+    memmove(&child->data[1], &child->data[0], child->count * sizeof(void *));
+    child->keys[0] = left->keys[left->count - 1];
+    child->data[0] = left->data[left->count - 1];
+    parent->keys[i - 1] = child->keys[0];
+  }
+  else {
+    memmove(&child->child[1], &child->child[0],
+	    (child->count + 1) * sizeof(void *));
+    child->keys[0] = parent->keys[i - 1];
+    child->child[0] = left->child[left->count];
+    parent->keys[i - 1] = left->keys[left->count - 1];
+  }
+  child->count++;
+  left->count--;
+}
+
+/**
+ * Move the first item of the right sibling of a child to the child
+ */
+static void
+btree_borrow_right(struct btree_node *parent, int i)
+{
+  struct btree_node *child = parent->child[i];
+  struct btree_node *right = parent->child[i + 1];
+
+  if (child->leaf) {
+    child->keys[child->count] = right->keys[0];
+    child->data[child->count] = right->data[0];
+    memmove(&right->data[0], &right->data[1],
+	    (right->count - 1) * sizeof(void *));
+  }
+  else {
+    child->keys[child->count] = parent->keys[i];
+    child->child[child->count + 1] = right->child[0];
+    memmove(&right->child[0], &right->child[1],
+	    right->count * sizeof(void *));
+  }
+  parent->keys[i] = (child->leaf) ? right->keys[1] : right->keys[0];
+  memmove(&right->keys[0], &right->keys[1],
+	  (right->count - 1) * sizeof(void *));
+  child->count++;
+  right->count--;
+}
+
+/**
+ * Merge a child with its right sibling
+ */
+static void
+btree_merge(struct btree_node *parent, int i)
+{
+  struct btree_node *left = parent->child[i];
+  struct btree_node *right = parent->child[i + 1];
+
+  if (left->leaf) {
+    memcpy(&left->keys[left->count], right->keys,
+	   right->count * sizeof(void *));
+    memcpy(&left->data[left->count], right->data,
+	   right->count * sizeof(void *));
+    left->count += right->count;
+    left->next = right->next;
+  }
+  else {
+    /* the separator moves down between the two halves */
+    left->keys[left->count] = parent->keys[i];
+    memcpy(&left->keys[left->count + 1], right->keys,
+	   right->count * sizeof(void *));
+    memcpy(&left->child[left->count + 1], right->child,
+	   (right->count + 1) * sizeof(void *));
+    left->count += right->count + 1;
+  }
+  free(right);
+
+  memmove(&parent->keys[i], &parent->keys[i + 1],
+	  (parent->count - i - 1) * sizeof(void *));
+  memmove(&parent->child[i + 1], &parent->child[i + 2],
+	  (parent->count - i - 1) * sizeof(void *));
+  parent->count--;
+}
+
+/**
+ * Refill a child that went under the minimum size
+ */
+static void
+btree_rebalance(struct btree_node *parent, int i)
+{
+  if (i > 0 && parent->child[i - 1]->count > BTREE_MIN)
+    btree_borrow_left(parent, i);
+  else if (i < parent->count && parent->child[i + 1]->count > BTREE_MIN)
+    btree_borrow_right(parent, i);
+  else if (i > 0)
+    btree_merge(parent, i - 1);
+  else
+    btree_merge(parent, i);
+}
+
+/**
+ * Remove an item from a subtree
+ *
+ * @param[in] handle: the ordered map handle
+ * @param[in] node: the subtree root
+ * @param[in] key: the item key
+ * @param[in] sep: the separator equal to the key in an ancestor or NULL
+ * @param[out] data: the data of the removed item
+ * @return: utils error code, error if the key is not in the map
+ */
+static int
+btree_node_remove(struct btree_handle *handle, struct btree_node *node,
+		  const void *key, const void **sep, void **data)
+{
+  int i, err;
+
+  if (node->leaf) {
+    i = btree_lower(handle, node, key);
+    if (i == node->count || btree_cmp(handle, node->keys[i], key) != 0)
+      return UTILS_ERROR;
+    *data = node->data[i];
+    memmove(&node->keys[i], &node->keys[i + 1],
+	    (node->count - i - 1) * sizeof(void *));
+    memmove(&node->data[i], &node->data[i + 1],
+	    (node->count - i - 1) * sizeof(void *));
+    node->count--;
+    /* the key was the lowest of the subtree right of the separator,
+     * a leaf other than the root is never empty here */
+    if (sep != NULL)
+      *sep = node->keys[0];
+    return UTILS_OK;
+  }
+
+  i = btree_upper(handle, node, key);
+  if (i > 0 && btree_cmp(handle, node->keys[i - 1], key) == 0)
+    sep = &node->keys[i - 1];
+  err = btree_node_remove(handle, node->child[i], key, sep, data);
+  if (err)
+    return err;
+  if (node->child[i]->count < BTREE_MIN)
+    btree_rebalance(node, i);
+  return UTILS_OK;
+}
+
+/**
+ * Remove an item and shrink the tree if the root is empty
+ */
+static int
+btree_erase(struct btree_handle *handle, const void *key, void **data)
+{
+  struct btree_node *root = handle->root;
+
+  if (root == NULL)
+    return UTILS_ERROR;
+  if (btree_node_remove(handle, root, key, NULL, data))
+    return UTILS_ERROR;
+  handle->len--;
+
+  if (root->count == 0) {
+    handle->root = (root->leaf) ? NULL : root->child[0];
+    free(root);
+  }
+  return UTILS_OK;
+}
+
+/**
+ * Deallocate a subtree, the destructor is called for each item.
+ */
+static void
+btree_node_destroy(struct btree_handle *handle, struct btree_node *node)
+{
+  int i;
+
+  if (node->leaf) {
+    if (handle->dtor != NULL)
+      for (i = 0; i < node->count; i++)
+	handle->dtor(node->data[i]);
+  }
+  else {
+    for (i = 0; i <= node->count; i++)
+      btree_node_destroy(handle, node->child[i]);
+  }
+  free(node);
+}
+
+/* ordered map setup API */
+
+int
+btree_init(btree_t *phandle, list_cmp_t cmp, list_ctor_t ctor,
+	   list_dtor_t dtor)
+{
+  btree_t handle;
+
+  if (phandle == NULL || cmp == NULL)
+    return UTILS_ERROR;
+  *phandle = malloc(sizeof(struct btree_handle));
+  if (*phandle == NULL)
+    return UTILS_ERROR;
+  handle = *phandle;
+  handle->root = NULL;
+  handle->len = 0;
+  handle->cmp = cmp;
+  handle->ctor = ctor;
+  handle->dtor = dtor;
+  return UTILS_OK;
+}
+
+int
+btree_destroy(btree_t handle)
+{
+  ASSERT_HANDLE_VALID(handle);
+
+  if (handle->root != NULL)
+    btree_node_destroy(handle, handle->root);
+  free(handle);
+  return UTILS_OK;
+}
+
+/* ordered map data API */
+
+int
+btree_length(btree_t handle)
+{
+  if (handle == NULL)
+    return -UTILS_ERROR;
+  return handle->len;
+}
+
+int
+btree_insert(btree_t handle, const void *key, void *data)
+{
+  struct btree_node *right, *root;
+  struct btree_spare spare;
+  const void *sep;
+
+  ASSERT_HANDLE_VALID(handle);
+
+  if (handle->root == NULL) {
+    handle->root = btree_node_new(true);
+    if (handle->root == NULL)
+      return UTILS_ERROR;
+  }
+  spare.count = 0;
+  if (btree_node_insert(handle, handle->root, key, data, 0, 0, &spare,
+			&sep, &right))
+    return UTILS_ERROR;
+  handle->len++;
+
+  if (right != NULL) {
+    /* the root was split, grow the tree by one level */
+    root = spare.nodes[--spare.count];
+    root->count = 1;
+    root->keys[0] = sep;
+    root->child[0] = handle->root;
+    root->child[1] = right;
+    handle->root = root;
+  }
+  return UTILS_OK;
+}
+
+void *
+btree_find(btree_t handle, const void *key)
+{
+  struct btree_node *leaf;
+  int i;
+
+  ASSERT_HANDLE_VALID_PTR(handle);
+  if (handle->root == NULL)
+    return NULL;
+
+  leaf = btree_leaf(handle, key);
+  i = btree_lower(handle, leaf, key);
+  if (i == leaf->count || btree_cmp(handle, leaf->keys[i], key) != 0)
+    return NULL;
+  return leaf->data[i];
+}
+
+bool
+btree_contains(btree_t handle, const void *key)
+{
+  struct btree_node *leaf;
+  int i;
+
+  if (handle == NULL || handle->root == NULL)
+    return false;
+
+  leaf = btree_leaf(handle, key);
+  i = btree_lower(handle, leaf, key);
+  return i < leaf->count && btree_cmp(handle, leaf->keys[i], key) == 0;
+}
+
+void *
+btree_remove(btree_t handle, const void *key)
+{
+  void *data;
+
+  ASSERT_HANDLE_VALID_PTR(handle);
+
+  if (btree_erase(handle, key, &data))
+    return NULL;
+  return data;
+}
+
+int
+btree_delete(btree_t handle, const void *key)
+{
+  void *data;
+
+  ASSERT_HANDLE_VALID(handle);
+
+  if (btree_erase(handle, key, &data))
+    return UTILS_ERROR;
+  if (handle->dtor != NULL)
+    handle->dtor(data);
+  return UTILS_OK;
+}
+
+int
+btree_walk(btree_t handle, list_cbk_t cbk, void *args)
+{
+  return btree_walk_range(handle, NULL, NULL, cbk, args);
+}
+
+int
+btree_walk_range(btree_t handle, const void *from, const void *to,
+		 list_cbk_t cbk, void *args)
+{
+  btree_iter_struct_t iter = {NULL, 0, true};
+  int err;
+
+  ASSERT_HANDLE_VALID(handle);
+  if (cbk == NULL)
+    return UTILS_ERROR;
+
+  if (from != NULL)
+    btree_lower_bound(handle, from, &iter);
+  else
+    btree_iter_init(handle, &iter);
+  for (; !iter.end; btree_iter_next(&iter)) {
+    if (to != NULL &&
+	btree_cmp(handle, iter.node->keys[iter.slot], to) >= 0)
+      break;
+    err = cbk(iter.node->data[iter.slot], args);
+    if (err == UTILS_ITER_STOP)
+      break;
+    if (err != UTILS_OK)
+      return UTILS_ERROR;
+  }
+  return UTILS_OK;
+}
+
+/* ordered map iterator API */
+
+int
+btree_iter_init(btree_t handle, btree_iter_t iter)
+{
+  struct btree_node *node;
+
+  ASSERT_HANDLE_VALID(handle);
+  if (iter == NULL)
+    return UTILS_ERROR;
+
+  node = handle->root;
+  while (node != NULL && !node->leaf)
+    node = node->child[0];
+  iter->node = node;
+  iter->slot = 0;
+  iter->end = (node == NULL);
+  return UTILS_OK;
+}
+
+int
+btree_lower_bound(btree_t handle, const void *key, btree_iter_t iter)
+{
+  struct btree_node *leaf;
+  int i;
+
+  ASSERT_HANDLE_VALID(handle);
+  if (iter == NULL)
+    return UTILS_ERROR;
+
+  iter->end = true;
+  if (handle->root == NULL)
+    return UTILS_OK;
+
+  leaf = btree_leaf(handle, key);
+  i = btree_lower(handle, leaf, key);
+  /* all the keys of the leaf are lower, the bound is the
+   * first key of the next leaf */
+  if (i == leaf->count) {
+    leaf = leaf->next;
+    i = 0;
+  }
+  iter->node = leaf;
+  iter->slot = i;
+  iter->end = (leaf == NULL);
+  return UTILS_OK;
+}
+
+int
+btree_iter_next(btree_iter_t iter)
+{
+  if (iter == NULL)
+    return UTILS_ERROR;
+  if (iter->end)
+    return UTILS_OK;
+
+  if (++iter->slot == iter->node->count) {
+    iter->node = iter->node->next;
+    iter->slot = 0;
+    iter->end = (iter->node == NULL);
+  }
+  return UTILS_OK;
+}
+
+bool
+btree_iter_end(btree_iter_t iter)
+{
+  if (iter == NULL)
+    return true;
+  return iter->end;
+}
+
+const void *
+btree_iter_key(btree_iter_t iter)
+{
+  if (iter == NULL || iter->end)
+    return NULL;
+  return iter->node->keys[iter->slot];
+}
+
+void *
+btree_iter_data(btree_iter_t iter)
+{
+  if (iter == NULL || iter->end)
+    return NULL;
+  return iter->node->data[iter->slot];
+}
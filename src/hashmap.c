@@ -0,0 +1,455 @@
+/**
+ * @file
+ * Open addressing hash map implementation.
+ * The table uses linear probing with Robin Hood displacement: an
+ * entry being inserted takes the slot of any entry that is closer
+ * to its home slot, keeping the probe sequences short and allowing
+ * lookups to stop early. Removal shifts the following entries back
+ * instead of leaving tombstones.
+ * See hashmap.h for API specification
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "libutils/error.h"
+#include "libutils/hashmap.h"
+
+#define ASSERT_HANDLE_VALID(hnd) if (hnd == NULL) return UTILS_ERROR
+#define ASSERT_HANDLE_VALID_PTR(hnd) if (hnd == NULL) return NULL
+
+/* capacity of the first table allocation */
+#define HASHMAP_MIN_CAPACITY 8
+
+/* maximum load factor, as a fraction of the capacity */
+#define HASHMAP_LOAD_NUM 7
+#define HASHMAP_LOAD_DEN 8
+
+/**
+ * hash map entry, the hash is zero for free entries
+ */
+struct hashmap_entry {
+  size_t hash;
+  const void *key;
+  void *data;
+};
+
+/**
+ * hash map internal representation
+ */
+struct hashmap_handle {
+  struct hashmap_entry *entries;
+  size_t capacity;
+  size_t len;
+  int key_type;
+  list_ctor_t ctor;
+  list_dtor_t dtor;
+};
+
+/**
+ * Hash a key, the result is never zero.
+ * Strings use FNV-1a, pointers the splitmix64 finalizer so that
+ * the low bits used for the home slot depend on the whole address.
+ */
+static size_t
+hashmap_hash(struct hashmap_handle *handle, const void *key)
+{
+  const unsigned char *str;
+  uint64_t hash;
+
+  if (handle->key_type == HASHMAP_KEY_STRING) {
+    hash = 0xcbf29ce484222325ULL;
+    for (str = key; *str != '\0'; str++) {
+      hash ^= *str;
+      hash *= 0x100000001b3ULL;
+    }
+  }
+  else {
+    hash = (uintptr_t)key;
+    hash ^= hash >> 30;
+    hash *= 0xbf58476d1ce4e5b9ULL;
+    hash ^= hash >> 27;
+    hash *= 0x94d049bb133111ebULL;
+    hash ^= hash >> 31;
+  }
+  return ((size_t)hash == 0) ? 1 : (size_t)hash;
+}
+
+static bool
+hashmap_equal(struct hashmap_handle *handle, const void *a, const void *b)
+{
+  if (handle->key_type == HASHMAP_KEY_STRING)
+    return a == b || strcmp(a, b) == 0;
+  return a == b;
+}
+
+/**
+ * Distance of an entry from its home slot
+ */
+static size_t
+hashmap_distance(struct hashmap_handle *handle, size_t hash, size_t slot)
+{
+  return (slot - hash) & (handle->capacity - 1);
+}
+
+/**
+ * Find the entry of a key
+ *
+ * @param[in] handle: the hash map handle
+ * @param[in] key: the key to look for
+ * @param[in] hash: the key hash
+ * @return: the entry or NULL
+ */
+static struct hashmap_entry *
+hashmap_lookup(struct hashmap_handle *handle, const void *key, size_t hash)
+{
+  struct hashmap_entry *entry;
+  size_t slot, dist;
+
+  if (handle->len == 0)
+    return NULL;
+
+  slot = hash & (handle->capacity - 1);
+  for (dist = 0; ; dist++) {
+    entry = &handle->entries[slot];
+    /* a richer entry means that the key would have displaced it */
+    if (entry->hash == 0 ||
+	hashmap_distance(handle, entry->hash, slot) < dist)
+      return NULL;
+    if (entry->hash == hash && hashmap_equal(handle, entry->key, key))
+      return entry;
+    slot = (slot + 1) & (handle->capacity - 1);
+  }
+}
+
+/**
+ * Store an entry whose key is not in the table, the table
+ * must have a free slot.
+ */
+static void
+hashmap_place(struct hashmap_handle *handle, struct hashmap_entry new)
+{
+  struct hashmap_entry *entry, tmp;
+  size_t slot, dist, entry_dist;
+
+  slot = new.hash & (handle->capacity - 1);
+  for (dist = 0; ; dist++) {
+    entry = &handle->entries[slot];
+    if (entry->hash == 0) {
+      *entry = new;
+      return;
+    }
+    /* take the slot of entries closer to their home and carry on
+     * inserting the displaced entry */
+    entry_dist = hashmap_distance(handle, entry->hash, slot);
+    if (entry_dist < dist) {
+      tmp = *entry;
+      *entry = new;
+      new = tmp;
+      dist = entry_dist;
+    }
+    slot = (slot + 1) & (handle->capacity - 1);
+  }
+}
+
+/**
+ * Reallocate the table and move the entries
+ *
+ * @param[in] handle: the hash map handle
+ * @param[in] capacity: the new capacity, a power of two
+ * @return: utils error code
+ */
+static int
+hashmap_resize(struct hashmap_handle *handle, size_t capacity)
+{
+  struct hashmap_entry *old = handle->entries;
+  size_t old_capacity = handle->capacity;
+  size_t i;
+
+  handle->entries = calloc(capacity, sizeof(struct hashmap_entry));
+  if (handle->entries == NULL) {
+    handle->entries = old;
+    return UTILS_ERROR;
+  }
+  handle->capacity = capacity;
+  for (i = 0; i < old_capacity; i++)
+    if (old[i].hash != 0)
+      hashmap_place(handle, old[i]);
+  free(old);
+  return UTILS_OK;
+}
+
+/**
+ * Grow the table geometrically to hold the given number of items
+ */
+static int
+hashmap_grow(struct hashmap_handle *handle, size_t count)
+{
+  size_t capacity;
+
+  capacity = (handle->capacity == 0) ? HASHMAP_MIN_CAPACITY :
+    handle->capacity;
+  while (count * HASHMAP_LOAD_DEN > capacity * HASHMAP_LOAD_NUM)
+    capacity *= 2;
+  if (capacity == handle->capacity)
+    return UTILS_OK;
+  return hashmap_resize(handle, capacity);
+}
+
+/**
+ * Remove an entry, the following entries of the probe
+ * sequence are shifted back by one slot.
+ */
+static void
+hashmap_erase(struct hashmap_handle *handle, struct hashmap_entry *entry)
+{
+  struct hashmap_entry *next;
+  size_t slot;
+
+  slot = entry - handle->entries;
+  for (;;) {
+    next = &handle->entries[(slot + 1) & (handle->capacity - 1)];
+    if (next->hash == 0 ||
+	hashmap_distance(handle, next->hash, next - handle->entries) == 0)
+      break;
+    handle->entries[slot] = *next;
+    slot = next - handle->entries;
+  }
+  handle->entries[slot].hash = 0;
+  handle->len--;
+}
+
+/* hash map setup API */
+
+int
+hashmap_init(hashmap_t *phandle, int key_type, list_ctor_t ctor,
+	     list_dtor_t dtor)
+{
+  hashmap_t handle;
+
+  if (phandle == NULL)
+    return UTILS_ERROR;
+  if (key_type != HASHMAP_KEY_STRING && key_type != HASHMAP_KEY_POINTER)
+    return UTILS_ERROR;
+  *phandle = malloc(sizeof(struct hashmap_handle));
+  if (*phandle == NULL)
+    return UTILS_ERROR;
+  handle = *phandle;
+  handle->entries = NULL;
+  handle->capacity = 0;
+  handle->len = 0;
+  handle->key_type = key_type;
+  handle->ctor = ctor;
+  handle->dtor = dtor;
+  return UTILS_OK;
+}
+
+int
+hashmap_destroy(hashmap_t handle)
+{
+  size_t i;
+
+  ASSERT_HANDLE_VALID(handle);
+
+  if (handle->dtor != NULL)
+    for (i = 0; i < handle->capacity; i++)
+      if (handle->entries[i].hash != 0)
+	handle->dtor(handle->entries[i].data);
+  free(handle->entries);
+  free(handle);
+  return UTILS_OK;
+}
+
+int
+hashmap_reserve(hashmap_t handle, size_t count)
+{
+  ASSERT_HANDLE_VALID(handle);
+
+  return hashmap_grow(handle, count);
+}
+
+/* hash map data API */
+
+int
+hashmap_length(hashmap_t handle)
+{
+  if (handle == NULL)
+    return -UTILS_ERROR;
+  return handle->len;
+}
+
+int
+hashmap_insert(hashmap_t handle, const void *key, void *data)
+{
+  struct hashmap_entry new;
+
+  ASSERT_HANDLE_VALID(handle);
+  if (key == NULL && handle->key_type == HASHMAP_KEY_STRING)
+    return UTILS_ERROR;
+
+  new.hash = hashmap_hash(handle, key);
+  if (hashmap_lookup(handle, key, new.hash) != NULL)
+    return UTILS_ERROR;
+  if (hashmap_grow(handle, handle->len + 1))
+    return UTILS_ERROR;
+
+  new.key = key;
+  if (handle->ctor != NULL)
+    handle->ctor(&new.data, data);
+  else
+    new.data = data;
+  hashmap_place(handle, new);
+  handle->len++;
+  return UTILS_OK;
+}
+
+void *
+hashmap_get(hashmap_t handle, const void *key)
+{
+  struct hashmap_entry *entry;
+
+  ASSERT_HANDLE_VALID_PTR(handle);
+  if (key == NULL && handle->key_type == HASHMAP_KEY_STRING)
+    return NULL;
+
+  entry = hashmap_lookup(handle, key, hashmap_hash(handle, key));
+  if (entry == NULL)
+    return NULL;
+  return entry->data;
+}
+
+bool
+hashmap_contains(hashmap_t handle, const void *key)
+{
+  if (handle == NULL)
+    return false;
+  if (key == NULL && handle->key_type == HASHMAP_KEY_STRING)
+    return false;
+
+  return hashmap_lookup(handle, key, hashmap_hash(handle, key)) != NULL;
+}
+
+void *
+hashmap_remove(hashmap_t handle, const void *key)
+{
+  struct hashmap_entry *entry;
+  void *data;
+
+  ASSERT_HANDLE_VALID_PTR(handle);
+  if (key == NULL && handle->key_type == HASHMAP_KEY_STRING)
+    return NULL;
+
+  entry = hashmap_lookup(handle, key, hashmap_hash(handle, key));
+  if (entry == NULL)
+    return NULL;
+  data = entry->data;
+  hashmap_erase(handle, entry);
+  return data;
+}
+
+int
+hashmap_delete(hashmap_t handle, const void *key)
+{
+  struct hashmap_entry *entry;
+  void *data;
+
+  ASSERT_HANDLE_VALID(handle);
+  if (key == NULL && handle->key_type == HASHMAP_KEY_STRING)
+    return UTILS_ERROR;
+
+  entry = hashmap_lookup(handle, key, hashmap_hash(handle, key));
+  if (entry == NULL)
+    return UTILS_ERROR;
+  data = entry->data;
+  hashmap_erase(handle, entry);
+  if (handle->dtor != NULL)
+    handle->dtor(data);
+  return UTILS_OK;
+}
+
+int
+hashmap_walk(hashmap_t handle, list_cbk_t cbk, void *args)
+{
+  size_t i;
+  int err;
+
+  ASSERT_HANDLE_VALID(handle);
+  if (cbk == NULL)
+    return UTILS_ERROR;
+
+  for (i = 0; i < handle->capacity; i++) {
+    if (handle->entries[i].hash == 0)
+      continue;
+    err = cbk(handle->entries[i].data, args);
+    if (err == UTILS_ITER_STOP)
+      break;
+    if (err != UTILS_OK)
+      return UTILS_ERROR;
+  }
+  return UTILS_OK;
+}
+
+/* hash map iterator API */
+
+/**
+ * Move the iterator to the first used slot from the given one
+ */
+static void
+hashmap_iter_seek(hashmap_iter_t iter, size_t slot)
+{
+  struct hashmap_handle *handle = iter->map;
+
+  while (slot < handle->capacity && handle->entries[slot].hash == 0)
+    slot++;
+  iter->slot = slot;
+  iter->end = (slot == handle->capacity);
+}
+
+int
+hashmap_iter_init(hashmap_t handle, hashmap_iter_t iter)
+{
+  ASSERT_HANDLE_VALID(handle);
+  if (iter == NULL)
+    return UTILS_ERROR;
+
+  iter->map = handle;
+  hashmap_iter_seek(iter, 0);
+  return UTILS_OK;
+}
+
+int
+hashmap_iter_next(hashmap_iter_t iter)
+{
+  if (iter == NULL)
+    return UTILS_ERROR;
+  if (iter->end)
+    return UTILS_OK;
+
+  hashmap_iter_seek(iter, iter->slot + 1);
+  return UTILS_OK;
+}
+
+bool
+hashmap_iter_end(hashmap_iter_t iter)
+{
+  if (iter == NULL)
+    return true;
+  return iter->end;
+}
+
+const void *
+hashmap_iter_key(hashmap_iter_t iter)
+{
+  if (iter == NULL || iter->end)
+    return NULL;
+  return iter->map->entries[iter->slot].key;
+}
+
+void *
+hashmap_iter_data(hashmap_iter_t iter)
+{
+  if (iter == NULL || iter->end)
+    return NULL;
+  return iter->map->entries[iter->slot].data;
+}
@@ -0,0 +1,163 @@
+/**
+ * @file
+ * Hazard pointers implementation.
+ * See hazard.h for API specification
+ */
+
+#include <stdlib.h>
+
+#include "libutils/error.h"
+#include "hazard.h"
+
+void
+hazard_init(struct hazard_domain *domain, hazard_reclaim_t reclaim,
+	    void *args)
+{
+  atomic_init(&domain->records, NULL);
+  atomic_init(&domain->nrecords, 0);
+  domain->reclaim = reclaim;
+  domain->args = args;
+}
+
+void
+hazard_destroy(struct hazard_domain *domain)
+{
+  struct hazard_record *rec, *next;
+  size_t i;
+
+  rec = atomic_load(&domain->records);
+  while (rec != NULL) {
+    next = rec->next;
+    for (i = 0; i < rec->nretired; i++)
+      domain->reclaim(rec->retired[i], domain->args);
+    free(rec->retired);
+    free(rec);
+    rec = next;
+  }
+  atomic_store(&domain->records, NULL);
+  atomic_store(&domain->nrecords, 0);
+}
+
+struct hazard_record *
+hazard_acquire(struct hazard_domain *domain)
+{
+  struct hazard_record *rec, *head;
+  bool inactive;
+  int i;
+
+  /* reuse a released record */
+  for (rec = atomic_load(&domain->records); rec != NULL; rec = rec->next) {
+    inactive = false;
+    if (!atomic_load_explicit(&rec->active, memory_order_relaxed) &&
+	atomic_compare_exchange_strong(&rec->active, &inactive, true))
+      return rec;
+  }
+
+  /* publish a new record, records are only ever added at the head */
+  rec = malloc(sizeof(struct hazard_record));
+  if (rec == NULL)
+    return NULL;
+  for (i = 0; i < HAZARD_SLOTS; i++)
+    atomic_init(&rec->hp[i], NULL);
+  atomic_init(&rec->active, true);
+  rec->retired = NULL;
+  rec->nretired = 0;
+  rec->capacity = 0;
+  head = atomic_load(&domain->records);
+  do {
+    rec->next = head;
+  } while (!atomic_compare_exchange_weak(&domain->records, &head, rec));
+  atomic_fetch_add(&domain->nrecords, 1);
+  return rec;
+}
+
+void
+hazard_release(struct hazard_record *record)
+{
+  int i;
+
+  for (i = 0; i < HAZARD_SLOTS; i++)
+    atomic_store_explicit(&record->hp[i], NULL, memory_order_release);
+  atomic_store_explicit(&record->active, false, memory_order_release);
+}
+
+void *
+hazard_protect(struct hazard_record *record, int slot, _Atomic(void *) *src)
+{
+  void *ptr, *check;
+
+  ptr = atomic_load(src);
+  for (;;) {
+    atomic_store(&record->hp[slot], ptr);
+    check = atomic_load(src);
+    if (check == ptr)
+      return ptr;
+    ptr = check;
+  }
+}
+
+/**
+ * Check whether a pointer is protected by any hazard record
+ *
+ * @param[in] domain: the hazard domain
+ * @param[in] ptr: the pointer to look for
+ * @return: true if the pointer is protected
+ */
+static bool
+hazard_protected(struct hazard_domain *domain, void *ptr)
+{
+  struct hazard_record *rec;
+  int i;
+
+  for (rec = atomic_load(&domain->records); rec != NULL; rec = rec->next)
+    for (i = 0; i < HAZARD_SLOTS; i++)
+      if (atomic_load(&rec->hp[i]) == ptr)
+	return true;
+  return false;
+}
+
+void
+hazard_scan(struct hazard_domain *domain, struct hazard_record *record)
+{
+  size_t i, kept = 0;
+
+  for (i = 0; i < record->nretired; i++) {
+    if (hazard_protected(domain, record->retired[i]))
+      record->retired[kept++] = record->retired[i];
+    else
+      domain->reclaim(record->retired[i], domain->args);
+  }
+  record->nretired = kept;
+}
+
+int
+hazard_retire(struct hazard_domain *domain, struct hazard_record *record,
+	      void *ptr)
+{
+  size_t threshold, capacity;
+  void **retired;
+
+  /* make room by reclaiming first, grow the list only when the
+   * retired pointers are still protected */
+  if (record->nretired == record->capacity)
+    hazard_scan(domain, record);
+  if (record->nretired == record->capacity) {
+    capacity = (record->capacity == 0) ? HAZARD_SCAN_MIN :
+      2 * record->capacity;
+    retired = realloc(record->retired, capacity * sizeof(void *));
+    if (retired == NULL)
+      return UTILS_ERROR;
+    record->retired = retired;
+    record->capacity = capacity;
+  }
+  record->retired[record->nretired++] = ptr;
+
+  /* amortize the scan over a number of retires proportional to
+   * the number of hazard pointers */
+  threshold = 2 * HAZARD_SLOTS * atomic_load(&domain->nrecords);
+  if (threshold < HAZARD_SCAN_MIN)
+    threshold = HAZARD_SCAN_MIN;
+  if (record->nretired >= threshold)
+    hazard_scan(domain, record);
+  return UTILS_OK;
+}
@@ -0,0 +1,112 @@
+/**
+ * @file
+ * Hazard pointers for safe memory reclamation in lock-free
+ * data structures.
+ * A thread acquires a hazard record for the duration of an operation,
+ * publishes in it the pointers it is about to dereference and retires
+ * the objects it unlinks. Retired objects are reclaimed only when no
+ * hazard record is protecting them.
+ */
+
+#ifndef UTILS_HAZARD_H
+#define UTILS_HAZARD_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/* number of hazard pointers in each record */
+#define HAZARD_SLOTS 2
+
+/* minimum number of retired pointers that triggers a reclaim scan */
+#define HAZARD_SCAN_MIN 32
+
+typedef void (*hazard_reclaim_t)(void *ptr, void *args);
+
+/**
+ * Hazard record, records are never freed before the domain
+ * is destroyed and can be reused by any thread.
+ */
+struct hazard_record {
+  _Atomic(void *) hp[HAZARD_SLOTS];
+  atomic_bool active;
+  struct hazard_record *next;
+  /* retired pointers, owned by the thread holding the record */
+  void **retired;
+  size_t nretired;
+  size_t capacity;
+};
+
+/**
+ * Hazard pointer domain, a set of hazard records protecting
+ * the objects of a data structure.
+ */
+struct hazard_domain {
+  _Atomic(struct hazard_record *) records;
+  atomic_int nrecords;
+  hazard_reclaim_t reclaim;
+  void *args;
+};
+
+/**
+ * Initialise a hazard pointer domain.
+ * @param[in] domain: the domain to initialise
+ * @param[in] reclaim: callback used to free retired objects
+ * @param[in] args: extra argument given to the reclaim callback
+ */
+void hazard_init(struct hazard_domain *domain, hazard_reclaim_t reclaim,
+		 void *args);
+
+/**
+ * Reclaim all retired objects and free the hazard records,
+ * the domain must not be in use.
+ * @param[in] domain: the domain to destroy
+ */
+void hazard_destroy(struct hazard_domain *domain);
+
+/**
+ * Acquire a hazard record for the calling thread.
+ * @param[in] domain: the hazard domain
+ * @return: a hazard record or NULL
+ */
+struct hazard_record * hazard_acquire(struct hazard_domain *domain);
+
+/**
+ * Clear the hazard pointers and release a record.
+ * @param[in] record: the record to release
+ */
+void hazard_release(struct hazard_record *record);
+
+/**
+ * Protect the object pointed by an atomic location. The pointer is
+ * published and the location is read again until it is stable.
+ * @param[in] record: the hazard record of the calling thread
+ * @param[in] slot: hazard pointer slot to use
+ * @param[in] src: atomic location holding the pointer
+ * @return: the protected pointer
+ */
+void * hazard_protect(struct hazard_record *record, int slot,
+		      _Atomic(void *) *src);
+
+/**
+ * Retire an unlinked object, the object is reclaimed when it
+ * is not protected by any hazard pointer.
+ * @param[in] domain: the hazard domain
+ * @param[in] record: the hazard record of the calling thread
+ * @param[in] ptr: the object to retire
+ * @return: utils error code
+ */
+int hazard_retire(struct hazard_domain *domain, struct hazard_record *record,
+		  void *ptr);
+
+/**
+ * Reclaim the retired objects of a record that are not protected,
+ * the protected ones are kept for a later scan. Retiring runs the
+ * scan once enough objects are retired, structures retiring few
+ * large objects can run it right away.
+ * @param[in] domain: the hazard domain
+ * @param[in] record: the hazard record owning the retired objects
+ */
+void hazard_scan(struct hazard_domain *domain, struct hazard_record *record);
+
+#endif /* UTILS_HAZARD_H */
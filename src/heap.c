@@ -0,0 +1,337 @@
+/**
+ * @file
+ * Priority queue implementation.
+ * A 4-ary heap is half as deep as a binary heap and the four children
+ * of a node are adjacent in the array, sifting down compares more
+ * items per level but touches fewer cache lines.
+ * See heap.h for API specification
+ */
+
+#include <stdlib.h>
+
+#include "libutils/error.h"
+#include "libutils/heap.h"
+
+#define ASSERT_HANDLE_VALID(hnd) if (hnd == NULL) return UTILS_ERROR
+#define ASSERT_HANDLE_VALID_PTR(hnd) if (hnd == NULL) return NULL
+
+/* number of children of a heap node */
+#define HEAP_ARITY 4
+
+/* capacity of the first allocation */
+#define HEAP_MIN_CAPACITY 8
+
+#define HEAP_PARENT(i) (((i) - 1) / HEAP_ARITY)
+#define HEAP_CHILD(i) ((i) * HEAP_ARITY + 1)
+
+/**
+ * entry handle, tracks the position of an item in the heap
+ */
+struct heap_entry {
+  size_t index;
+};
+
+/**
+ * heap slot, the entry is NULL for items pushed without handle
+ */
+struct heap_slot {
+  void *data;
+  struct heap_entry *entry;
+};
+
+/**
+ * priority queue internal representation
+ */
+struct heap_handle {
+  struct heap_slot *slots;
+  size_t len;
+  size_t capacity;
+  list_cmp_t cmp;
+  list_ctor_t ctor;
+  list_dtor_t dtor;
+};
+
+/**
+ * Grow the heap storage geometrically to hold the given
+ * number of items
+ */
+static int
+heap_grow(struct heap_handle *handle, size_t len)
+{
+  struct heap_slot *slots;
+  size_t capacity;
+
+  if (len <= handle->capacity)
+    return UTILS_OK;
+  capacity = (handle->capacity == 0) ? HEAP_MIN_CAPACITY : handle->capacity;
+  while (capacity < len)
+    capacity *= 2;
+  slots = realloc(handle->slots, capacity * sizeof(struct heap_slot));
+  if (slots == NULL)
+    return UTILS_ERROR;
+  handle->slots = slots;
+  handle->capacity = capacity;
+  return UTILS_OK;
+}
+
+/**
+ * Store a slot at an index and keep its entry up to date
+ */
+static void
+heap_set(struct heap_handle *handle, size_t index, struct heap_slot slot)
+{
+  handle->slots[index] = slot;
+  if (slot.entry != NULL)
+    slot.entry->index = index;
+}
+
+/**
+ * Move the slot at an index towards the root until its parent
+ * comes first, the slot is held aside while the parents move down.
+ *
+ * @return: the final index of the slot
+ */
+static size_t
+heap_sift_up(struct heap_handle *handle, size_t index)
+{
+  struct heap_slot slot = handle->slots[index];
+  size_t parent;
+
+  while (index > 0) {
+    parent = HEAP_PARENT(index);
+    if (handle->cmp(slot.data, handle->slots[parent].data) >= 0)
+      break;
+    heap_set(handle, index, handle->slots[parent]);
+    index = parent;
+  }
+  heap_set(handle, index, slot);
+  return index;
+}
+
+/**
+ * Move the slot at an index towards the leaves until all of its
+ * children come after it.
+ */
+static void
+heap_sift_down(struct heap_handle *handle, size_t index)
+{
+  struct heap_slot slot = handle->slots[index];
+  size_t child, first, last, min;
+
+  for (;;) {
+    first = HEAP_CHILD(index);
+    if (first >= handle->len)
+      break;
+    last = first + HEAP_ARITY;
+    if (last > handle->len)
+      last = handle->len;
+    min = first;
+    for (child = first + 1; child < last; child++)
+      if (handle->cmp(handle->slots[child].data,
+		      handle->slots[min].data) < 0)
+	min = child;
+    if (handle->cmp(handle->slots[min].data, slot.data) >= 0)
+      break;
+    heap_set(handle, index, handle->slots[min]);
+    index = min;
+  }
+  heap_set(handle, index, slot);
+}
+
+/**
+ * Restore the heap order for an item that may be misplaced
+ * in either direction
+ */
+static void
+heap_fix(struct heap_handle *handle, size_t index)
+{
+  if (heap_sift_up(handle, index) == index)
+    heap_sift_down(handle, index);
+}
+
+/**
+ * Remove the item at an index, the last item takes its place
+ *
+ * @return: the data of the removed item
+ */
+static void *
+heap_take(struct heap_handle *handle, size_t index)
+{
+  void *data = handle->slots[index].data;
+
+  free(handle->slots[index].entry);
+  if (--handle->len > index) {
+    heap_set(handle, index, handle->slots[handle->len]);
+    heap_fix(handle, index);
+  }
+  return data;
+}
+
+/* priority queue setup API */
+
+int
+heap_init(heap_t *phandle, list_cmp_t cmp, list_ctor_t ctor,
+	  list_dtor_t dtor)
+{
+  heap_t handle;
+
+  if (phandle == NULL || cmp == NULL)
+    return UTILS_ERROR;
+  *phandle = malloc(sizeof(struct heap_handle));
+  if (*phandle == NULL)
+    return UTILS_ERROR;
+  handle = *phandle;
+  handle->slots = NULL;
+  handle->len = 0;
+  handle->capacity = 0;
+  handle->cmp = cmp;
+  handle->ctor = ctor;
+  handle->dtor = dtor;
+  return UTILS_OK;
+}
+
+int
+heap_destroy(heap_t handle)
+{
+  size_t i;
+
+  ASSERT_HANDLE_VALID(handle);
+
+  for (i = 0; i < handle->len; i++) {
+    if (handle->dtor != NULL)
+      handle->dtor(handle->slots[i].data);
+    free(handle->slots[i].entry);
+  }
+  free(handle->slots);
+  free(handle);
+  return UTILS_OK;
+}
+
+int
+heap_reserve(heap_t handle, size_t capacity)
+{
+  ASSERT_HANDLE_VALID(handle);
+
+  return heap_grow(handle, capacity);
+}
+
+/* priority queue data API */
+
+int
+heap_length(heap_t handle)
+{
+  if (handle == NULL)
+    return -UTILS_ERROR;
+  return handle->len;
+}
+
+int
+heap_push(heap_t handle, void *data, heap_entry_t *entry)
+{
+  struct heap_slot slot = {NULL, NULL};
+
+  ASSERT_HANDLE_VALID(handle);
+
+  if (heap_grow(handle, handle->len + 1))
+    return UTILS_ERROR;
+  if (entry != NULL) {
+    slot.entry = malloc(sizeof(struct heap_entry));
+    if (slot.entry == NULL)
+      return UTILS_ERROR;
+    *entry = slot.entry;
+  }
+  if (handle->ctor != NULL)
+    handle->ctor(&slot.data, data);
+  else
+    slot.data = data;
+
+  heap_set(handle, handle->len++, slot);
+  heap_sift_up(handle, handle->len - 1);
+  return UTILS_OK;
+}
+
+int
+heap_push_n(heap_t handle, void **data, size_t count)
+{
+  struct heap_slot *slot;
+  size_t i, old_len;
+
+  ASSERT_HANDLE_VALID(handle);
+  if (data == NULL && count > 0)
+    return UTILS_ERROR;
+
+  if (heap_grow(handle, handle->len + count))
+    return UTILS_ERROR;
+  old_len = handle->len;
+  for (i = 0; i < count; i++) {
+    slot = &handle->slots[old_len + i];
+    slot->entry = NULL;
+    if (handle->ctor != NULL)
+      handle->ctor(&slot->data, data[i]);
+    else
+      slot->data = data[i];
+  }
+  handle->len += count;
+
+  if (count > old_len) {
+    /* rebuild bottom-up from the last parent in O(n) */
+    for (i = HEAP_PARENT(handle->len - 1) + 1; i-- > 0; )
+      heap_sift_down(handle, i);
+  }
+  else {
+    for (i = old_len; i < handle->len; i++)
+      heap_sift_up(handle, i);
+  }
+  return UTILS_OK;
+}
+
+void *
+heap_pop(heap_t handle)
+{
+  ASSERT_HANDLE_VALID_PTR(handle);
+  if (handle->len == 0)
+    return NULL;
+
+  return heap_take(handle, 0);
+}
+
+void *
+heap_peek(heap_t handle)
+{
+  ASSERT_HANDLE_VALID_PTR(handle);
+  if (handle->len == 0)
+    return NULL;
+
+  return handle->slots[0].data;
+}
+
+int
+heap_update(heap_t handle, heap_entry_t entry)
+{
+  ASSERT_HANDLE_VALID(handle);
+  if (entry == NULL || entry->index >= handle->len)
+    return UTILS_ERROR;
+
+  heap_fix(handle, entry->index);
+  return UTILS_OK;
+}
+
+void *
+heap_remove(heap_t handle, heap_entry_t entry)
+{
+  ASSERT_HANDLE_VALID_PTR(handle);
+  if (entry == NULL || entry->index >= handle->len)
+    return NULL;
+
+  return heap_take(handle, entry->index);
+}
+
+void *
+heap_entry_data(heap_t handle, heap_entry_t entry)
+{
+  ASSERT_HANDLE_VALID_PTR(handle);
+  if (entry == NULL || entry->index >= handle->len)
+    return NULL;
+
+  return handle->slots[entry->index].data;
+}
@@ -0,0 +1,216 @@
+/**
+ * @file
+ * Intrusive list implementation.
+ * See ilist.h for API specification
+ */
+
+#include <stdlib.h>
+
+#include "libutils/error.h"
+#include "libutils/ilist.h"
+
+#define ASSERT_HANDLE_VALID(hnd) if (hnd == NULL) return UTILS_ERROR
+#define ASSERT_HANDLE_VALID_PTR(hnd) if (hnd == NULL) return NULL
+
+/**
+ * Link an item between two adjacent links
+ */
+static void
+ilist_link_between(struct ilist_link *link, struct ilist_link *prev,
+		   struct ilist_link *next)
+{
+  link->prev = prev;
+  link->next = next;
+  prev->next = link;
+  next->prev = link;
+}
+
+/* list setup API */
+
+int
+ilist_init(struct ilist *list)
+{
+  ASSERT_HANDLE_VALID(list);
+
+  list->head.next = &list->head;
+  list->head.prev = &list->head;
+  list->len = 0;
+  return UTILS_OK;
+}
+
+int
+ilist_length(struct ilist *list)
+{
+  if (list == NULL)
+    return -UTILS_ERROR;
+  return list->len;
+}
+
+bool
+ilist_empty(struct ilist *list)
+{
+  if (list == NULL)
+    return true;
+  return list->head.next == &list->head;
+}
+
+/* list data API */
+
+int
+ilist_push(struct ilist *list, struct ilist_link *link)
+{
+  ASSERT_HANDLE_VALID(list);
+  ASSERT_HANDLE_VALID(link);
+
+  ilist_link_between(link, &list->head, list->head.next);
+  list->len++;
+  return UTILS_OK;
+}
+
+int
+ilist_append(struct ilist *list, struct ilist_link *link)
+{
+  ASSERT_HANDLE_VALID(list);
+  ASSERT_HANDLE_VALID(link);
+
+  ilist_link_between(link, list->head.prev, &list->head);
+  list->len++;
+  return UTILS_OK;
+}
+
+int
+ilist_insert_after(struct ilist *list, struct ilist_link *pos,
+		   struct ilist_link *link)
+{
+  ASSERT_HANDLE_VALID(list);
+  ASSERT_HANDLE_VALID(pos);
+  ASSERT_HANDLE_VALID(link);
+
+  ilist_link_between(link, pos, pos->next);
+  list->len++;
+  return UTILS_OK;
+}
+
+int
+ilist_insert_before(struct ilist *list, struct ilist_link *pos,
+		    struct ilist_link *link)
+{
+  ASSERT_HANDLE_VALID(list);
+  ASSERT_HANDLE_VALID(pos);
+  ASSERT_HANDLE_VALID(link);
+
+  ilist_link_between(link, pos->prev, pos);
+  list->len++;
+  return UTILS_OK;
+}
+
+int
+ilist_remove(struct ilist *list, struct ilist_link *link)
+{
+  ASSERT_HANDLE_VALID(list);
+  ASSERT_HANDLE_VALID(link);
+  if (link == &list->head)
+    return UTILS_ERROR;
+
+  link->prev->next = link->next;
+  link->next->prev = link->prev;
+  link->next = NULL;
+  link->prev = NULL;
+  list->len--;
+  return UTILS_OK;
+}
+
+struct ilist_link *
+ilist_pop(struct ilist *list)
+{
+  struct ilist_link *link;
+
+  link = ilist_first(list);
+  if (link != NULL)
+    ilist_remove(list, link);
+  return link;
+}
+
+struct ilist_link *
+ilist_first(struct ilist *list)
+{
+  ASSERT_HANDLE_VALID_PTR(list);
+
+  if (list->head.next == &list->head)
+    return NULL;
+  return list->head.next;
+}
+
+struct ilist_link *
+ilist_last(struct ilist *list)
+{
+  ASSERT_HANDLE_VALID_PTR(list);
+
+  if (list->head.prev == &list->head)
+    return NULL;
+  return list->head.prev;
+}
+
+int
+ilist_walk(struct ilist *list, ilist_cbk_t cbk, void *args)
+{
+  struct ilist_link *link, *next;
+  int err;
+
+  ASSERT_HANDLE_VALID(list);
+  if (cbk == NULL)
+    return UTILS_ERROR;
+
+  for (link = list->head.next; link != &list->head; link = next) {
+    /* the callback is allowed to unlink the current item */
+    next = link->next;
+    err = cbk(link, args);
+    if (err == UTILS_ITER_STOP)
+      break;
+    if (err != UTILS_OK)
+      return UTILS_ERROR;
+  }
+  return UTILS_OK;
+}
+
+/* list iterator API */
+
+int
+ilist_iter_init(struct ilist *list, ilist_iter_t iter)
+{
+  ASSERT_HANDLE_VALID(list);
+  ASSERT_HANDLE_VALID(iter);
+
+  iter->list = list;
+  iter->cursor = list->head.next;
+  iter->next = iter->cursor->next;
+  return UTILS_OK;
+}
+
+int
+ilist_iter_next(ilist_iter_t iter)
+{
+  ASSERT_HANDLE_VALID(iter);
+  if (iter->cursor == &iter->list->head)
+    return UTILS_OK;
+
+  iter->cursor = iter->next;
+  iter->next = iter->cursor->next;
+  return UTILS_OK;
+}
+
+bool
+ilist_iter_end(ilist_iter_t iter)
+{
+  if (iter == NULL)
+    return true;
+  return iter->cursor == &iter->list->head;
+}
+
+struct ilist_link *
+ilist_iter_link(ilist_iter_t iter)
+{
+  if (ilist_iter_end(iter))
+    return NULL;
+  return iter->cursor;
+}
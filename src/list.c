@@ -4,90 +4,536 @@
  * See list.h for API specification
  */
 
+#include <stdint.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 
 #include "libutils/error.h"
 #include "libutils/list.h"
+#include "list_internal.h"
+
+/* default number of items in a node pool slab */
+#define LIST_POOL_SLAB_DEFAULT 256
+
+/* supported list modes */
+#ifdef HAVE_PTHREAD_H
+#define LIST_MODE_MASK (LIST_MODE_INDEXED | LIST_MODE_UNROLLED |	\
+			LIST_MODE_CONCURRENT | LIST_MODE_HASHED |	\
+			LIST_MODE_SPARSE | LIST_MODE_SNAPSHOT)
+#else
+#define LIST_MODE_MASK (LIST_MODE_INDEXED | LIST_MODE_UNROLLED |	\
+			LIST_MODE_HASHED | LIST_MODE_SPARSE |		\
+			LIST_MODE_SNAPSHOT)
+#endif
 
-#if 0 /* disabled due to cmocka bug */
-#ifdef UNITTEST
-extern void * _test_malloc(const size_t size, const char *file, const int line);
-extern void _test_free(const void *ptr, const char *file, const int line);
+/* number of merge sort bins, enough for any list length */
+#define LIST_SORT_BINS (8 * sizeof(size_t))
 
-#define malloc(size) _test_malloc(size, __FILE__, __LINE__)
-#define free(ptr) _test_free(ptr, __FILE__, __LINE__)
-#endif
+/* hide the latency of the pointer chasing in long merges */
+#ifdef __GNUC__
+#define LIST_PREFETCH(ptr) __builtin_prefetch(ptr)
+#else
+#define LIST_PREFETCH(ptr) do {} while (0)
 #endif
 
-#define ASSERT_HANDLE_VALID(hnd) if (hnd == NULL) return UTILS_ERROR
-#define ASSERT_HANDLE_VALID_PTR(hnd) if (hnd == NULL) return NULL
+/* distance between two list positions */
+#define LIST_DISTANCE(a, b) (((a) > (b)) ? (a) - (b) : (b) - (a))
+
+/* list modes that can not be combined */
+#define LIST_MODE_EXCLUSIVE(mode, a, b) (((mode) & (a)) && ((mode) & (b)))
+
+static int list_do_walk(struct list_handle *handle, void *cbk,
+			void *args, bool walk_data);
+
+/* node pool API */
+
+int
+list_pool_init(list_pool_t *ppool, size_t slab_items)
+{
+  struct list_pool *pool;
+
+  if (ppool == NULL)
+    return UTILS_ERROR;
+  pool = malloc(sizeof(struct list_pool));
+  if (pool == NULL)
+    return UTILS_ERROR;
+  pool->slabs = NULL;
+  pool->free = NULL;
+  pool->slab_items = (slab_items == 0) ? LIST_POOL_SLAB_DEFAULT : slab_items;
+  pool->item_size = 0;
+  pool->users = 0;
+  pool->private_pool = false;
+  *ppool = pool;
+  return UTILS_OK;
+}
+
+int
+list_pool_destroy(list_pool_t pool)
+{
+  struct list_slab *slab, *next;
+
+  ASSERT_HANDLE_VALID(pool);
+  if (pool->users > 0)
+    return UTILS_ERROR;
+
+  for (slab = pool->slabs; slab != NULL; slab = next) {
+    next = slab->next;
+    free(slab);
+  }
+  free(pool);
+  return UTILS_OK;
+}
 
 /**
- * list item internal representation
+ * Allocate a new slab and thread its items in the pool free list
+ *
+ * @param[in] pool: the node pool
+ * @param[in] nitems: the number of items in the slab
+ * @return: utils error code
  */
-struct list_item {
-  struct list_item *next;
-  struct list_item *prev;
-  void *data;
-};
+static int
+list_pool_grow(struct list_pool *pool, size_t nitems)
+{
+  struct list_slab *slab;
+  struct list_item *item;
+  char *items;
+  size_t i;
+
+  slab = malloc(sizeof(struct list_slab) +
+		nitems * pool->item_size);
+  if (slab == NULL)
+    return UTILS_ERROR;
+  slab->nitems = nitems;
+  slab->next = pool->slabs;
+  pool->slabs = slab;
+
+  /* thread the items backwards so that they are handed out in order */
+  items = (char *)(slab + 1);
+  for (i = slab->nitems; i > 0; i--) {
+    item = (struct list_item *)(items + (i - 1) * pool->item_size);
+    item->next = pool->free;
+    pool->free = item;
+  }
+  return UTILS_OK;
+}
+
+/**
+ * Check whether an item was allocated from one of the pool slabs
+ *
+ * @param[in] pool: the node pool
+ * @param[in] item: the list item
+ * @return: true if the item belongs to the pool
+ */
+static bool
+list_pool_owns(struct list_pool *pool, struct list_item *item)
+{
+  struct list_slab *slab;
+  char *items;
+
+  for (slab = pool->slabs; slab != NULL; slab = slab->next) {
+    items = (char *)(slab + 1);
+    if ((char *)item >= items &&
+	(char *)item < items + slab->nitems * pool->item_size)
+      return true;
+  }
+  return false;
+}
+
+/**
+ * Allocate a list item, from the list node pool if the list has one.
+ *
+ * @param[in] handle: the list handle
+ * @return: uninitialized list item or NULL
+ */
+static struct list_item *
+list_item_alloc(struct list_handle *handle)
+{
+  struct list_pool *pool = handle->pool;
+  struct list_item *item;
+
+  if (pool == NULL)
+    return LIST_ALLOC(handle, handle->item_size);
+
+  if (pool->free == NULL && list_pool_grow(pool, pool->slab_items))
+    return NULL;
+  item = pool->free;
+  pool->free = item->next;
+  return item;
+}
+
+/**
+ * Release a list item allocated by list_item_alloc
+ *
+ * @param[in] handle: the list handle
+ * @param[in] item: the item to release
+ */
+static void
+list_item_release(struct list_handle *handle, struct list_item *item)
+{
+  struct list_pool *pool = handle->pool;
+
+  if (pool == NULL || (handle->mixed && !list_pool_owns(pool, item))) {
+    LIST_FREE(handle, item);
+    return;
+  }
+  item->next = pool->free;
+  pool->free = item;
+}
+
+/**
+ * Attach a node pool to a list, the pool item size is fixed
+ * by the first list that uses it.
+ *
+ * @param[in] handle: the list handle
+ * @param[in] pool: the node pool
+ * @return: utils error code
+ */
+static int
+list_pool_attach(struct list_handle *handle, struct list_pool *pool)
+{
+  if (pool->item_size == 0)
+    pool->item_size = handle->item_size;
+  else if (pool->item_size != handle->item_size)
+    return UTILS_ERROR;
+  pool->users++;
+  handle->pool = pool;
+  return UTILS_OK;
+}
 
 /**
- * list internal representation
+ * Default list allocator callbacks
  */
-struct list_handle {
-  struct list_item *base;
-  list_ctor_t ctor;
-  list_dtor_t dtor;
-  size_t len;
+static void *
+list_default_alloc(size_t size, void *ctx)
+{
+  return malloc(size);
+}
+
+static void
+list_default_free(void *ptr, void *ctx)
+{
+  free(ptr);
+}
+
+static const struct list_allocator list_default_allocator = {
+  list_default_alloc, list_default_free, NULL
 };
 
-static int list_do_walk(struct list_handle *handle, void *cbk,
-			void *args, bool walk_data);
+#ifdef HAVE_PTHREAD_H
+/* concurrent list locking */
+
+/**
+ * Initialize the locks of a concurrent list
+ *
+ * @param[in] handle: the list handle
+ * @return: utils error code
+ */
+static int
+list_lock_init(struct list_handle *handle)
+{
+  handle->stage_first = NULL;
+  handle->stage_last = NULL;
+  atomic_init(&handle->staged, 0);
+  if (pthread_rwlock_init(&handle->lock, NULL))
+    return UTILS_ERROR;
+  if (pthread_rwlock_init(&handle->head_lock, NULL))
+    goto err_head;
+  if (pthread_mutex_init(&handle->tail_lock, NULL))
+    goto err_tail;
+  return UTILS_OK;
+
+ err_tail:
+  pthread_rwlock_destroy(&handle->head_lock);
+ err_head:
+  pthread_rwlock_destroy(&handle->lock);
+  return UTILS_ERROR;
+}
+
+/**
+ * Link the appended items waiting in the tail chain at the end of
+ * the list. The caller holds the head lock for writing or has
+ * exclusive access to the list.
+ *
+ * @param[in] handle: the list handle
+ */
+static void
+list_stage_drain(struct list_handle *handle)
+{
+  struct list_item *first, *last;
+
+  pthread_mutex_lock(&handle->tail_lock);
+  first = handle->stage_first;
+  last = handle->stage_last;
+  if (first != NULL) {
+    if (handle->base == NULL) {
+      handle->base = first;
+    }
+    else {
+      first->prev = handle->base->prev;
+      first->prev->next = first;
+    }
+    last->next = handle->base;
+    handle->base->prev = last;
+    handle->len += atomic_load(&handle->staged);
+    handle->stage_first = NULL;
+    handle->stage_last = NULL;
+    atomic_store(&handle->staged, 0);
+  }
+  pthread_mutex_unlock(&handle->tail_lock);
+}
+
+void
+list_lock_read(struct list_handle *handle)
+{
+  pthread_rwlock_rdlock(&handle->lock);
+  if (atomic_load(&handle->staged) > 0) {
+    pthread_rwlock_wrlock(&handle->head_lock);
+    list_stage_drain(handle);
+    pthread_rwlock_unlock(&handle->head_lock);
+  }
+  pthread_rwlock_rdlock(&handle->head_lock);
+}
+
+void
+list_lock_write(struct list_handle *handle)
+{
+  pthread_rwlock_wrlock(&handle->lock);
+  pthread_rwlock_wrlock(&handle->head_lock);
+  list_stage_drain(handle);
+}
+
+void
+list_unlock(struct list_handle *handle)
+{
+  pthread_rwlock_unlock(&handle->head_lock);
+  pthread_rwlock_unlock(&handle->lock);
+}
+#endif
+
+/* list setup API */
 
 int
 list_init(list_t *phandle, list_ctor_t ctor, list_dtor_t dtor)
+{
+  return list_init_mode(phandle, ctor, dtor, 0);
+}
+
+int
+list_init_mode(list_t *phandle, list_ctor_t ctor, list_dtor_t dtor, int mode)
+{
+  return list_init_ex(phandle, ctor, dtor, mode, NULL);
+}
+
+int
+list_init_ex(list_t *phandle, list_ctor_t ctor, list_dtor_t dtor, int mode,
+	     const list_allocator_t *allocator)
 {
   list_t handle;
 
   if (phandle == NULL)
     return UTILS_ERROR;
-  *phandle = malloc(sizeof(struct list_handle));
+  if (mode & ~LIST_MODE_MASK)
+    return UTILS_ERROR;
+  if (LIST_MODE_EXCLUSIVE(mode, LIST_MODE_UNROLLED, LIST_MODE_INDEXED) ||
+      LIST_MODE_EXCLUSIVE(mode, LIST_MODE_UNROLLED, LIST_MODE_HASHED) ||
+      LIST_MODE_EXCLUSIVE(mode, LIST_MODE_SPARSE, ~LIST_MODE_SPARSE))
+    return UTILS_ERROR;
+  if (allocator == NULL)
+    allocator = &list_default_allocator;
+  else if (allocator->alloc == NULL || allocator->free == NULL)
+    return UTILS_ERROR;
+  *phandle = allocator->alloc(sizeof(struct list_handle), allocator->ctx);
   if (*phandle == NULL)
     return UTILS_ERROR;
   handle = *phandle;
+  handle->allocator = *allocator;
   handle->base = NULL;
   handle->len = 0;
   handle->ctor = ctor;
   handle->dtor = dtor;
+  handle->mode = mode;
+  handle->pool = NULL;
+  handle->mixed = false;
+  handle->root = NULL;
+  handle->seed = 0x9e3779b9;
+  handle->chunks = NULL;
+  handle->hash.entries = NULL;
+  handle->hash.capacity = 0;
+  handle->hash.used = 0;
+  handle->cursor = NULL;
+  handle->cursor_pos = 0;
+  handle->records = NULL;
+  handle->record_size = 0;
+  handle->image = NULL;
+  handle->image_size = 0;
+  atomic_init(&handle->version, NULL);
+  handle->versions = NULL;
+  atomic_init(&handle->refs, 0);
+  if (mode & LIST_MODE_INDEXED)
+    handle->item_size = sizeof(struct list_rank_node);
+  else
+    handle->item_size = sizeof(struct list_item);
+  handle->value_size = 0;
+  handle->value_offset = 0;
+#ifdef HAVE_PTHREAD_H
+  if ((mode & LIST_MODE_CONCURRENT) && list_lock_init(handle)) {
+    LIST_FREE(handle, handle);
+    *phandle = NULL;
+    return UTILS_ERROR;
+  }
+#endif
+  if ((mode & LIST_MODE_SNAPSHOT) && list_snapshot_setup(handle)) {
+    list_destroy(handle);
+    *phandle = NULL;
+    return UTILS_ERROR;
+  }
+  return UTILS_OK;
+}
+
+/**
+ * Store the values of an empty list in its items, the values follow
+ * the item header aligned for pointers and 64-bit scalars.
+ *
+ * @param[in] handle: the list handle
+ * @param[in] value_size: the size of a value in bytes
+ */
+static void
+list_value_setup(struct list_handle *handle, size_t value_size)
+{
+  size_t align = sizeof(uint64_t);
+
+  handle->mode |= LIST_MODE_INLINE;
+  handle->value_size = value_size;
+  handle->value_offset = (handle->item_size + align - 1) & ~(align - 1);
+  handle->item_size = handle->value_offset +
+    ((value_size + align - 1) & ~(align - 1));
+}
+
+int
+list_init_value(list_t *phandle, size_t value_size, int mode)
+{
+  if (value_size == 0 ||
+      (mode & ~(LIST_MODE_INDEXED | LIST_MODE_CONCURRENT | LIST_MODE_HASHED)))
+    return UTILS_ERROR;
+  if (list_init_mode(phandle, NULL, NULL, mode))
+    return UTILS_ERROR;
+  list_value_setup(*phandle, value_size);
+  return UTILS_OK;
+}
+
+int
+list_init_pool(list_t *phandle, list_ctor_t ctor, list_dtor_t dtor,
+	       list_pool_t pool)
+{
+  list_t handle;
+
+  if (list_init(phandle, ctor, dtor))
+    return UTILS_ERROR;
+  handle = *phandle;
+
+  if (pool == NULL) {
+    if (list_pool_init(&pool, LIST_POOL_SLAB_DEFAULT))
+      goto err_pool;
+    pool->private_pool = true;
+  }
+  if (list_pool_attach(handle, pool)) {
+    if (pool->private_pool)
+      list_pool_destroy(pool);
+    goto err_pool;
+  }
   return UTILS_OK;
+
+ err_pool:
+  LIST_FREE(handle, handle);
+  *phandle = NULL;
+  return UTILS_ERROR;
 }
 
 int
 list_destroy(list_t handle)
 {
   struct list_item *curr, *next;
+  bool bulk;
   ASSERT_HANDLE_VALID(handle);
+  /* published versions are released with list_snapshot_release */
+  if (handle->mode & LIST_MODE_VERSION)
+    return UTILS_ERROR;
 
-  if (handle->base != NULL) {
+  if (handle->mode & LIST_MODE_SNAPSHOT)
+    list_snapshot_teardown(handle);
+  if (handle->mode & LIST_MODE_UNROLLED)
+    list_chunk_destroy(handle);
+  if (handle->mode & LIST_MODE_MAPPED)
+    list_mapped_release(handle);
+#ifdef HAVE_PTHREAD_H
+  if (handle->mode & LIST_MODE_CONCURRENT)
+    list_stage_drain(handle);
+#endif
+
+  /* a private pool used only by this list releases whole slabs,
+   * the items need to be visited only to run the destructor
+   */
+  bulk = (handle->pool != NULL && handle->pool->private_pool &&
+	  handle->pool->users == 1 && !handle->mixed);
+  if (handle->base != NULL && (handle->dtor != NULL || !bulk)) {
     curr = handle->base;
     do {
-      if (handle->dtor != NULL)
+      if (handle->dtor != NULL && !LIST_ITEM_GAP(curr))
 	handle->dtor(curr->data);
       next = curr->next;
-      free(curr);
+      if (!bulk)
+	list_item_release(handle, curr);
       curr = next;
     } while (curr != handle->base);
   }
-  free(handle);
+  if (handle->mode & LIST_MODE_HASHED)
+    list_hash_destroy(handle);
+  if (handle->pool != NULL) {
+    handle->pool->users--;
+    if (handle->pool->private_pool && handle->pool->users == 0)
+      list_pool_destroy(handle->pool);
+  }
+#ifdef HAVE_PTHREAD_H
+  if (handle->mode & LIST_MODE_CONCURRENT) {
+    pthread_mutex_destroy(&handle->tail_lock);
+    pthread_rwlock_destroy(&handle->head_lock);
+    pthread_rwlock_destroy(&handle->lock);
+  }
+#endif
+  LIST_FREE(handle, handle);
   return UTILS_OK;
 }
 
 int
 list_length(list_t handle)
+{
+  int len;
+
+  ASSERT_HANDLE_VALID(handle);
+
+  LIST_RDLOCK(handle);
+  len = handle->len;
+  LIST_UNLOCK(handle);
+  return len;
+}
+
+int
+list_index_memory(list_t handle, size_t *bytes)
 {
   ASSERT_HANDLE_VALID(handle);
-  return handle->len;
+  if (bytes == NULL)
+    return UTILS_ERROR;
+
+  *bytes = 0;
+  LIST_RDLOCK(handle);
+  if (handle->mode & LIST_MODE_INDEXED)
+    *bytes += handle->len *
+      (sizeof(struct list_rank_node) - sizeof(struct list_item));
+  if (handle->mode & LIST_MODE_HASHED)
+    *bytes += list_hash_memory(handle);
+  LIST_UNLOCK(handle);
+  return UTILS_OK;
 }
 
 /* list data API */
@@ -110,170 +556,1393 @@ list_pop(list_t handle)
   return list_remove(handle, 0);
 }
 
-int
-list_insert(list_t handle, void *data, int position)
+/**
+ * Find the item at a valid list position
+ *
+ * @param[in] handle: the list handle
+ * @param[in] position: the item position, less than the list length
+ * @return: the list item, NULL only if an empty element of a sparse
+ * list can not be materialized
+ */
+static struct list_item *
+list_item_find(struct list_handle *handle, size_t position)
 {
-  struct list_item *current;
-  struct list_item *new;
-  size_t index;
-  bool direction;
+  struct list_item *curr;
+  size_t from;
 
-  ASSERT_HANDLE_VALID(handle);
+  if (handle->mode & LIST_MODE_INDEXED)
+    return list_rank_get(handle, position);
+  if (handle->mode & LIST_MODE_SPARSE)
+    return list_gap_item(handle, position);
 
-  /* append empty elements to the end of the list
-   * if position is past the list length
-   */
-  while (position > handle->len) {
-    new = malloc(sizeof(struct list_item));
-    if (new == NULL)
-      return UTILS_ERROR;
-    if (handle->ctor != NULL)
-      handle->ctor(&new->data, NULL);
-    else
-      new->data = NULL;
-    
-    if (handle->base == NULL) {
-      handle->base = new;
-      new->next = new;
-      new->prev = new;
-    }
-    else {
-      current = handle->base->prev;
-      current->next = new;
-      new->prev = current;
-      handle->base->prev = new;
-      new->next = handle->base;
-    }
-    handle->len++;
+  /* walk from the closest of the head, the tail and the cursor */
+  if (handle->len - 1 - position < position) {
+    curr = handle->base->prev;
+    from = handle->len - 1;
+  }
+  else {
+    curr = handle->base;
+    from = 0;
   }
+  if (handle->cursor != NULL &&
+      LIST_DISTANCE(handle->cursor_pos, position) <
+      LIST_DISTANCE(from, position)) {
+    curr = handle->cursor;
+    from = handle->cursor_pos;
+  }
+  for (; from < position; from++)
+    curr = curr->next;
+  for (; from > position; from--)
+    curr = curr->prev;
+
+  /* concurrent readers do not share the cursor */
+  if (!(handle->mode & (LIST_MODE_CONCURRENT | LIST_MODE_VERSION))) {
+    handle->cursor = curr;
+    handle->cursor_pos = position;
+  }
+  return curr;
+}
+
+/**
+ * Find the item at the given position to relink the list there,
+ * in a sparse list the gap holding the position is split instead
+ * of materializing the element.
+ *
+ * @param[in] handle: the list handle
+ * @param[in] position: the item position, less than the list length
+ * @return: the list node starting at the position or NULL
+ */
+static struct list_item *
+list_item_boundary(struct list_handle *handle, size_t position)
+{
+  size_t offset;
+
+  if (!(handle->mode & LIST_MODE_SPARSE))
+    return list_item_find(handle, position);
+  if (list_gap_split(handle, position))
+    return NULL;
+  return list_gap_find(handle, position, &offset);
+}
+
+/**
+ * Link a new item in the list at the given position,
+ * the position is at most the list length.
+ *
+ * @param[in] handle: the list handle
+ * @param[in] new: the item to link
+ * @param[in] position: the item position
+ */
+static void
+list_item_link(struct list_handle *handle, struct list_item *new,
+	       size_t position)
+{
+  struct list_item *current;
+  size_t offset;
 
-  /* create the actual new data item */
-  new = malloc(sizeof(struct list_item));
-  if (new == NULL)
-    return UTILS_ERROR;
-  if (handle->ctor != NULL)
-    handle->ctor(&new->data, data);
-  else
-    new->data = data;
-  
   if (handle->base == NULL) {
     handle->base = new;
     new->next = new;
     new->prev = new;
   }
   else {
-    /* iterate to the position from the closest side */
-    direction = ((handle->len / 2 - position) >= 0);
-    index = direction ? 0 : handle->len;
-    current = handle->base;
-    while (index != position) {
-      current = direction ? current->next : current->prev;
-      index = direction ? index + 1 : index - 1;
-    }
+    /* the tail is linked before the base item */
+    if (position == handle->len)
+      current = handle->base;
+    else if (handle->mode & LIST_MODE_SPARSE)
+      /* the position starts a node, see list_place */
+      current = list_gap_find(handle, position, &offset);
+    else
+      current = list_item_find(handle, position);
     new->next = current;
     new->prev = current->prev;
     current->prev = new;
     new->prev->next = new;
-    if (index == 0)
+    if (position == 0)
       /* update list head if replacing the first element */
       handle->base = new;
   }
+  if (handle->mode & LIST_MODE_INDEXED)
+    list_rank_insert(handle, new, position);
+  if (handle->mode & LIST_MODE_HASHED)
+    list_hash_insert(handle, new);
+  if (handle->cursor != NULL && position <= handle->cursor_pos)
+    handle->cursor_pos++;
   handle->len++;
-  return UTILS_OK;
 }
 
-void *
-list_remove(list_t handle, int position)
+/**
+ * Unlink an item from the list, the item is not released.
+ *
+ * @param[in] handle: the list handle
+ * @param[in] item: the item to unlink
+ */
+static void
+list_item_unlink(struct list_handle *handle, struct list_item *item)
 {
-  struct list_item *target;
-  void *data;
-
-  ASSERT_HANDLE_VALID_PTR(handle);
+  /* the position of other items is unknown, a removed cursor
+   * moves to the next item */
+  if (handle->cursor != item || item->next == handle->base)
+    handle->cursor = NULL;
+  else
+    handle->cursor = item->next;
+  if (handle->mode & LIST_MODE_HASHED)
+    list_hash_remove(handle, item);
+  if (handle->mode & LIST_MODE_INDEXED)
+    list_rank_remove(handle, item);
+  if (handle->base == item) {
+    /* check for single item to update the base correctly */
+    if (item == item->next)
+      handle->base = NULL;
+    else
+      handle->base = item->next;
+  }
+  if (item != item->next) {
+    /* if there is more than one item update the pointers */
+    item->prev->next = item->next;
+    item->next->prev = item->prev;
+  }
+  handle->len--;
+}
 
-  target = list_item_get(handle, position);
-  if (target == NULL)
-    return NULL;
+/**
+ * Store constructed data in the list at the given position.
+ *
+ * @param[in] handle: the list handle
+ * @param[in] new: preallocated list item, unused by unrolled lists
+ * @param[in] itm_data: the constructed item data
+ * @param[in] position: the item position, at most the list length
+ * @return: utils error code
+ */
+static int
+list_place(struct list_handle *handle, struct list_item *new,
+	   void *itm_data, size_t position)
+{
+  if (handle->mode & LIST_MODE_UNROLLED)
+    return list_chunk_insert(handle, itm_data, position);
+  if ((handle->mode & LIST_MODE_SPARSE) && list_gap_split(handle, position))
+    return UTILS_ERROR;
 
-  data = list_item_remove(handle, target);
-  return data;
+  new->data = itm_data;
+  list_item_link(handle, new, position);
+  return UTILS_OK;
 }
 
-void *
-list_get(list_t handle, int position)
+/**
+ * Copy a value in an item of an inline list.
+ *
+ * @param[in] handle: the list handle
+ * @param[in] item: the item storing the value
+ * @param[in] value: the value to copy, NULL for a zeroed value
+ * @return: the stored value
+ */
+static void *
+list_value_copy(struct list_handle *handle, struct list_item *item,
+		const void *value)
 {
-  struct list_item *target;
+  void *stored = LIST_ITEM_VALUE(handle, item);
 
-  ASSERT_HANDLE_VALID_PTR(handle);
+  if (value != NULL)
+    memcpy(stored, value, handle->value_size);
+  else
+    memset(stored, 0, handle->value_size);
+  return stored;
+}
 
-  target = list_item_get(handle, position);
-  if (target == NULL)
-    return NULL;
-  return target->data;
+/**
+ * Allocate the storage for a new item and construct its data.
+ *
+ * @param[in] handle: the list handle
+ * @param[in] data: the data given to the constructor
+ * @param[out] pnew: the new list item, NULL for unrolled lists
+ * @param[out] itm_data: the constructed item data
+ * @return: utils error code
+ */
+static int
+list_make(struct list_handle *handle, void *data, struct list_item **pnew,
+	  void **itm_data)
+{
+  *pnew = NULL;
+  if (!(handle->mode & LIST_MODE_UNROLLED)) {
+    *pnew = list_item_alloc(handle);
+    if (*pnew == NULL)
+      return UTILS_ERROR;
+  }
+  if (handle->mode & LIST_MODE_INLINE)
+    *itm_data = list_value_copy(handle, *pnew, data);
+  else if (handle->ctor != NULL)
+    handle->ctor(itm_data, data);
+  else
+    *itm_data = data;
+  return UTILS_OK;
+}
+
+/**
+ * Destroy an item that could not be stored in the list.
+ */
+static void
+list_unmake(struct list_handle *handle, struct list_item *new,
+	    void *itm_data)
+{
+  if (handle->dtor != NULL)
+    handle->dtor(itm_data);
+  if (new != NULL)
+    list_item_release(handle, new);
+}
+
+/**
+ * Make sure the list indexes can grow to the given length,
+ * linking items can not fail afterwards.
+ *
+ * @param[in] handle: the list handle
+ * @param[in] len: the list length after the insertion
+ * @return: utils error code
+ */
+static int
+list_reserve(struct list_handle *handle, size_t len)
+{
+  if (handle->mode & LIST_MODE_HASHED)
+    return list_hash_reserve(handle, len);
+  return UTILS_OK;
+}
+
+/**
+ * Append empty elements to the end of the list until
+ * the list length reaches the given position.
+ *
+ * @param[in] handle: the list handle
+ * @param[in] position: the target list length
+ * @return: utils error code
+ */
+static int
+list_fill(struct list_handle *handle, size_t position)
+{
+  struct list_item *new;
+  void *itm_data;
+
+  if ((handle->mode & LIST_MODE_SPARSE) && position > handle->len)
+    return list_gap_append(handle, position - handle->len);
+  while (position > handle->len) {
+    if (list_make(handle, NULL, &new, &itm_data))
+      return UTILS_ERROR;
+    if (list_place(handle, new, itm_data, handle->len)) {
+      list_unmake(handle, new, itm_data);
+      return UTILS_ERROR;
+    }
+  }
+  return UTILS_OK;
+}
+
+/**
+ * Unlink the data at the given position from the list.
+ *
+ * @param[in] handle: the list handle
+ * @param[in] position: the item position
+ * @param[out] pitem: the unlinked item to release, NULL for unrolled lists
+ * @param[out] data: the data of the unlinked item
+ * @return: utils error code, error if the position is out of bound
+ */
+static int
+list_take(struct list_handle *handle, int position, struct list_item **pitem,
+	  void **data)
+{
+  struct list_item *gap;
+  size_t offset;
+
+  *pitem = NULL;
+  if (position < 0 || position >= handle->len ||
+      (handle->mode & LIST_MODE_READONLY))
+    return UTILS_ERROR;
+
+  if (handle->mode & LIST_MODE_UNROLLED) {
+    *data = list_chunk_remove(handle, position);
+    return UTILS_OK;
+  }
+  if ((handle->mode & LIST_MODE_SPARSE) && handle->ctor == NULL) {
+    /* empty elements without a constructor are dropped in place */
+    gap = list_gap_find(handle, position, &offset);
+    if (LIST_ITEM_GAP(gap)) {
+      list_gap_shrink(handle, gap);
+      *data = NULL;
+      return UTILS_OK;
+    }
+  }
+  *pitem = list_item_find(handle, position);
+  if (*pitem == NULL)
+    return UTILS_ERROR;
+  *data = (*pitem)->data;
+  list_item_unlink(handle, *pitem);
+  return UTILS_OK;
+}
+
+#ifdef HAVE_PTHREAD_H
+/**
+ * Store a new item at one end of a list with split locks, holding
+ * the whole list lock shared and only the lock of that end.
+ * Appended items wait in the tail chain, so that list_append does not
+ * touch the items linked by list_push and list_pop.
+ *
+ * @param[in] handle: the list handle
+ * @param[in] new: the new item, holding the constructed data
+ * @param[in] append: if true the item is appended to the list,
+ * otherwise it is pushed at the head
+ */
+static void
+list_end_insert(struct list_handle *handle, struct list_item *new,
+		bool append)
+{
+  pthread_rwlock_rdlock(&handle->lock);
+  if (append) {
+    pthread_mutex_lock(&handle->tail_lock);
+    new->next = NULL;
+    new->prev = handle->stage_last;
+    if (handle->stage_last == NULL)
+      handle->stage_first = new;
+    else
+      handle->stage_last->next = new;
+    handle->stage_last = new;
+    atomic_fetch_add(&handle->staged, 1);
+    pthread_mutex_unlock(&handle->tail_lock);
+  }
+  else {
+    pthread_rwlock_wrlock(&handle->head_lock);
+    list_item_link(handle, new, 0);
+    pthread_rwlock_unlock(&handle->head_lock);
+  }
+  pthread_rwlock_unlock(&handle->lock);
+}
+
+/**
+ * Unlink the head item of a list with split locks, holding the whole
+ * list lock shared and the head lock. The tail chain is locked only
+ * to move the appended items in an empty list.
+ *
+ * @param[in] handle: the list handle
+ * @param[out] pitem: the unlinked item to release
+ * @param[out] data: the data of the unlinked item
+ * @return: utils error code, error if the list is empty
+ */
+static int
+list_head_take(struct list_handle *handle, struct list_item **pitem,
+	       void **data)
+{
+  int err;
+
+  pthread_rwlock_rdlock(&handle->lock);
+  pthread_rwlock_wrlock(&handle->head_lock);
+  if (handle->len == 0)
+    list_stage_drain(handle);
+  err = list_take(handle, 0, pitem, data);
+  pthread_rwlock_unlock(&handle->head_lock);
+  pthread_rwlock_unlock(&handle->lock);
+  return err;
+}
+#endif
+
+/**
+ * Lock the list and unlink the data at the given position, see list_take.
+ */
+static int
+list_locked_take(struct list_handle *handle, int position,
+		 struct list_item **pitem, void **data)
+{
+  int err;
+
+#ifdef HAVE_PTHREAD_H
+  if (LIST_SPLIT_LOCKS(handle) && position == 0)
+    return list_head_take(handle, pitem, data);
+#endif
+  LIST_WRLOCK(handle);
+  err = list_take(handle, position, pitem, data);
+  LIST_UNLOCK(handle);
+  return err;
+}
+
+/**
+ * Common list insertion logic
+ *
+ * @param[in] handle: the list handle
+ * @param[in] data: the data given to the constructor
+ * @param[in] position: the item position
+ * @param[in] append: if true the position is ignored and
+ * the item is appended to the list
+ * @return: utils error code
+ */
+static int
+list_do_insert(struct list_handle *handle, void *data, int position,
+	       bool append)
+{
+  struct list_item *new;
+  void *itm_data;
+  int err;
+
+  ASSERT_HANDLE_VALID(handle);
+  if (position < 0 || (handle->mode & LIST_MODE_READONLY))
+    return UTILS_ERROR;
+
+  /* create the actual new data item before locking the list */
+  if (list_make(handle, data, &new, &itm_data))
+    return UTILS_ERROR;
+#ifdef HAVE_PTHREAD_H
+  if (LIST_SPLIT_LOCKS(handle) && (append || position == 0)) {
+    new->data = itm_data;
+    list_end_insert(handle, new, append);
+    return UTILS_OK;
+  }
+#endif
+
+  LIST_WRLOCK(handle);
+  if (append)
+    position = handle->len;
+  err = list_reserve(handle, ((position > handle->len) ? position :
+			      handle->len) + 1);
+  /* append empty elements to the end of the list
+   * if position is past the list length
+   */
+  if (err == UTILS_OK)
+    err = list_fill(handle, position);
+  if (err == UTILS_OK)
+    err = list_place(handle, new, itm_data, position);
+  LIST_UNLOCK(handle);
+
+  if (err)
+    list_unmake(handle, new, itm_data);
+  return err;
+}
+
+int
+list_insert(list_t handle, void *data, int position)
+{
+  return list_do_insert(handle, data, position, false);
+}
+
+void *
+list_remove(list_t handle, int position)
+{
+  struct list_item *target;
+  void *data;
+  int err;
+
+  ASSERT_HANDLE_VALID_PTR(handle);
+  /* the value is released with its item */
+  if (handle->mode & LIST_MODE_INLINE)
+    return NULL;
+
+  err = list_locked_take(handle, position, &target, &data);
+
+  if (err)
+    return NULL;
+  if (target != NULL)
+    list_item_release(handle, target);
+  return data;
+}
+
+void *
+list_get(list_t handle, int position)
+{
+  struct list_chunk *chunk;
+  struct list_item *item;
+  void *data = NULL;
+  size_t offset;
+  int slot;
+
+  ASSERT_HANDLE_VALID_PTR(handle);
+
+  LIST_RDLOCK(handle);
+  if (position >= 0 && position < handle->len) {
+    if (handle->mode & LIST_MODE_UNROLLED) {
+      chunk = list_chunk_find(handle, position, &slot);
+      data = chunk->data[slot];
+    }
+    else if (handle->mode & LIST_MODE_MAPPED) {
+      data = LIST_RECORD(handle, position);
+    }
+    else if ((handle->mode & LIST_MODE_SPARSE) && handle->ctor == NULL) {
+      /* empty elements without a constructor read as NULL */
+      item = list_gap_find(handle, position, &offset);
+      if (!LIST_ITEM_GAP(item))
+	data = item->data;
+    }
+    else {
+      item = list_item_find(handle, position);
+      if (item != NULL)
+	data = item->data;
+    }
+  }
+  LIST_UNLOCK(handle);
+  return data;
+}
+
+/**
+ * Find the position of data in a hashed list
+ *
+ * @param[in] handle: the list handle
+ * @param[in] data: the item data to look for
+ * @return: the position of the first item holding data or -1
+ */
+static int
+list_hashed_indexof(struct list_handle *handle, void *data)
+{
+  struct list_item *item;
+  int index;
+
+  item = list_hash_find(handle, data);
+  if (item == NULL)
+    return -1;
+  if (handle->mode & LIST_MODE_INDEXED)
+    return list_rank_position(handle, item);
+  for (index = 0; item != handle->base; item = item->prev)
+    index++;
+  return index;
+}
+
+/**
+ * list_indexof walk state
+ */
+struct list_indexof_args {
+  void *data;
+  int index;
+};
+
+/**
+ * Walk callback counting the items that precede the searched data
+ */
+static int
+list_indexof_cbk(void *itm_data, void *args)
+{
+  struct list_indexof_args *indexof = args;
+
+  if (itm_data == indexof->data)
+    return UTILS_ITER_STOP;
+  indexof->index++;
+  return UTILS_OK;
+}
+
+/**
+ * Find the position of data in a sparse list
+ *
+ * @param[in] handle: the list handle
+ * @param[in] data: the item data to look for
+ * @return: the position of the first item holding data or -1
+ */
+static int
+list_sparse_indexof(struct list_handle *handle, void *data)
+{
+  struct list_indexof_args indexof;
+
+  indexof.data = data;
+  indexof.index = 0;
+  if (list_gap_walk(handle, list_indexof_cbk, &indexof) ||
+      indexof.index == handle->len)
+    return -1;
+  return indexof.index;
+}
+
+int
+list_indexof(list_t handle, void *data)
+{
+  struct list_iterator iter;
+  void *item;
+  int index;
+
+  ASSERT_HANDLE_VALID(handle);
+
+  LIST_RDLOCK(handle);
+  if (handle->mode & LIST_MODE_HASHED) {
+    index = list_hashed_indexof(handle, data);
+    LIST_UNLOCK(handle);
+    return index;
+  }
+  if (handle->mode & LIST_MODE_SPARSE) {
+    index = list_sparse_indexof(handle, data);
+    LIST_UNLOCK(handle);
+    return index;
+  }
+  if (handle->mode & LIST_MODE_MAPPED) {
+    index = list_record_indexof(handle, data);
+    LIST_UNLOCK(handle);
+    return index;
+  }
+  index = 0;
+  for (list_iter_start(handle, &iter); !list_iter_end(&iter);
+       list_iter_next(&iter)) {
+    item = list_iter_data(&iter);
+    if (item == data)
+      break;
+    index++;
+  }
+  if (list_iter_end(&iter))
+    index = -1;
+  LIST_UNLOCK(handle);
+  return index;
+}
+
+int
+list_delete(list_t handle, int position)
+{
+  struct list_item *target;
+  void *data;
+  int err;
+  
+  ASSERT_HANDLE_VALID(handle);
+
+  err = list_locked_take(handle, position, &target, &data);
+
+  if (err)
+    return UTILS_ERROR;
+  list_unmake(handle, target, data);
+  return UTILS_OK;
+}
+
+int
+list_get_value(list_t handle, int position, void *value)
+{
+  struct list_item *item = NULL;
+
+  ASSERT_HANDLE_VALID(handle);
+  if (!(handle->mode & LIST_MODE_INLINE) || value == NULL)
+    return UTILS_ERROR;
+
+  /* the value is copied before a concurrent writer can remove it */
+  LIST_RDLOCK(handle);
+  if (position >= 0 && position < handle->len) {
+    item = list_item_find(handle, position);
+    memcpy(value, item->data, handle->value_size);
+  }
+  LIST_UNLOCK(handle);
+  return (item != NULL) ? UTILS_OK : UTILS_ERROR;
+}
+
+int
+list_remove_value(list_t handle, int position, void *value)
+{
+  struct list_item *target;
+  void *data;
+  int err;
+
+  ASSERT_HANDLE_VALID(handle);
+  if (!(handle->mode & LIST_MODE_INLINE))
+    return UTILS_ERROR;
+
+  err = list_locked_take(handle, position, &target, &data);
+
+  if (err)
+    return UTILS_ERROR;
+  if (value != NULL)
+    memcpy(value, data, handle->value_size);
+  list_item_release(handle, target);
+  return UTILS_OK;
+}
+
+int
+list_append(list_t handle, void *data)
+{
+  return list_do_insert(handle, data, 0, true);
+}
+
+/**
+ * Allocate a chain of list items linked through the next pointer,
+ * the items missing from the pool free list are allocated with a
+ * single slab.
+ *
+ * @param[in] handle: the list handle
+ * @param[in] count: the number of items, greater than zero
+ * @param[out] plast: the last item of the chain
+ * @return: the first item of the chain or NULL
+ */
+static struct list_item *
+list_item_alloc_n(struct list_handle *handle, size_t count,
+		  struct list_item **plast)
+{
+  struct list_pool *pool = handle->pool;
+  struct list_item *first, *item, *next;
+  size_t i;
+
+  first = NULL;
+  item = NULL;
+  for (i = 0; i < count; i++) {
+    if (pool == NULL) {
+      next = LIST_ALLOC(handle, handle->item_size);
+      if (next == NULL)
+	goto err_release;
+    }
+    else {
+      if (pool->free == NULL &&
+	  list_pool_grow(pool, (count - i > pool->slab_items) ?
+			 count - i : pool->slab_items))
+	goto err_release;
+      next = pool->free;
+      pool->free = next->next;
+    }
+    next->prev = item;
+    if (item == NULL)
+      first = next;
+    else
+      item->next = next;
+    item = next;
+  }
+  item->next = NULL;
+  *plast = item;
+  return first;
+
+ err_release:
+  while (item != NULL) {
+    next = item->prev;
+    list_item_release(handle, item);
+    item = next;
+  }
+  return NULL;
+}
+
+/**
+ * Link a chain of items at the head or at the tail of the list.
+ *
+ * @param[in] handle: the list handle
+ * @param[in] first: the first item of the chain
+ * @param[in] last: the last item of the chain
+ * @param[in] count: the number of items in the chain
+ * @param[in] position: zero or the list length
+ */
+static void
+list_chain_link(struct list_handle *handle, struct list_item *first,
+		struct list_item *last, size_t count, size_t position)
+{
+  struct list_item *item;
+  size_t i;
+
+  if (handle->base == NULL) {
+    first->prev = last;
+    last->next = first;
+    handle->base = first;
+  }
+  else {
+    /* both the head and the tail are linked before the base item */
+    first->prev = handle->base->prev;
+    last->next = handle->base;
+    handle->base->prev->next = first;
+    handle->base->prev = last;
+    if (position == 0)
+      handle->base = first;
+  }
+  if (handle->mode & LIST_MODE_INDEXED)
+    for (item = first, i = 0; i < count; item = item->next, i++)
+      list_rank_insert(handle, item, position + i);
+  if (handle->mode & LIST_MODE_HASHED)
+    for (item = first, i = 0; i < count; item = item->next, i++)
+      list_hash_insert(handle, item);
+  if (position == 0)
+    handle->cursor_pos += count;
+  handle->len += count;
+}
+
+/**
+ * Insert constructed data at the head or at the tail of an unrolled list.
+ *
+ * @param[in] handle: the list handle
+ * @param[in] itm_data: array of constructed data
+ * @param[in] count: the number of items
+ * @param[in] append: true to append the data, false to push it
+ * @return: utils error code, on error the data that could not be
+ * stored is destructed
+ */
+static int
+list_chunk_insert_n(struct list_handle *handle, void **itm_data,
+		    size_t count, bool append)
+{
+  size_t i;
+
+  /* pushing in reverse order fills a new head chunk
+   * without moving the data that follows it
+   */
+  for (i = 0; i < count; i++)
+    if (list_chunk_insert(handle, itm_data[append ? i : count - 1 - i],
+			  append ? handle->len : 0))
+      goto err_unmake;
+  return UTILS_OK;
+
+ err_unmake:
+  for (; i < count; i++)
+    list_unmake(handle, NULL, itm_data[append ? i : count - 1 - i]);
+  return UTILS_ERROR;
+}
+
+/**
+ * Common batch insertion logic, the data is stored in array order.
+ *
+ * @param[in] handle: the list handle
+ * @param[in] data: array of data given to the constructor
+ * @param[in] count: the number of items in the array
+ * @param[in] append: true to append the data, false to push it
+ * @return: utils error code
+ */
+static int
+list_do_insert_n(struct list_handle *handle, void **data, size_t count,
+		 bool append)
+{
+  struct list_item *first, *last, *item;
+  void **itm_data = NULL;
+  size_t i;
+  int err;
+
+  ASSERT_HANDLE_VALID(handle);
+  if ((data == NULL && count > 0) || (handle->mode & LIST_MODE_READONLY))
+    return UTILS_ERROR;
+  if (count == 0)
+    return UTILS_OK;
+
+  if (handle->mode & LIST_MODE_UNROLLED) {
+    itm_data = LIST_ALLOC(handle, count * sizeof(void *));
+    if (itm_data == NULL)
+      return UTILS_ERROR;
+    for (i = 0; i < count; i++)
+      if (handle->ctor != NULL)
+	handle->ctor(&itm_data[i], data[i]);
+      else
+	itm_data[i] = data[i];
+
+    LIST_WRLOCK(handle);
+    err = list_chunk_insert_n(handle, itm_data, count, append);
+    LIST_UNLOCK(handle);
+    LIST_FREE(handle, itm_data);
+    return err;
+  }
+
+  /* create the new data items before locking the list */
+  first = list_item_alloc_n(handle, count, &last);
+  if (first == NULL)
+    return UTILS_ERROR;
+  for (item = first, i = 0; i < count; item = item->next, i++)
+    if (handle->mode & LIST_MODE_INLINE)
+      item->data = list_value_copy(handle, item, data[i]);
+    else if (handle->ctor != NULL)
+      handle->ctor(&item->data, data[i]);
+    else
+      item->data = data[i];
+
+  LIST_WRLOCK(handle);
+  err = list_reserve(handle, handle->len + count);
+  if (err == UTILS_OK)
+    list_chain_link(handle, first, last, count, append ? handle->len : 0);
+  LIST_UNLOCK(handle);
+
+  if (err)
+    for (item = first; item != NULL; item = first) {
+      first = item->next;
+      list_unmake(handle, item, item->data);
+    }
+  return err;
+}
+
+int
+list_append_n(list_t handle, void **data, size_t count)
+{
+  return list_do_insert_n(handle, data, count, true);
+}
+
+int
+list_push_n(list_t handle, void **data, size_t count)
+{
+  return list_do_insert_n(handle, data, count, false);
+}
+
+/**
+ * Merge two sorted chains of items linked through the next pointer,
+ * the items of the first chain come first when they compare equal.
+ */
+static struct list_item *
+list_chain_merge(struct list_item *a, struct list_item *b, list_cmp_t cmp)
+{
+  struct list_item *head, **tail = &head;
+
+  while (a != NULL && b != NULL) {
+    LIST_PREFETCH(a->next);
+    LIST_PREFETCH(b->next);
+    if (cmp(a->data, b->data) <= 0) {
+      *tail = a;
+      a = a->next;
+    }
+    else {
+      *tail = b;
+      b = b->next;
+    }
+    tail = &(*tail)->next;
+  }
+  *tail = (a != NULL) ? a : b;
+  return head;
+}
+
+/**
+ * Stable merge sort of a chain of items linked through the next
+ * pointer. Bin k holds a sorted run of 2^k items, each item is merged
+ * into the bins like a binary counter so that the runs are merged
+ * while their items are still in cache.
+ *
+ * @param[in] head: the first item of the NULL terminated chain
+ * @param[in] cmp: item data comparator
+ * @return: the first item of the sorted chain
+ */
+static struct list_item *
+list_chain_sort(struct list_item *head, list_cmp_t cmp)
+{
+  struct list_item *bins[LIST_SORT_BINS] = {NULL};
+  struct list_item *run;
+  int k, max = 0;
+
+  while (head != NULL) {
+    run = head;
+    head = head->next;
+    run->next = NULL;
+    /* the runs in the bins hold the earlier items */
+    for (k = 0; bins[k] != NULL; k++) {
+      run = list_chain_merge(bins[k], run, cmp);
+      bins[k] = NULL;
+    }
+    bins[k] = run;
+    if (k > max)
+      max = k;
+  }
+  run = NULL;
+  for (k = 0; k <= max; k++)
+    if (bins[k] != NULL)
+      run = (run == NULL) ? bins[k] : list_chain_merge(bins[k], run, cmp);
+  return run;
+}
+
+int
+list_sort(list_t handle, list_cmp_t cmp)
+{
+  struct list_item *head, *item;
+  int err = UTILS_OK;
+
+  ASSERT_HANDLE_VALID(handle);
+  if (cmp == NULL || (handle->mode & LIST_MODE_READONLY))
+    return UTILS_ERROR;
+
+  LIST_WRLOCK(handle);
+  /* empty elements are sorted as materialized items */
+  if (handle->mode & LIST_MODE_SPARSE)
+    err = list_gap_expand(handle);
+  if (err == UTILS_OK && (handle->mode & LIST_MODE_UNROLLED)) {
+    err = list_chunk_sort(handle, cmp);
+  }
+  else if (err == UTILS_OK && handle->len > 1) {
+    /* break the circle, sort and restore the back links */
+    handle->base->prev->next = NULL;
+    head = list_chain_sort(handle->base, cmp);
+    for (item = head; item->next != NULL; item = item->next)
+      item->next->prev = item;
+    item->next = head;
+    head->prev = item;
+    handle->base = head;
+    handle->cursor = NULL;
+    if (handle->mode & LIST_MODE_INDEXED)
+      list_rank_rebuild(handle);
+  }
+  LIST_UNLOCK(handle);
+  return err;
+}
+
+/**
+ * Find the insertion position in a sorted list
+ *
+ * @param[in] handle: the list handle
+ * @param[in] itm_data: the constructed item data
+ * @param[in] cmp: item data comparator
+ * @return: the position following the items not greater than itm_data
+ */
+static size_t
+list_sorted_position(struct list_handle *handle, void *itm_data,
+		     list_cmp_t cmp)
+{
+  struct list_item *curr;
+  struct list_chunk *last;
+  size_t position;
+
+  if (handle->len == 0)
+    return 0;
+
+  /* in order insertions go to the tail */
+  if (handle->mode & LIST_MODE_UNROLLED) {
+    last = handle->chunks->prev;
+    if (cmp(itm_data, last->data[last->count - 1]) >= 0)
+      return handle->len;
+    return list_chunk_upper(handle, itm_data, cmp);
+  }
+  if (cmp(itm_data, handle->base->prev->data) >= 0)
+    return handle->len;
+  if (handle->mode & LIST_MODE_INDEXED)
+    return list_rank_upper(handle, itm_data, cmp);
+
+  position = 0;
+  for (curr = handle->base; cmp(itm_data, curr->data) >= 0;
+       curr = curr->next)
+    position++;
+  return position;
+}
+
+int
+list_insert_sorted(list_t handle, void *data, list_cmp_t cmp)
+{
+  struct list_item *new;
+  void *itm_data;
+  int err;
+
+  ASSERT_HANDLE_VALID(handle);
+  if (cmp == NULL || (handle->mode & LIST_MODE_READONLY))
+    return UTILS_ERROR;
+
+  if (list_make(handle, data, &new, &itm_data))
+    return UTILS_ERROR;
+
+  LIST_WRLOCK(handle);
+  err = list_reserve(handle, handle->len + 1);
+  /* empty elements are compared as materialized items */
+  if (err == UTILS_OK && (handle->mode & LIST_MODE_SPARSE))
+    err = list_gap_expand(handle);
+  if (err == UTILS_OK)
+    err = list_place(handle, new, itm_data,
+		     list_sorted_position(handle, itm_data, cmp));
+  LIST_UNLOCK(handle);
+
+  if (err)
+    list_unmake(handle, new, itm_data);
+  return err;
+}
+
+/**
+ * Lock two different lists for writing, in address order
+ * so that concurrent splices can not deadlock.
+ */
+static void
+list_wrlock_pair(struct list_handle *a, struct list_handle *b)
+{
+  if (a > b) {
+    LIST_WRLOCK(b);
+    LIST_WRLOCK(a);
+  }
+  else {
+    LIST_WRLOCK(a);
+    LIST_WRLOCK(b);
+  }
+}
+
+static void
+list_unlock_pair(struct list_handle *a, struct list_handle *b)
+{
+  LIST_UNLOCK(a);
+  LIST_UNLOCK(b);
+}
+
+/**
+ * Check whether the items of a list can be moved to another list,
+ * the destination list must be able to release them.
+ *
+ * @param[in] dst: the list receiving the items
+ * @param[in] src: the list giving the items
+ * @return: true if the node pools are compatible
+ */
+static bool
+list_pool_movable(struct list_handle *dst, struct list_handle *src)
+{
+  /* items allocated outside of the pool are recognized by a mixed list,
+   * a private pool used only by the source list is merged */
+  return (src->pool == dst->pool || src->pool == NULL ||
+	  (src->pool->private_pool && src->pool->users == 1));
+}
+
+/**
+ * Check whether two lists release memory with the same allocator
+ */
+static bool
+list_allocator_equal(struct list_handle *a, struct list_handle *b)
+{
+  return (a->allocator.alloc == b->allocator.alloc &&
+	  a->allocator.free == b->allocator.free &&
+	  a->allocator.ctx == b->allocator.ctx);
+}
+
+/**
+ * Move the node pool of a list giving all its items to the
+ * list receiving them, see list_pool_movable.
+ *
+ * @param[in] dst: the list receiving the items
+ * @param[in] src: the list giving the items
+ */
+static void
+list_pool_move(struct list_handle *dst, struct list_handle *src)
+{
+  struct list_pool *pool = src->pool;
+  struct list_slab *slab;
+  struct list_item *item;
+
+  if (pool == dst->pool) {
+    dst->mixed |= src->mixed;
+    return;
+  }
+  if (pool == NULL) {
+    dst->mixed = true;
+    return;
+  }
+  if (dst->pool == NULL) {
+    /* the private pool follows the items */
+    dst->pool = pool;
+    dst->mixed = (dst->len > 0 || src->mixed);
+  }
+  else {
+    /* merge the slabs and the free items of the private pool */
+    if (pool->slabs != NULL) {
+      for (slab = pool->slabs; slab->next != NULL; slab = slab->next)
+	;
+      slab->next = dst->pool->slabs;
+      dst->pool->slabs = pool->slabs;
+    }
+    if (pool->free != NULL) {
+      for (item = pool->free; item->next != NULL; item = item->next)
+	;
+      item->next = dst->pool->free;
+      dst->pool->free = pool->free;
+    }
+    dst->mixed |= src->mixed;
+    pool->slabs = NULL;
+    pool->users = 0;
+    list_pool_destroy(pool);
+  }
+  src->pool = NULL;
+  src->mixed = false;
+}
+
+/**
+ * Move the data index entries of the items from a list to another
+ *
+ * @param[in] dst: the list receiving the items, with reserved index
+ * @param[in] src: the list giving the items, the items are still linked
+ * @param[in] first: the first moved item
+ * @param[in] count: the number of moved items
+ */
+static void
+list_hash_move(struct list_handle *dst, struct list_handle *src,
+	       struct list_item *first, size_t count)
+{
+  struct list_item *item;
+  size_t i;
+
+  for (item = first, i = 0; i < count; item = item->next, i++) {
+    list_hash_remove(src, item);
+    list_hash_insert(dst, item);
+  }
+}
+
+/**
+ * Common list splice logic
+ *
+ * @param[in] dst: the list receiving the items
+ * @param[in] position: the position of the first moved item in dst
+ * @param[in] src: the list giving all its items
+ * @param[in] append: if true the position is ignored and the items
+ * are appended to dst
+ * @return: utils error code
+ */
+static int
+list_do_splice(struct list_handle *dst, int position,
+	       struct list_handle *src, bool append)
+{
+  struct list_item *first, *last, *next;
+  int err = UTILS_OK;
+
+  ASSERT_HANDLE_VALID(dst);
+  ASSERT_HANDLE_VALID(src);
+  if (dst == src || dst->mode != src->mode || position < 0 ||
+      dst->value_size != src->value_size ||
+      (dst->mode & LIST_MODE_READONLY) ||
+      !list_allocator_equal(dst, src))
+    return UTILS_ERROR;
+
+  list_wrlock_pair(dst, src);
+  if (append)
+    position = dst->len;
+  if (position > dst->len || !list_pool_movable(dst, src))
+    err = UTILS_ERROR;
+  if (err == UTILS_OK && src->len > 0) {
+    if (dst->mode & LIST_MODE_UNROLLED) {
+      err = list_chunk_join(dst, src, position);
+    }
+    else {
+      err = list_reserve(dst, dst->len + src->len);
+      /* the tail is linked before the base item */
+      next = dst->base;
+      if (err == UTILS_OK && position < dst->len) {
+	next = list_item_boundary(dst, position);
+	if (next == NULL)
+	  err = UTILS_ERROR;
+      }
+      if (err == UTILS_OK) {
+	first = src->base;
+	last = first->prev;
+	if (dst->mode & LIST_MODE_HASHED)
+	  list_hash_move(dst, src, first, src->len);
+	list_pool_move(dst, src);
+	if (dst->mode & LIST_MODE_INDEXED)
+	  list_rank_join(dst, src, position);
+
+	if (next == NULL) {
+	  dst->base = first;
+	}
+	else {
+	  first->prev = next->prev;
+	  last->next = next;
+	  next->prev->next = first;
+	  next->prev = last;
+	  if (position == 0)
+	    dst->base = first;
+	}
+	src->base = NULL;
+	dst->cursor = NULL;
+	src->cursor = NULL;
+      }
+    }
+    if (err == UTILS_OK) {
+      dst->len += src->len;
+      src->len = 0;
+    }
+  }
+  list_unlock_pair(dst, src);
+  return err;
 }
 
 int
-list_indexof(list_t handle, void *data)
+list_concat(list_t dst, list_t src)
 {
-  struct list_iterator iter;
-  void *item;
-  int index;
-
-  ASSERT_HANDLE_VALID(handle);
-
-  index = 0;
-  for (list_iter_init(handle, &iter); !list_iter_end(&iter);
-       list_iter_next(&iter)) {
-    item = list_iter_data(&iter);
-    if (item == data)
-      break;
-    index++;
-  }
-  if (list_iter_end(&iter))
-    return -1;
-  return index;
+  return list_do_splice(dst, 0, src, true);
 }
 
 int
-list_delete(list_t handle, int position)
+list_splice(list_t dst, int position, list_t src)
 {
-  void *data;
-  
-  ASSERT_HANDLE_VALID(handle);
-  if (list_length(handle) <= position)
-    return UTILS_ERROR;
-
-  data = list_remove(handle, position);  
-  if (handle->dtor != NULL)
-    handle->dtor(data);
-  return UTILS_OK;
+  return list_do_splice(dst, position, src, false);
 }
 
 int
-list_append(list_t handle, void *data)
+list_split(list_t handle, int position, list_t *pout)
 {
+  struct list_item *first, *last;
+  list_t out;
+  int err = UTILS_OK;
+
   ASSERT_HANDLE_VALID(handle);
+  if (pout == NULL || position < 0 || (handle->mode & LIST_MODE_READONLY))
+    return UTILS_ERROR;
+  if (list_init_ex(&out, handle->ctor, handle->dtor,
+		   handle->mode & ~LIST_MODE_INLINE, &handle->allocator))
+    return UTILS_ERROR;
+  if (handle->mode & LIST_MODE_INLINE)
+    list_value_setup(out, handle->value_size);
+
+  LIST_WRLOCK(handle);
+  if (position > handle->len)
+    err = UTILS_ERROR;
+  if (err == UTILS_OK && handle->pool != NULL) {
+    /* the moved items keep their pool */
+    list_pool_attach(out, handle->pool);
+    out->mixed = handle->mixed;
+  }
+  if (err == UTILS_OK && position < handle->len) {
+    if (handle->mode & LIST_MODE_UNROLLED) {
+      err = list_chunk_split(handle, out, position);
+    }
+    else {
+      err = list_reserve(out, handle->len - position);
+      first = NULL;
+      if (err == UTILS_OK) {
+	first = list_item_boundary(handle, position);
+	if (first == NULL)
+	  err = UTILS_ERROR;
+      }
+      if (err == UTILS_OK) {
+	last = handle->base->prev;
+	if (handle->mode & LIST_MODE_HASHED)
+	  list_hash_move(out, handle, first, handle->len - position);
+	if (handle->mode & LIST_MODE_INDEXED)
+	  list_rank_split(handle, out, position);
+
+	if (first == handle->base) {
+	  handle->base = NULL;
+	}
+	else {
+	  first->prev->next = handle->base;
+	  handle->base->prev = first->prev;
+	}
+	first->prev = last;
+	last->next = first;
+	out->base = first;
+	handle->cursor = NULL;
+      }
+    }
+    if (err == UTILS_OK) {
+      out->len = handle->len - position;
+      handle->len = position;
+    }
+  }
+  LIST_UNLOCK(handle);
 
-  return list_insert(handle, data, handle->len);
+  if (err) {
+    list_destroy(out);
+    return err;
+  }
+  *pout = out;
+  return UTILS_OK;
 }
 
 /* list iterator API */
 
+/**
+ * Iterator allocated by list_iter, it keeps the allocator of its
+ * list so that it can be freed after the list is destroyed.
+ */
+struct list_iter_alloc {
+  struct list_iterator iter;
+  list_allocator_t allocator;
+};
+
 list_iter_t
 list_iter(list_t handle)
 {
-  struct list_iterator *list_iter;
+  struct list_iter_alloc *list_iter;
 
   ASSERT_HANDLE_VALID_PTR(handle);
 
-  list_iter = malloc(sizeof(struct list_iterator));
+  list_iter = LIST_ALLOC(handle, sizeof(struct list_iter_alloc));
   if (list_iter == NULL)
     return NULL;
 
-  if (list_iter_init(handle, list_iter)) {
-    free(list_iter);
+  if (list_iter_init(handle, &list_iter->iter)) {
+    LIST_FREE(handle, list_iter);
     return NULL;
   }
-  return list_iter;
+  list_iter->allocator = handle->allocator;
+  return &list_iter->iter;
+}
+
+/**
+ * Materialize the empty element of a sparse list the iterator
+ * moved to, the iterator ends if the element can not be allocated.
+ *
+ * @param[in] iter: the iterator
+ * @param[in] forward: true if the iterator moved forward, the
+ * element is the first of the gap, otherwise the last
+ */
+static void
+list_iter_land(list_iter_t iter, bool forward)
+{
+  struct list_item *gap = iter->cursor;
+
+  if (!(iter->list->mode & LIST_MODE_SPARSE) || gap == NULL ||
+      !LIST_ITEM_GAP(gap))
+    return;
+  iter->cursor = list_gap_fill(iter->list, gap, forward ? 0 :
+			       ((struct list_gap *)gap)->count - 1);
+  if (iter->cursor == NULL) {
+    iter->cursor = gap;
+    iter->end = true;
+  }
 }
 
 int
@@ -281,44 +1950,190 @@ list_iter_init(list_t handle, list_iter_t iter)
 {
   ASSERT_HANDLE_VALID(handle);
 
+  /* link the appended items of a concurrent list */
+  LIST_WRLOCK(handle);
+  LIST_UNLOCK(handle);
+  list_iter_start(handle, iter);
+  return UTILS_OK;
+}
+
+void
+list_iter_start(struct list_handle *handle, list_iter_t iter)
+{
   iter->list = handle;
   iter->cursor = handle->base;
-  if (iter->cursor == NULL) {
-    iter->end = true;
-  }
-  else {
-    iter->end = false;
+  iter->chunk = handle->chunks;
+  iter->slot = 0;
+  iter->removed = false;
+  iter->end = (handle->len == 0);
+  list_iter_land(iter, true);
+}
+
+int
+list_iter_init_tail(list_t handle, list_iter_t iter)
+{
+  ASSERT_HANDLE_VALID(handle);
+
+  /* link the appended items of a concurrent list */
+  LIST_WRLOCK(handle);
+  LIST_UNLOCK(handle);
+
+  iter->list = handle;
+  iter->cursor = NULL;
+  iter->chunk = NULL;
+  iter->slot = 0;
+  if (handle->base != NULL)
+    iter->cursor = handle->base->prev;
+  if (handle->chunks != NULL) {
+    iter->chunk = handle->chunks->prev;
+    iter->slot = iter->chunk->count - 1;
   }
-  iter->guard = NULL;
+  if ((handle->mode & LIST_MODE_MAPPED) && handle->len > 0)
+    iter->slot = handle->len - 1;
+  iter->removed = false;
+  iter->end = (handle->len == 0);
+  list_iter_land(iter, false);
   return UTILS_OK;
 }
 
 int
 list_iter_free(list_iter_t iter)
 {
+  struct list_iter_alloc *list_iter = (struct list_iter_alloc *)iter;
+
   if (iter == NULL)
     return UTILS_ERROR;
 
-  free(iter);
+  list_iter->allocator.free(list_iter, list_iter->allocator.ctx);
   return UTILS_OK;
 }
 
 int
 list_iter_next(list_iter_t iter)
 {
-  struct list_item *item;
-  
   if (iter == NULL)
     return UTILS_ERROR;
+  if (iter->removed) {
+    /* the iterator already refers to the data after the removed one */
+    iter->removed = false;
+    if (iter->cursor == NULL && iter->chunk == NULL)
+      iter->end = true;
+    list_iter_land(iter, true);
+    return UTILS_OK;
+  }
+  if (iter->list->mode & LIST_MODE_MAPPED) {
+    if (iter->list->len == 0)
+      return UTILS_ERROR;
+    /* mapped list, move to the next record */
+    if (iter->end)
+      return UTILS_OK;
+    if (iter->slot + 1 == iter->list->len)
+      iter->end = true;
+    else
+      iter->slot++;
+    return UTILS_OK;
+  }
+  if (iter->list->mode & LIST_MODE_UNROLLED) {
+    if (iter->chunk == NULL)
+      return UTILS_ERROR;
+    /* unrolled list, move to the next slot */
+    if (iter->end)
+      return UTILS_OK;
+    if (++iter->slot < iter->chunk->count)
+      return UTILS_OK;
+    if (iter->chunk->next == iter->list->chunks) {
+      iter->end = true;
+    }
+    else {
+      iter->chunk = iter->chunk->next;
+      iter->slot = 0;
+    }
+    return UTILS_OK;
+  }
+  if (iter->cursor == NULL)
+    return UTILS_ERROR;
+  if (iter->end)
+    return UTILS_OK;
+
+  if (iter->cursor->next == iter->list->base)
+    iter->end = true;
+  else
+    iter->cursor = iter->cursor->next;
+  list_iter_land(iter, true);
+  return UTILS_OK;
+}
+
+int
+list_iter_prev(list_iter_t iter)
+{
+  struct list_handle *handle;
+
+  if (iter == NULL)
+    return UTILS_ERROR;
+  handle = iter->list;
+  if (iter->removed) {
+    /*
+     * step back from the data after the removed one, the end
+     * of the list if the removed data was the last.
+     */
+    iter->removed = false;
+    if (handle->len == 0) {
+      iter->end = true;
+      return UTILS_OK;
+    }
+    if (handle->mode & LIST_MODE_UNROLLED) {
+      if (iter->chunk == NULL) {
+	iter->chunk = handle->chunks->prev;
+	iter->slot = iter->chunk->count;
+      }
+    }
+    else if (iter->cursor == NULL) {
+      iter->cursor = handle->base->prev;
+      list_iter_land(iter, false);
+      return UTILS_OK;
+    }
+  }
+
+  if (handle->mode & LIST_MODE_MAPPED) {
+    if (handle->len == 0)
+      return UTILS_ERROR;
+    /* mapped list, move to the previous record */
+    if (iter->end)
+      return UTILS_OK;
+    if (iter->slot == 0)
+      iter->end = true;
+    else
+      iter->slot--;
+    return UTILS_OK;
+  }
+  if (handle->mode & LIST_MODE_UNROLLED) {
+    if (iter->chunk == NULL)
+      return UTILS_ERROR;
+    /* unrolled list, move to the previous slot */
+    if (iter->end)
+      return UTILS_OK;
+    if (iter->slot > 0) {
+      iter->slot--;
+    }
+    else if (iter->chunk == handle->chunks) {
+      iter->end = true;
+    }
+    else {
+      iter->chunk = iter->chunk->prev;
+      iter->slot = iter->chunk->count - 1;
+    }
+    return UTILS_OK;
+  }
   if (iter->cursor == NULL)
     return UTILS_ERROR;
+  if (iter->end)
+    return UTILS_OK;
 
-  iter->guard = iter->list->base;
-  item = iter->cursor->next;
-  if (item == iter->guard)
+  if (iter->cursor == handle->base)
     iter->end = true;
   else
-    iter->cursor = item;
+    iter->cursor = iter->cursor->prev;
+  list_iter_land(iter, false);
   return UTILS_OK;
 }
 
@@ -327,6 +2142,12 @@ list_iter_data(list_iter_t iter)
 {
   struct list_item *item;
 
+  if (iter == NULL || iter->end || iter->removed)
+    return NULL;
+  if (iter->list->mode & LIST_MODE_UNROLLED)
+    return iter->chunk->data[iter->slot];
+  if (iter->list->mode & LIST_MODE_MAPPED)
+    return LIST_RECORD(iter->list, iter->slot);
   item = list_iter_item(iter);
   if (item == NULL)
     return NULL;
@@ -338,46 +2159,218 @@ list_iter_end(list_iter_t iter)
 {
   if (iter == NULL)
     return true;
-
-  if (iter->cursor == NULL)
-    iter->end = true;
-  else if (iter->cursor == iter->guard)
-    iter->end = true;
   return iter->end;
 }
 
 int
 list_iter_seek(list_iter_t iter, int index)
 {
-  struct list_item *curr;
-  int position;
+  struct list_handle *handle;
 
   if (iter == NULL)
     return UTILS_ERROR;
-  if (iter->list->base == NULL) {
-    return UTILS_ERROR;
-  }
-  
-  if (iter->list->len <= index) {
+  handle = iter->list;
+
+  LIST_RDLOCK(handle);
+  if (index < 0 || index >= handle->len) {
     /* Can not seek out of bound index */
-    iter->end = true;
+    LIST_UNLOCK(handle);
+    if (handle->len > 0)
+      iter->end = true;
     return UTILS_ERROR;
   }
+  /* both lookups start from the end closest to the index */
+  if (handle->mode & LIST_MODE_UNROLLED)
+    iter->chunk = list_chunk_find(handle, index, &iter->slot);
+  else if (handle->mode & LIST_MODE_MAPPED)
+    iter->slot = index;
+  else
+    iter->cursor = list_item_find(handle, index);
+  LIST_UNLOCK(handle);
 
-  for (position = 0, curr = iter->list->base; position < index; position++)
-    curr = curr->next;
+  iter->removed = false;
+  iter->end = (iter->chunk == NULL && iter->cursor == NULL &&
+	       !(handle->mode & LIST_MODE_MAPPED));
+  return iter->end ? UTILS_ERROR : UTILS_OK;
+}
+
+/**
+ * Unlink and release the current element of an iterator,
+ * see list_iter_remove.
+ *
+ * @param[in] iter: the iterator on a list element
+ * @return: the data of the removed element
+ */
+static void *
+list_iter_take(list_iter_t iter)
+{
+  struct list_handle *handle = iter->list;
+  struct list_item *item;
+  void *data;
 
-  if (index == 0)
-    /* In this case the iterator resets and the guard item resets too */
-    iter->guard = NULL;
+  LIST_WRLOCK(handle);
+  if (handle->mode & LIST_MODE_UNROLLED) {
+    data = list_chunk_remove_at(handle, &iter->chunk, &iter->slot);
+    LIST_UNLOCK(handle);
+    iter->removed = true;
+    return data;
+  }
+  item = iter->cursor;
+  if (item->next == handle->base)
+    iter->cursor = NULL;
   else
-    iter->guard = iter->list->base;
+    iter->cursor = item->next;
+  list_item_unlink(handle, item);
+  LIST_UNLOCK(handle);
+
+  data = item->data;
+  list_item_release(handle, item);
+  iter->removed = true;
+  return data;
+}
+
+void *
+list_iter_remove(list_iter_t iter)
+{
+  if (iter == NULL || iter->end || iter->removed ||
+      (iter->list->mode & (LIST_MODE_READONLY | LIST_MODE_INLINE)))
+    return NULL;
+  return list_iter_take(iter);
+}
+
+int
+list_iter_delete(list_iter_t iter)
+{
+  void *data;
+
+  if (iter == NULL || iter->end || iter->removed ||
+      (iter->list->mode & LIST_MODE_READONLY))
+    return UTILS_ERROR;
+
+  data = list_iter_take(iter);
+  if (iter->list->dtor != NULL)
+    iter->list->dtor(data);
+  return UTILS_OK;
+}
+
+/* list filter, map and reduce API */
+
+int
+list_filter(list_t handle, list_pred_t pred, void *args)
+{
+  struct list_item *curr, *next;
+  size_t count;
+  void *data;
+  int err = UTILS_OK;
+
+  ASSERT_HANDLE_VALID(handle);
+  if (pred == NULL || (handle->mode & LIST_MODE_READONLY))
+    return UTILS_ERROR;
 
-  iter->cursor = curr;
-  iter->end = false;
+  LIST_WRLOCK(handle);
+  if (handle->mode & LIST_MODE_SPARSE)
+    err = list_gap_expand(handle);
+  if (err == UTILS_OK && (handle->mode & LIST_MODE_UNROLLED)) {
+    list_chunk_filter(handle, pred, args);
+  }
+  else if (err == UTILS_OK) {
+    curr = handle->base;
+    for (count = handle->len; count > 0; count--) {
+      next = curr->next;
+      if (!pred(curr->data, args)) {
+	data = curr->data;
+	list_item_unlink(handle, curr);
+	list_item_release(handle, curr);
+	if (handle->dtor != NULL)
+	  handle->dtor(data);
+      }
+      curr = next;
+    }
+  }
+  LIST_UNLOCK(handle);
+  return err;
+}
+
+int
+list_map(list_t handle, list_t dst, list_map_t map, void *args)
+{
+  list_stage_t stage = LIST_MAP(map, args);
+
+  if (map == NULL || dst == NULL)
+    return UTILS_ERROR;
+  return list_pipeline(handle, &stage, 1, dst);
+}
+
+int
+list_reduce(list_t handle, list_reduce_t reduce, void *acc)
+{
+  list_stage_t stage = LIST_REDUCE(reduce, acc);
+
+  if (reduce == NULL)
+    return UTILS_ERROR;
+  return list_pipeline(handle, &stage, 1, NULL);
+}
+
+/**
+ * list_pipeline walk arguments
+ */
+struct list_pipeline_args {
+  const struct list_stage *stages;
+  size_t nstages;
+  struct list_handle *dst;
+};
+
+/**
+ * Run the pipeline stages on an item
+ */
+static int
+list_pipeline_cbk(void *itm_data, void *args)
+{
+  struct list_pipeline_args *pipeline = args;
+  const struct list_stage *stage;
+  size_t i;
+  int err;
+
+  for (i = 0; i < pipeline->nstages; i++) {
+    stage = &pipeline->stages[i];
+    switch (stage->op) {
+    case LIST_STAGE_FILTER:
+      if (!stage->fn.filter(itm_data, stage->args))
+	return UTILS_OK;
+      break;
+    case LIST_STAGE_MAP:
+      itm_data = stage->fn.map(itm_data, stage->args);
+      break;
+    case LIST_STAGE_REDUCE:
+      err = stage->fn.reduce(itm_data, stage->args);
+      if (err != UTILS_OK)
+	return err;
+      break;
+    }
+  }
+  if (pipeline->dst != NULL)
+    return list_append(pipeline->dst, itm_data);
   return UTILS_OK;
 }
 
+int
+list_pipeline(list_t handle, const list_stage_t *stages, size_t nstages,
+	      list_t dst)
+{
+  struct list_pipeline_args pipeline = {stages, nstages, dst};
+  size_t i;
+
+  ASSERT_HANDLE_VALID(handle);
+  if ((stages == NULL && nstages > 0) || dst == handle)
+    return UTILS_ERROR;
+  for (i = 0; i < nstages; i++)
+    if (stages[i].op < LIST_STAGE_FILTER || stages[i].op > LIST_STAGE_REDUCE
+	|| stages[i].fn.filter == NULL)
+      return UTILS_ERROR;
+
+  return list_walk(handle, list_pipeline_cbk, &pipeline);
+}
+
 /* list item handles API */
 
 void *
@@ -386,44 +2379,85 @@ list_item_getdata(list_item_t item)
   return item->data;
 }
 
-void *
-list_item_remove(list_t handle, list_item_t item)
+/**
+ * Unlink and release a list item, see list_item_remove.
+ *
+ * @param[in] handle: the list handle
+ * @param[in] item: the item to remove
+ * @return: the data of the removed item
+ */
+static void *
+list_item_take(struct list_handle *handle, struct list_item *item)
 {
   void *data;
 
-  ASSERT_HANDLE_VALID_PTR(handle);
-
   data = item->data;
-  if (handle->base == item) {
-    /* check for single item to update the base correctly */
-    if (item == item->next)
-      handle->base = NULL;
-    else
-      handle->base = item->next;
-  }
-  if (item != item->next) {
-    /* if there is more than one item update the pointers */
-    item->prev->next = item->next;
-    item->next->prev = item->prev;
-  }
-  free(item);
-  handle->len--;
+  LIST_WRLOCK(handle);
+  list_item_unlink(handle, item);
+  LIST_UNLOCK(handle);
+  list_item_release(handle, item);
   return data;
 }
 
+void *
+list_item_remove(list_t handle, list_item_t item)
+{
+  ASSERT_HANDLE_VALID_PTR(handle);
+  if (handle->mode &
+      (LIST_MODE_UNROLLED | LIST_MODE_READONLY | LIST_MODE_INLINE))
+    return NULL;
+  return list_item_take(handle, item);
+}
+
 list_item_t
 list_item_get(list_t handle, int position)
 {
-  struct list_iterator iter;
+  struct list_item *item = NULL;
 
   ASSERT_HANDLE_VALID_PTR(handle);
+  if (handle->mode & (LIST_MODE_UNROLLED | LIST_MODE_MAPPED))
+    return NULL;
 
-  for (list_iter_init(handle, &iter); !list_iter_end(&iter) && position > 0;
-       list_iter_next(&iter))
-    position--;
-  if (list_iter_end(&iter))
+  LIST_RDLOCK(handle);
+  if (position >= 0 && position < handle->len)
+    item = list_item_find(handle, position);
+  LIST_UNLOCK(handle);
+  return item;
+}
+
+list_item_t
+list_find_item(list_t handle, void *data)
+{
+  struct list_item *item = NULL, *curr;
+  int index;
+
+  ASSERT_HANDLE_VALID_PTR(handle);
+  if (handle->mode & (LIST_MODE_UNROLLED | LIST_MODE_MAPPED))
     return NULL;
-  return list_iter_item(&iter);
+
+  LIST_RDLOCK(handle);
+  if (handle->mode & LIST_MODE_HASHED) {
+    item = list_hash_find(handle, data);
+  }
+  else if (handle->mode & LIST_MODE_SPARSE) {
+    /* empty elements are compared as NULL without a constructor,
+       with one the search materializes every gap it walks */
+    index = list_sparse_indexof(handle, data);
+    if (index >= 0)
+      item = list_item_find(handle, index);
+  }
+  else if (handle->base != NULL) {
+    curr = handle->base;
+    do {
+      if (curr->data == data) {
+	item = curr;
+	break;
+      }
+      curr = curr->next;
+    } while (curr != handle->base);
+  }
+  LIST_UNLOCK(handle);
+  return item;
 }
 
 int
@@ -432,8 +2466,15 @@ list_item_delete(list_t handle, list_item_t item)
   void *data;
 
   ASSERT_HANDLE_VALID(handle);
+  /* unrolled and read-only lists have no items to delete */
+  if (handle->mode & (LIST_MODE_UNROLLED | LIST_MODE_READONLY))
+    return UTILS_ERROR;
 
-  data = list_item_remove(handle, item);
+  /* the value of an inline list is released with its item */
+  if (handle->mode & LIST_MODE_INLINE)
+    data = list_item_take(handle, item);
+  else
+    data = list_item_remove(handle, item);
   if (handle->dtor != NULL)
     handle->dtor(data);
   return UTILS_OK;
@@ -450,7 +2491,7 @@ list_iter_item(list_iter_t iter)
 {
   if (iter == NULL)
     return NULL;
-  if (iter->end)
+  if (iter->end || iter->removed)
     return NULL;
   return iter->cursor;
 }
@@ -478,12 +2519,31 @@ list_do_walk(struct list_handle *handle, void *cbk, void *args, bool walk_data)
   if (cbk == NULL)
     return UTILS_ERROR;
 
+  if (handle->mode & LIST_MODE_UNROLLED) {
+    /* unrolled lists have no item handles */
+    if (!walk_data)
+      return UTILS_ERROR;
+    LIST_RDLOCK(handle);
+    err = list_chunk_walk(handle, cbk, args);
+    LIST_UNLOCK(handle);
+    return err;
+  }
+  if ((handle->mode & LIST_MODE_SPARSE) && walk_data)
+    return list_gap_walk(handle, cbk, args);
+  if (handle->mode & LIST_MODE_MAPPED) {
+    /* mapped lists have no item handles */
+    if (!walk_data)
+      return UTILS_ERROR;
+    return list_record_walk(handle, cbk, args);
+  }
+
   if (walk_data)
     data_cbk = cbk;
   else
     item_cbk = cbk;
 
-  for (list_iter_init(handle, &iter); !list_iter_end(&iter);
+  LIST_RDLOCK(handle);
+  for (list_iter_start(handle, &iter); !list_iter_end(&iter);
        list_iter_next(&iter)) {
     if (walk_data)
       err = data_cbk(list_iter_data(&iter), args);
@@ -492,8 +2552,11 @@ list_do_walk(struct list_handle *handle, void *cbk, void *args, bool walk_data)
 
     if (err == UTILS_ITER_STOP)
       break;
-    if (err != UTILS_OK)
+    if (err != UTILS_OK) {
+      LIST_UNLOCK(handle);
       return UTILS_ERROR;
+    }
   }
+  LIST_UNLOCK(handle);
   return UTILS_OK;
 }
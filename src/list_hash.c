@@ -0,0 +1,183 @@
+/**
+ * @file
+ * Data pointer index for hashed lists.
+ * The index is an open addressing table with linear probing keyed
+ * by the item data pointer. Each entry counts the items holding
+ * the same data and points to the item when the data is unique,
+ * a lookup of data held by multiple items scans the list for the
+ * first one.
+ * See list.h for API specification
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "libutils/error.h"
+#include "list_internal.h"
+
+/* capacity of the first table allocation */
+#define HASH_MIN_CAPACITY 16
+
+/**
+ * Hash of a data pointer, fibonacci hashing of the address
+ */
+static size_t
+hash_slot(struct list_hash *hash, void *data)
+{
+  uint64_t key = (uintptr_t)data;
+
+  key *= 0x9e3779b97f4a7c15ULL;
+  return (size_t)(key >> 32) & (hash->capacity - 1);
+}
+
+/**
+ * Find the entry of a data pointer or the free slot where it belongs
+ */
+static struct list_hash_entry *
+hash_lookup(struct list_hash *hash, void *data)
+{
+  struct list_hash_entry *entry;
+  size_t slot;
+
+  slot = hash_slot(hash, data);
+  for (;;) {
+    entry = &hash->entries[slot];
+    if (entry->count == 0 || entry->data == data)
+      return entry;
+    slot = (slot + 1) & (hash->capacity - 1);
+  }
+}
+
+/**
+ * Reallocate the table and move the entries
+ */
+static int
+hash_resize(struct list_handle *handle, size_t capacity)
+{
+  struct list_hash *hash = &handle->hash;
+  struct list_hash_entry *old = hash->entries;
+  size_t old_capacity = hash->capacity;
+  size_t i;
+
+  hash->entries = LIST_ALLOC(handle, capacity *
+			     sizeof(struct list_hash_entry));
+  if (hash->entries == NULL) {
+    hash->entries = old;
+    return UTILS_ERROR;
+  }
+  memset(hash->entries, 0, capacity * sizeof(struct list_hash_entry));
+  hash->capacity = capacity;
+  for (i = 0; i < old_capacity; i++)
+    if (old[i].count > 0)
+      *hash_lookup(hash, old[i].data) = old[i];
+  if (old != NULL)
+    LIST_FREE(handle, old);
+  return UTILS_OK;
+}
+
+int
+list_hash_reserve(struct list_handle *handle, size_t count)
+{
+  struct list_hash *hash = &handle->hash;
+  size_t capacity;
+
+  /* keep the load factor below 3/4 counting one entry per item */
+  capacity = (hash->capacity == 0) ? HASH_MIN_CAPACITY : hash->capacity;
+  while (4 * count >= 3 * capacity)
+    capacity *= 2;
+  if (capacity == hash->capacity)
+    return UTILS_OK;
+  return hash_resize(handle, capacity);
+}
+
+void
+list_hash_insert(struct list_handle *handle, struct list_item *item)
+{
+  struct list_hash_entry *entry;
+
+  entry = hash_lookup(&handle->hash, item->data);
+  if (entry->count++ == 0) {
+    entry->data = item->data;
+    entry->item = item;
+    handle->hash.used++;
+  }
+}
+
+void
+list_hash_remove(struct list_handle *handle, struct list_item *item)
+{
+  struct list_hash *hash = &handle->hash;
+  struct list_hash_entry *entry, *next;
+  size_t slot, home, gap;
+
+  entry = hash_lookup(hash, item->data);
+  if (--entry->count > 0) {
+    if (entry->item == item)
+      entry->item = NULL;
+    /* a lookup of unique data never scans the list, the item is
+     * still linked so the scan skips it */
+    if (entry->count == 1 && entry->item == NULL)
+      for (entry->item = handle->base;
+	   entry->item == item || entry->item->data != item->data;
+	   entry->item = entry->item->next)
+	;
+    return;
+  }
+  hash->used--;
+
+  /* shift back the following entries of the probe sequence */
+  gap = entry - hash->entries;
+  slot = gap;
+  for (;;) {
+    slot = (slot + 1) & (hash->capacity - 1);
+    next = &hash->entries[slot];
+    if (next->count == 0)
+      break;
+    home = hash_slot(hash, next->data);
+    /* the entry can move to the gap if its home is not
+     * cyclically between the gap and its slot */
+    if (((slot - home) & (hash->capacity - 1)) >=
+	((slot - gap) & (hash->capacity - 1))) {
+      hash->entries[gap] = *next;
+      gap = slot;
+    }
+  }
+  hash->entries[gap].count = 0;
+}
+
+struct list_item *
+list_hash_find(struct list_handle *handle, void *data)
+{
+  struct list_hash_entry *entry;
+  struct list_item *curr;
+
+  if (handle->hash.capacity == 0)
+    return NULL;
+  entry = hash_lookup(&handle->hash, data);
+  if (entry->count == 0)
+    return NULL;
+  if (entry->count == 1)
+    return entry->item;
+
+  /* the data is held by multiple items, find the first one */
+  for (curr = handle->base; curr->data != data; curr = curr->next)
+    ;
+  return curr;
+}
+
+void
+list_hash_destroy(struct list_handle *handle)
+{
+  if (handle->hash.entries != NULL)
+    LIST_FREE(handle, handle->hash.entries);
+  handle->hash.entries = NULL;
+  handle->hash.capacity = 0;
+  handle->hash.used = 0;
+}
+
+size_t
+list_hash_memory(struct list_handle *handle)
+{
+  return handle->hash.capacity * sizeof(struct list_hash_entry);
+}
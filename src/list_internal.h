@@ -0,0 +1,594 @@
+/**
+ * @file
+ * Generic list internal data structures shared by the
+ * list implementation modules.
+ */
+
+#ifndef UTILS_LIST_INTERNAL_H
+#define UTILS_LIST_INTERNAL_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "libutils/config.h"
+#include "libutils/list.h"
+
+#ifdef HAVE_PTHREAD_H
+#include <pthread.h>
+#endif
+
+#define ASSERT_HANDLE_VALID(hnd) if (hnd == NULL) return UTILS_ERROR
+#define ASSERT_HANDLE_VALID_PTR(hnd) if (hnd == NULL) return NULL
+
+/* memory of a list, see list_init_ex */
+#define LIST_ALLOC(hnd, size)						\
+  ((hnd)->allocator.alloc((size), (hnd)->allocator.ctx))
+#define LIST_FREE(hnd, ptr)						\
+  ((hnd)->allocator.free((ptr), (hnd)->allocator.ctx))
+
+/* internal locking of concurrent lists, see list_lock_read */
+#ifdef HAVE_PTHREAD_H
+#define LIST_LOCK_OP(hnd, op) do {					\
+    if ((hnd)->mode & LIST_MODE_CONCURRENT)				\
+      op(hnd);								\
+  } while (0)
+#else
+#define LIST_LOCK_OP(hnd, op) do {} while (0)
+#endif
+#define LIST_RDLOCK(hnd) LIST_LOCK_OP(hnd, list_lock_read)
+#define LIST_WRLOCK(hnd) LIST_LOCK_OP(hnd, list_lock_write)
+#define LIST_UNLOCK(hnd) LIST_LOCK_OP(hnd, list_unlock)
+
+/* concurrent lists whose push, append and pop hold only the lock
+ * of the end they modify, the other modes keep indexes shared by
+ * both ends of the list */
+#define LIST_SPLIT_LOCKS(hnd)						\
+  (((hnd)->mode & (LIST_MODE_CONCURRENT | LIST_MODE_INDEXED |		\
+		   LIST_MODE_HASHED | LIST_MODE_UNROLLED)) ==		\
+   LIST_MODE_CONCURRENT)
+
+/* read-only list over a record file, set by list_init_mapped only */
+#define LIST_MODE_MAPPED 0x100
+
+/* published version of a snapshot list, set by list_publish only */
+#define LIST_MODE_VERSION 0x200
+
+/* values stored in the list items, set by list_init_value only */
+#define LIST_MODE_INLINE 0x400
+
+/* value stored in an item of an inline list */
+#define LIST_ITEM_VALUE(hnd, itm)				\
+  ((void *)((char *)(itm) + (hnd)->value_offset))
+
+/* lists rejecting the functions that modify them */
+#define LIST_MODE_READONLY (LIST_MODE_MAPPED | LIST_MODE_VERSION)
+
+/* data of a record of a mapped list */
+#define LIST_RECORD(hnd, pos)					\
+  ((hnd)->records + (size_t)(pos) * (hnd)->record_size)
+
+/**
+ * list item internal representation
+ */
+struct list_item {
+  struct list_item *next;
+  struct list_item *prev;
+  void *data;
+};
+
+/**
+ * list item of an indexed list, the item is linked in the
+ * circular list and in a treap ordered by list position.
+ * The treap is a min-heap on the random priority and
+ * each node keeps the size of its subtree.
+ */
+struct list_rank_node {
+  struct list_item item; /* must be first */
+  struct list_rank_node *parent;
+  struct list_rank_node *left;
+  struct list_rank_node *right;
+  size_t size;
+  unsigned int prio;
+};
+
+/**
+ * gap of a sparse list, a node standing for count empty elements.
+ * The data of a gap node is the address of list_gap_tag.
+ */
+struct list_gap {
+  struct list_item item; /* must be first */
+  size_t count;
+};
+
+extern char list_gap_tag;
+
+#define LIST_ITEM_GAP(itm) ((itm)->data == &list_gap_tag)
+
+/* number of data pointers in an unrolled list chunk,
+ * sized so that a chunk spans two cache lines
+ */
+#define LIST_CHUNK_ITEMS 13
+
+/**
+ * chunk of an unrolled list, the chunks form a circular list
+ * and each one holds up to LIST_CHUNK_ITEMS data pointers in order.
+ */
+struct list_chunk {
+  struct list_chunk *next;
+  struct list_chunk *prev;
+  int count;
+  void *data[LIST_CHUNK_ITEMS];
+};
+
+/**
+ * node pool slab header, the slab items follow the header
+ */
+struct list_slab {
+  struct list_slab *next;
+  size_t nitems;
+};
+
+/**
+ * node pool internal representation,
+ * free items are chained through the next pointer
+ */
+struct list_pool {
+  struct list_slab *slabs;
+  struct list_item *free;
+  size_t slab_items;
+  size_t item_size;
+  int users;
+  bool private_pool; /* destroyed with the last list using it */
+};
+
+/**
+ * entry of the data pointer index, count is zero for free entries
+ * and item is the item holding the data when count is one.
+ */
+struct list_hash_entry {
+  void *data;
+  struct list_item *item;
+  size_t count;
+};
+
+/**
+ * data pointer index of a hashed list
+ */
+struct list_hash {
+  struct list_hash_entry *entries;
+  size_t capacity;
+  size_t used;
+};
+
+/**
+ * list internal representation
+ */
+struct list_handle {
+  struct list_allocator allocator;
+  struct list_item *base;
+  list_ctor_t ctor;
+  list_dtor_t dtor;
+  size_t len;
+  int mode;
+  size_t item_size;
+  /* size and offset of the values of an inline list */
+  size_t value_size;
+  size_t value_offset;
+  struct list_pool *pool;
+  bool mixed; /* some items were not allocated from the pool */
+  struct list_rank_node *root;
+  unsigned int seed;
+  struct list_chunk *chunks;
+  struct list_hash hash;
+  /* last item found by position, not used by concurrent lists */
+  struct list_item *cursor;
+  size_t cursor_pos;
+  /* records of a mapped list and the file image holding them */
+  char *records;
+  size_t record_size;
+  void *image;
+  size_t image_size;
+  /* current version of a snapshot list, see list_snapshot.c */
+  _Atomic(void *) version;
+  struct hazard_domain *versions;
+  /* references to a published version */
+  atomic_int refs;
+#ifdef HAVE_PTHREAD_H
+  /* whole list lock, shared by the head and tail operations */
+  pthread_rwlock_t lock;
+  /* items linked by list_push and list_pop, readers hold it shared */
+  pthread_rwlock_t head_lock;
+  /* appended items not yet linked in the list, a chain ending with
+   * a NULL next pointer, see list_lock_read */
+  pthread_mutex_t tail_lock;
+  struct list_item *stage_first;
+  struct list_item *stage_last;
+  atomic_size_t staged;
+#endif
+};
+
+/* concurrent list internal API, see list.c */
+
+#ifdef HAVE_PTHREAD_H
+/**
+ * Lock a concurrent list for reading. Appends made before the call
+ * are linked in the list first, then the readers exclude list_push
+ * and list_pop but not list_append, whose items stay out of the list
+ * until the next lock.
+ * @param[in] handle: the list handle
+ */
+void list_lock_read(struct list_handle *handle);
+
+/**
+ * Lock a concurrent list for writing, with the appended items linked
+ * in the list.
+ * @param[in] handle: the list handle
+ */
+void list_lock_write(struct list_handle *handle);
+
+/**
+ * Unlock a list locked by list_lock_read or list_lock_write.
+ * @param[in] handle: the list handle
+ */
+void list_unlock(struct list_handle *handle);
+#endif
+
+/**
+ * Initialize an iterator at the head of a list without locking it,
+ * for the functions already holding the list lock.
+ * @param[in] handle: the list handle
+ * @param[out] iter: the iterator
+ */
+void list_iter_start(struct list_handle *handle, list_iter_t iter);
+
+/* indexed list internal API, see list_rank.c */
+
+/**
+ * Insert an item in the position index.
+ * @param[in] handle: the list handle
+ * @param[in] item: the item to insert, allocated as a list_rank_node
+ * @param[in] position: the position of the item, at most the list length
+ */
+void list_rank_insert(struct list_handle *handle, struct list_item *item,
+		      size_t position);
+
+/**
+ * Remove an item from the position index.
+ * @param[in] handle: the list handle
+ * @param[in] item: the item to remove
+ */
+void list_rank_remove(struct list_handle *handle, struct list_item *item);
+
+/**
+ * Find the item at the given position.
+ * @param[in] handle: the list handle
+ * @param[in] position: a valid list position
+ * @return: the list item
+ */
+struct list_item * list_rank_get(struct list_handle *handle, size_t position);
+
+/**
+ * Get the position of an item from the position index.
+ * @param[in] handle: the list handle
+ * @param[in] item: a linked list item
+ * @return: the item position
+ */
+size_t list_rank_position(struct list_handle *handle, struct list_item *item);
+
+/**
+ * Move the index of the items from the given position to the end
+ * of the list to an empty list, in O(log n) time.
+ * @param[in] handle: the list handle
+ * @param[in] out: the list receiving the index, with an empty index
+ * @param[in] position: the first position to move
+ */
+void list_rank_split(struct list_handle *handle, struct list_handle *out,
+		     size_t position);
+
+/**
+ * Move the whole index of a list in the index of another list at
+ * the given position, in O(log n) time.
+ * @param[in] handle: the list handle
+ * @param[in] src: the list giving its index
+ * @param[in] position: the position of the first moved item
+ */
+void list_rank_join(struct list_handle *handle, struct list_handle *src,
+		    size_t position);
+
+/**
+ * Rebuild the position index after the list has been relinked.
+ * @param[in] handle: the list handle
+ */
+void list_rank_rebuild(struct list_handle *handle);
+
+/**
+ * Find the position following the items that compare less than
+ * or equal to the given data in a sorted list.
+ * @param[in] handle: the list handle
+ * @param[in] data: the item data to compare
+ * @param[in] cmp: item data comparator
+ * @return: the insertion position
+ */
+size_t list_rank_upper(struct list_handle *handle, void *data,
+		       list_cmp_t cmp);
+
+/* hashed list internal API, see list_hash.c */
+
+/**
+ * Make sure the data index can hold the given number of items
+ * without growing, so that list_hash_insert can not fail.
+ * @param[in] handle: the list handle
+ * @param[in] count: the number of items
+ * @return: utils error code
+ */
+int list_hash_reserve(struct list_handle *handle, size_t count);
+
+/**
+ * Add a linked item to the data index.
+ * @param[in] handle: the list handle
+ * @param[in] item: the item, with its data set
+ */
+void list_hash_insert(struct list_handle *handle, struct list_item *item);
+
+/**
+ * Remove an item from the data index, before unlinking it.
+ * @param[in] handle: the list handle
+ * @param[in] item: the item to remove
+ */
+void list_hash_remove(struct list_handle *handle, struct list_item *item);
+
+/**
+ * Find the first item holding the given data.
+ * @param[in] handle: the list handle
+ * @param[in] data: the item data
+ * @return: the list item or NULL
+ */
+struct list_item * list_hash_find(struct list_handle *handle, void *data);
+
+/**
+ * Release the data index.
+ * @param[in] handle: the list handle
+ */
+void list_hash_destroy(struct list_handle *handle);
+
+/**
+ * Get the memory used by the data index.
+ * @param[in] handle: the list handle
+ * @return: size in bytes
+ */
+size_t list_hash_memory(struct list_handle *handle);
+
+/* sparse list internal API, see list_sparse.c */
+
+/**
+ * Find the node holding the given position, the node is
+ * a gap if the element at the position is empty.
+ * @param[in] handle: the list handle
+ * @param[in] position: a valid list position
+ * @param[out] offset: the offset of the position in the node
+ * @return: the list node
+ */
+struct list_item * list_gap_find(struct list_handle *handle,
+				 size_t position, size_t *offset);
+
+/**
+ * Materialize an empty element of a gap in a list item,
+ * the item data is built by the constructor from NULL.
+ * @param[in] handle: the list handle
+ * @param[in] gap: the gap node
+ * @param[in] offset: the offset of the element in the gap
+ * @return: the list item or NULL
+ */
+struct list_item * list_gap_fill(struct list_handle *handle,
+				 struct list_item *gap, size_t offset);
+
+/**
+ * Find the item at the given position, materializing it if empty.
+ * @param[in] handle: the list handle
+ * @param[in] position: a valid list position
+ * @return: the list item or NULL
+ */
+struct list_item * list_gap_item(struct list_handle *handle,
+				 size_t position);
+
+/**
+ * Append empty elements to the end of the list.
+ * @param[in] handle: the list handle
+ * @param[in] count: the number of elements
+ * @return: utils error code
+ */
+int list_gap_append(struct list_handle *handle, size_t count);
+
+/**
+ * Split the gap holding the given position so that the
+ * position is the first of a node.
+ * @param[in] handle: the list handle
+ * @param[in] position: the position, at most the list length
+ * @return: utils error code
+ */
+int list_gap_split(struct list_handle *handle, size_t position);
+
+/**
+ * Drop an empty element from a gap, the gap is released
+ * with its last element.
+ * @param[in] handle: the list handle
+ * @param[in] gap: the gap node
+ */
+void list_gap_shrink(struct list_handle *handle, struct list_item *gap);
+
+/**
+ * Materialize all the empty elements of the list.
+ * @param[in] handle: the list handle
+ * @return: utils error code
+ */
+int list_gap_expand(struct list_handle *handle);
+
+/**
+ * Walk the sparse list data, see list_walk. Empty elements
+ * are materialized only if the list has a constructor.
+ * @param[in] handle: the list handle
+ * @param[in] cbk: callback to be run for each item
+ * @param[in,out] args: extra arguments given to the callback
+ * @return: utils error code
+ */
+int list_gap_walk(struct list_handle *handle, list_cbk_t cbk, void *args);
+
+/* snapshot list internal API, see list_snapshot.c */
+
+/**
+ * Set up the version domain of a snapshot list and publish its
+ * first, empty version.
+ * @param[in] handle: the list handle
+ * @return: utils error code
+ */
+int list_snapshot_setup(struct list_handle *handle);
+
+/**
+ * Drop the current version of a snapshot list and release its
+ * version domain. The snapshots still held stay valid until they
+ * are released.
+ * @param[in] handle: the list handle
+ */
+void list_snapshot_teardown(struct list_handle *handle);
+
+/* mapped list internal API, see list_mapped.c */
+
+/**
+ * Unmap the image of a mapped list, the list is left empty.
+ * @param[in] handle: the list handle
+ */
+void list_mapped_release(struct list_handle *handle);
+
+/**
+ * Walk the records of a mapped list, see list_walk. The data given
+ * to the callback is the address of the record in the image.
+ * @param[in] handle: the list handle
+ * @param[in] cbk: callback to be run for each record
+ * @param[in,out] args: extra arguments given to the callback
+ * @return: utils error code
+ */
+int list_record_walk(struct list_handle *handle, list_cbk_t cbk, void *args);
+
+/**
+ * Find the position of a record in a mapped list.
+ * @param[in] handle: the list handle
+ * @param[in] data: the address of a record
+ * @return: the position of the record, or -1 if data is not the
+ * address of a record of the list
+ */
+int list_record_indexof(struct list_handle *handle, void *data);
+
+/* unrolled list internal API, see list_unrolled.c */
+
+/**
+ * Insert constructed data in the unrolled list.
+ * @param[in] handle: the list handle
+ * @param[in] data: the item data
+ * @param[in] position: the item position, at most the list length
+ * @return: utils error code
+ */
+int list_chunk_insert(struct list_handle *handle, void *data,
+		      size_t position);
+
+/**
+ * Remove the data at the given position from the unrolled list.
+ * @param[in] handle: the list handle
+ * @param[in] position: a valid list position
+ * @return: the item data
+ */
+void * list_chunk_remove(struct list_handle *handle, size_t position);
+
+/**
+ * Remove the data at the given chunk slot from the unrolled list.
+ * On return the chunk and slot refer to the data that followed the
+ * removed one, the chunk is NULL if the removed data was the last.
+ * @param[in] handle: the list handle
+ * @param[in,out] pchunk: the chunk holding the data
+ * @param[in,out] pslot: the slot of the data in the chunk
+ * @return: the item data
+ */
+void * list_chunk_remove_at(struct list_handle *handle,
+			    struct list_chunk **pchunk, int *pslot);
+
+/**
+ * Find the chunk holding the given position.
+ * @param[in] handle: the list handle
+ * @param[in] position: a valid list position
+ * @param[out] slot: the slot of the position in the chunk
+ * @return: the chunk
+ */
+struct list_chunk * list_chunk_find(struct list_handle *handle,
+				    size_t position, int *slot);
+
+/**
+ * Release all the chunks of an unrolled list,
+ * the destructor is called for each item.
+ * @param[in] handle: the list handle
+ */
+void list_chunk_destroy(struct list_handle *handle);
+
+/**
+ * Walk the unrolled list data, see list_walk.
+ * @param[in] handle: the list handle
+ * @param[in] cbk: callback to be run for each item
+ * @param[in,out] args: extra arguments given to the callback
+ * @return: utils error code
+ */
+int list_chunk_walk(struct list_handle *handle, list_cbk_t cbk, void *args);
+
+/**
+ * Remove the unrolled list data for which the predicate is false,
+ * see list_filter. The kept data is packed in the first chunks and
+ * the chunks left empty are released.
+ * @param[in] handle: the list handle
+ * @param[in] pred: predicate run for each item
+ * @param[in,out] args: extra arguments given to the predicate
+ */
+void list_chunk_filter(struct list_handle *handle, list_pred_t pred,
+		       void *args);
+
+/**
+ * Move the data from the given position to the end of the list
+ * to an empty unrolled list. The chunk holding the position is
+ * split, the function fails only if the new chunk can not be
+ * allocated and the lists are left unchanged.
+ * @param[in] handle: the list handle
+ * @param[in] out: the empty list receiving the data
+ * @param[in] position: the first position to move, less than the list length
+ * @return: utils error code
+ */
+int list_chunk_split(struct list_handle *handle, struct list_handle *out,
+		     size_t position);
+
+/**
+ * Move all the chunks of a list in another list at the given
+ * position, see list_chunk_split.
+ * @param[in] handle: the list handle
+ * @param[in] src: the non empty list giving its chunks
+ * @param[in] position: the position of the first moved item
+ * @return: utils error code
+ */
+int list_chunk_join(struct list_handle *handle, struct list_handle *src,
+		    size_t position);
+
+/**
+ * Stable sort of the unrolled list data, see list_sort.
+ * @param[in] handle: the list handle
+ * @param[in] cmp: item data comparator
+ * @return: utils error code
+ */
+int list_chunk_sort(struct list_handle *handle, list_cmp_t cmp);
+
+/**
+ * Find the insertion position in a sorted unrolled list,
+ * see list_rank_upper.
+ * @param[in] handle: the list handle
+ * @param[in] data: the item data to compare
+ * @param[in] cmp: item data comparator
+ * @return: the insertion position
+ */
+size_t list_chunk_upper(struct list_handle *handle, void *data,
+			list_cmp_t cmp);
+
+#endif /* UTILS_LIST_INTERNAL_H */
@@ -0,0 +1,317 @@
+/**
+ * @file
+ * List serialization and mapped record lists.
+ * A record file is a fixed header followed by the list data encoded
+ * in fixed-size records. A mapped list reads the records in place,
+ * the data pointer of an item is the address of its record so that
+ * no list item is ever allocated.
+ * See list.h for API specification
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "libutils/error.h"
+#include "list_internal.h"
+
+#ifdef HAVE_SYS_MMAN_H
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#define LIST_FILE_MAGIC "UTILSLST"
+#define LIST_FILE_VERSION 1
+
+/* number of records encoded or decoded at once */
+#define LIST_FILE_BLOCK 1024
+
+/**
+ * record file header, the records start right after it
+ */
+struct list_file_header {
+  char magic[8];
+  uint32_t version;
+  uint32_t record_size;
+  uint64_t count;
+  uint64_t reserved;
+};
+
+/**
+ * state of the serialization walk
+ */
+struct list_encoder {
+  FILE *stream;
+  list_encode_t encode;
+  void *args;
+  size_t record_size;
+  char *block;
+  size_t used;
+  size_t count;
+};
+
+/**
+ * Check the header of a record file
+ */
+static int
+list_header_check(const struct list_file_header *header)
+{
+  if (memcmp(header->magic, LIST_FILE_MAGIC, sizeof(header->magic)) ||
+      header->version != LIST_FILE_VERSION || header->record_size == 0)
+    return UTILS_ERROR;
+  return UTILS_OK;
+}
+
+/**
+ * Write the encoded records of the block to the stream
+ */
+static int
+list_encoder_flush(struct list_encoder *enc)
+{
+  if (enc->used > 0 &&
+      fwrite(enc->block, enc->record_size, enc->used,
+	     enc->stream) != enc->used)
+    return UTILS_ERROR;
+  enc->used = 0;
+  return UTILS_OK;
+}
+
+/**
+ * list_walk callback encoding an item into the block
+ */
+static int
+list_encoder_cbk(void *itm_data, void *args)
+{
+  struct list_encoder *enc = args;
+  char *record;
+
+  record = enc->block + enc->used * enc->record_size;
+  memset(record, 0, enc->record_size);
+  if (enc->encode(itm_data, record, enc->args))
+    return UTILS_ERROR;
+  enc->count++;
+  if (++enc->used == LIST_FILE_BLOCK)
+    return list_encoder_flush(enc);
+  return UTILS_OK;
+}
+
+/* list serialization API */
+
+int
+list_serialize(list_t handle, FILE *stream, size_t record_size,
+	       list_encode_t encode, void *args)
+{
+  struct list_file_header header;
+  struct list_encoder enc;
+  int err;
+
+  ASSERT_HANDLE_VALID(handle);
+  if (stream == NULL || encode == NULL || record_size == 0 ||
+      record_size > UINT32_MAX)
+    return UTILS_ERROR;
+
+  /* nothing is written if the record block can not be allocated */
+  enc.block = LIST_ALLOC(handle, LIST_FILE_BLOCK * record_size);
+  if (enc.block == NULL)
+    return UTILS_ERROR;
+
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, LIST_FILE_MAGIC, sizeof(header.magic));
+  header.version = LIST_FILE_VERSION;
+  header.record_size = record_size;
+  header.count = list_length(handle);
+  if (fwrite(&header, sizeof(header), 1, stream) != 1) {
+    LIST_FREE(handle, enc.block);
+    return UTILS_ERROR;
+  }
+
+  enc.stream = stream;
+  enc.encode = encode;
+  enc.args = args;
+  enc.record_size = record_size;
+  enc.used = 0;
+  enc.count = 0;
+
+  err = list_walk(handle, list_encoder_cbk, &enc);
+  if (!err)
+    err = list_encoder_flush(&enc);
+  LIST_FREE(handle, enc.block);
+  /* a concurrent list may have changed since the header was written */
+  if (!err && enc.count != header.count)
+    err = UTILS_ERROR;
+  return err;
+}
+
+int
+list_deserialize(list_t handle, FILE *stream, list_decode_t decode,
+		 void *args)
+{
+  struct list_file_header header;
+  void *data[LIST_FILE_BLOCK];
+  uint64_t left;
+  size_t i, count;
+  char *block;
+  int err = UTILS_OK;
+
+  ASSERT_HANDLE_VALID(handle);
+  if (stream == NULL || decode == NULL)
+    return UTILS_ERROR;
+
+  if (fread(&header, sizeof(header), 1, stream) != 1 ||
+      list_header_check(&header))
+    return UTILS_ERROR;
+  block = LIST_ALLOC(handle, (size_t)LIST_FILE_BLOCK * header.record_size);
+  if (block == NULL)
+    return UTILS_ERROR;
+
+  for (left = header.count; left > 0 && !err; left -= count) {
+    count = (left < LIST_FILE_BLOCK) ? left : LIST_FILE_BLOCK;
+    if (fread(block, header.record_size, count, stream) != count) {
+      err = UTILS_ERROR;
+      break;
+    }
+    for (i = 0; i < count; i++)
+      if (decode(block + i * header.record_size, &data[i], args)) {
+	err = UTILS_ERROR;
+	break;
+      }
+    /* the records decoded before a failure are kept */
+    if (list_append_n(handle, data, i))
+      err = UTILS_ERROR;
+  }
+  LIST_FREE(handle, block);
+  return err;
+}
+
+/* mapped list API */
+
+/**
+ * Load the image of a record file, mapped read-only when the
+ * platform supports it
+ */
+static int
+list_image_load(struct list_handle *handle, const char *path)
+{
+#ifdef HAVE_SYS_MMAN_H
+  struct stat st;
+  void *image;
+  int fd;
+
+  fd = open(path, O_RDONLY);
+  if (fd < 0)
+    return UTILS_ERROR;
+  if (fstat(fd, &st) || (size_t)st.st_size < sizeof(struct list_file_header)) {
+    close(fd);
+    return UTILS_ERROR;
+  }
+  image = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (image == MAP_FAILED)
+    return UTILS_ERROR;
+  handle->image = image;
+  handle->image_size = st.st_size;
+#else
+  FILE *stream;
+  long size;
+
+  stream = fopen(path, "rb");
+  if (stream == NULL)
+    return UTILS_ERROR;
+  if (fseek(stream, 0, SEEK_END) || (size = ftell(stream)) < 0 ||
+      (size_t)size < sizeof(struct list_file_header) ||
+      fseek(stream, 0, SEEK_SET)) {
+    fclose(stream);
+    return UTILS_ERROR;
+  }
+  handle->image = malloc(size);
+  if (handle->image == NULL) {
+    fclose(stream);
+    return UTILS_ERROR;
+  }
+  handle->image_size = size;
+  if (fread(handle->image, size, 1, stream) != 1) {
+    fclose(stream);
+    list_mapped_release(handle);
+    return UTILS_ERROR;
+  }
+  fclose(stream);
+#endif
+  return UTILS_OK;
+}
+
+int
+list_init_mapped(list_t *phandle, const char *path)
+{
+  struct list_file_header header;
+  list_t handle;
+
+  if (path == NULL || list_init_mode(phandle, NULL, NULL, 0))
+    return UTILS_ERROR;
+  handle = *phandle;
+  handle->mode |= LIST_MODE_MAPPED;
+  if (list_image_load(handle, path))
+    goto error;
+
+  memcpy(&header, handle->image, sizeof(header));
+  if (list_header_check(&header) ||
+      header.count > (handle->image_size - sizeof(header)) /
+      header.record_size)
+    goto error;
+  handle->records = (char *)handle->image + sizeof(header);
+  handle->record_size = header.record_size;
+  handle->len = header.count;
+  return UTILS_OK;
+
+ error:
+  list_destroy(handle);
+  *phandle = NULL;
+  return UTILS_ERROR;
+}
+
+void
+list_mapped_release(struct list_handle *handle)
+{
+  if (handle->image == NULL)
+    return;
+#ifdef HAVE_SYS_MMAN_H
+  munmap(handle->image, handle->image_size);
+#else
+  free(handle->image);
+#endif
+  handle->image = NULL;
+  handle->records = NULL;
+  handle->len = 0;
+}
+
+int
+list_record_walk(struct list_handle *handle, list_cbk_t cbk, void *args)
+{
+  size_t i;
+  int err;
+
+  for (i = 0; i < handle->len; i++) {
+    err = cbk(LIST_RECORD(handle, i), args);
+    if (err == UTILS_ITER_STOP)
+      break;
+    if (err != UTILS_OK)
+      return UTILS_ERROR;
+  }
+  return UTILS_OK;
+}
+
+int
+list_record_indexof(struct list_handle *handle, void *data)
+{
+  size_t offset;
+
+  /* the data of a record is its address, the position follows */
+  if ((char *)data < handle->records ||
+      (char *)data >= LIST_RECORD(handle, handle->len))
+    return -1;
+  offset = (char *)data - handle->records;
+  if (offset % handle->record_size)
+    return -1;
+  return offset / handle->record_size;
+}
@@ -0,0 +1,179 @@
+/**
+ * @file
+ * Parallel list walk.
+ * The list is split in contiguous ranges of items, each range is
+ * walked by its own thread. The threads share a stop flag that is
+ * checked before each callback so that a stop request or an error
+ * ends the walk of all the ranges as soon as possible.
+ * See list.h for API specification
+ */
+
+#include <stdlib.h>
+
+#include "libutils/error.h"
+#include "list_internal.h"
+
+#ifdef HAVE_PTHREAD_H
+#include <stdatomic.h>
+
+/* maximum number of threads used by a walk */
+#define LIST_WALK_MAX_THREADS 64
+
+/* shared state of a parallel walk */
+struct walk_state {
+  list_cbk_t cbk;
+  void *args;
+  atomic_int stop;
+  atomic_int err;
+};
+
+/* range of the list walked by a thread */
+struct walk_range {
+  struct walk_state *state;
+  struct list_item *item;
+  struct list_chunk *chunk;
+  int slot;
+  size_t count;
+};
+
+/**
+ * Walk a range of the list, the first callback error is recorded
+ * in the shared state.
+ */
+static void *
+walk_range(void *data)
+{
+  struct walk_range *range = data;
+  struct walk_state *state = range->state;
+  struct list_item *item = range->item;
+  struct list_chunk *chunk = range->chunk;
+  int slot = range->slot;
+  void *itm_data;
+  size_t i;
+  int err;
+
+  for (i = 0; i < range->count; i++) {
+    if (atomic_load_explicit(&state->stop, memory_order_relaxed))
+      break;
+    if (chunk != NULL) {
+      if (slot == chunk->count) {
+	chunk = chunk->next;
+	slot = 0;
+      }
+      itm_data = chunk->data[slot++];
+    }
+    else {
+      itm_data = item->data;
+      item = item->next;
+    }
+    err = state->cbk(itm_data, state->args);
+    if (err == UTILS_OK)
+      continue;
+    if (err != UTILS_ITER_STOP)
+      atomic_store(&state->err, UTILS_ERROR);
+    atomic_store(&state->stop, 1);
+    break;
+  }
+  return NULL;
+}
+
+/**
+ * Find the start of each range, the ranges have the same length
+ * and cover the list in order.
+ */
+static void
+walk_split(struct list_handle *handle, struct walk_range *ranges, int nranges)
+{
+  struct list_item *item = handle->base;
+  struct list_chunk *chunk = handle->chunks;
+  size_t start = 0, position = 0, len = handle->len;
+  int i, slot = 0;
+
+  for (i = 0; i < nranges; i++) {
+    ranges[i].count = len / nranges + ((size_t)i < len % nranges);
+    if (handle->mode & LIST_MODE_UNROLLED) {
+      /* skip the chunks before the range start */
+      while (start - position >= (size_t)chunk->count) {
+	position += chunk->count;
+	chunk = chunk->next;
+      }
+      slot = start - position;
+    }
+    else if (handle->mode & LIST_MODE_INDEXED) {
+      item = list_rank_get(handle, start);
+    }
+    else {
+      for (; position < start; position++)
+	item = item->next;
+    }
+    ranges[i].item = item;
+    ranges[i].chunk = (handle->mode & LIST_MODE_UNROLLED) ? chunk : NULL;
+    ranges[i].slot = slot;
+    start += ranges[i].count;
+  }
+}
+
+int
+list_walk_parallel(list_t handle, list_cbk_t cbk, void *args, int nthreads)
+{
+  pthread_t threads[LIST_WALK_MAX_THREADS];
+  struct walk_range ranges[LIST_WALK_MAX_THREADS];
+  struct walk_state state;
+  int i, started;
+
+  ASSERT_HANDLE_VALID(handle);
+  if (cbk == NULL || nthreads <= 0)
+    return UTILS_ERROR;
+  if (nthreads > LIST_WALK_MAX_THREADS)
+    nthreads = LIST_WALK_MAX_THREADS;
+
+  LIST_RDLOCK(handle);
+  /* a thread walks at least one item */
+  if ((size_t)nthreads > handle->len)
+    nthreads = handle->len;
+  /* the gaps of sparse lists are materialized by the serial walk,
+   * mapped lists are walked serially too */
+  if (nthreads <= 1 ||
+      (handle->mode & (LIST_MODE_SPARSE | LIST_MODE_MAPPED))) {
+    LIST_UNLOCK(handle);
+    return list_walk(handle, cbk, args);
+  }
+
+  state.cbk = cbk;
+  state.args = args;
+  atomic_init(&state.stop, 0);
+  atomic_init(&state.err, UTILS_OK);
+  walk_split(handle, ranges, nthreads);
+
+  /* the calling thread walks the first range */
+  for (started = 1; started < nthreads; started++) {
+    ranges[started].state = &state;
+    if (pthread_create(&threads[started], NULL, walk_range,
+		       &ranges[started]))
+      break;
+  }
+  /* the ranges that could not be started are walked serially */
+  ranges[0].state = &state;
+  walk_range(&ranges[0]);
+  for (i = started; i < nthreads; i++) {
+    ranges[i].state = &state;
+    walk_range(&ranges[i]);
+  }
+  for (i = 1; i < started; i++)
+    pthread_join(threads[i], NULL);
+  LIST_UNLOCK(handle);
+
+  return atomic_load(&state.err);
+}
+
+#else /* HAVE_PTHREAD_H */
+
+int
+list_walk_parallel(list_t handle, list_cbk_t cbk, void *args, int nthreads)
+{
+  if (nthreads <= 0)
+    return UTILS_ERROR;
+  return list_walk(handle, cbk, args);
+}
+
+#endif /* HAVE_PTHREAD_H */
@@ -0,0 +1,298 @@
+/**
+ * @file
+ * Position index for indexed lists.
+ * The index is a treap with parent pointers where the in-order
+ * visit follows the list order, the key of each node is implicit
+ * and given by the size of the subtrees on its left.
+ * See list.h for API specification
+ */
+
+#include <stdlib.h>
+
+#include "libutils/error.h"
+#include "list_internal.h"
+
+#define RANK_NODE(itm) ((struct list_rank_node *)(itm))
+
+static size_t
+rank_size(struct list_rank_node *node)
+{
+  return (node == NULL) ? 0 : node->size;
+}
+
+static void
+rank_update(struct list_rank_node *node)
+{
+  node->size = 1 + rank_size(node->left) + rank_size(node->right);
+}
+
+/**
+ * Random treap priority, xorshift generator seeded in the list handle
+ */
+static unsigned int
+rank_prio(struct list_handle *handle)
+{
+  unsigned int x = handle->seed;
+
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  handle->seed = x;
+  return x;
+}
+
+/**
+ * Replace the child of the parent node, or the root.
+ */
+static void
+rank_replace_child(struct list_handle *handle, struct list_rank_node *parent,
+		   struct list_rank_node *old, struct list_rank_node *new)
+{
+  if (parent == NULL)
+    handle->root = new;
+  else if (parent->left == old)
+    parent->left = new;
+  else
+    parent->right = new;
+  if (new != NULL)
+    new->parent = parent;
+}
+
+/**
+ * Rotate a node above its parent, keeping the in-order visit.
+ */
+static void
+rank_rotate_up(struct list_handle *handle, struct list_rank_node *node)
+{
+  struct list_rank_node *parent = node->parent;
+
+  rank_replace_child(handle, parent->parent, parent, node);
+  if (parent->left == node) {
+    parent->left = node->right;
+    if (node->right != NULL)
+      node->right->parent = parent;
+    node->right = parent;
+  }
+  else {
+    parent->right = node->left;
+    if (node->left != NULL)
+      node->left->parent = parent;
+    node->left = parent;
+  }
+  parent->parent = node;
+  rank_update(parent);
+  rank_update(node);
+}
+
+void
+list_rank_insert(struct list_handle *handle, struct list_item *item,
+		 size_t position)
+{
+  struct list_rank_node *node = RANK_NODE(item);
+  struct list_rank_node *curr, *parent;
+  bool left;
+
+  node->left = NULL;
+  node->right = NULL;
+  node->size = 1;
+  node->prio = rank_prio(handle);
+
+  /* descend to the leaf slot for the position,
+   * growing the subtrees on the way
+   */
+  parent = NULL;
+  left = false;
+  curr = handle->root;
+  while (curr != NULL) {
+    curr->size++;
+    parent = curr;
+    if (position <= rank_size(curr->left)) {
+      left = true;
+      curr = curr->left;
+    }
+    else {
+      position -= rank_size(curr->left) + 1;
+      left = false;
+      curr = curr->right;
+    }
+  }
+  node->parent = parent;
+  if (parent == NULL)
+    handle->root = node;
+  else if (left)
+    parent->left = node;
+  else
+    parent->right = node;
+
+  /* restore the heap property */
+  while (node->parent != NULL && node->prio < node->parent->prio)
+    rank_rotate_up(handle, node);
+}
+
+void
+list_rank_remove(struct list_handle *handle, struct list_item *item)
+{
+  struct list_rank_node *node = RANK_NODE(item);
+  struct list_rank_node *child, *parent;
+
+  /* rotate the node down until it has at most one child */
+  while (node->left != NULL && node->right != NULL) {
+    if (node->left->prio < node->right->prio)
+      child = node->left;
+    else
+      child = node->right;
+    rank_rotate_up(handle, child);
+  }
+  child = (node->left != NULL) ? node->left : node->right;
+  parent = node->parent;
+  rank_replace_child(handle, parent, node, child);
+
+  for (; parent != NULL; parent = parent->parent)
+    parent->size--;
+}
+
+struct list_item *
+list_rank_get(struct list_handle *handle, size_t position)
+{
+  struct list_rank_node *curr = handle->root;
+  size_t left_size;
+
+  while (curr != NULL) {
+    left_size = rank_size(curr->left);
+    if (position == left_size)
+      break;
+    if (position < left_size) {
+      curr = curr->left;
+    }
+    else {
+      position -= left_size + 1;
+      curr = curr->right;
+    }
+  }
+  return (curr == NULL) ? NULL : &curr->item;
+}
+
+/**
+ * Join two treaps, all the nodes of the first one precede the
+ * nodes of the second one in list order.
+ */
+static struct list_rank_node *
+rank_join(struct list_rank_node *a, struct list_rank_node *b)
+{
+  if (a == NULL)
+    return b;
+  if (b == NULL)
+    return a;
+  if (a->prio < b->prio) {
+    a->right = rank_join(a->right, b);
+    a->right->parent = a;
+    rank_update(a);
+    return a;
+  }
+  b->left = rank_join(a, b->left);
+  b->left->parent = b;
+  rank_update(b);
+  return b;
+}
+
+/**
+ * Split a treap, the first nodes up to the given position go
+ * to the left treap and the others to the right treap.
+ */
+static void
+rank_split(struct list_rank_node *node, size_t position,
+	   struct list_rank_node **left, struct list_rank_node **right)
+{
+  if (node == NULL) {
+    *left = NULL;
+    *right = NULL;
+    return;
+  }
+  if (rank_size(node->left) < position) {
+    rank_split(node->right, position - rank_size(node->left) - 1,
+	       &node->right, right);
+    if (node->right != NULL)
+      node->right->parent = node;
+    rank_update(node);
+    *left = node;
+  }
+  else {
+    rank_split(node->left, position, left, &node->left);
+    if (node->left != NULL)
+      node->left->parent = node;
+    rank_update(node);
+    *right = node;
+  }
+}
+
+void
+list_rank_split(struct list_handle *handle, struct list_handle *out,
+		size_t position)
+{
+  rank_split(handle->root, position, &handle->root, &out->root);
+  if (handle->root != NULL)
+    handle->root->parent = NULL;
+  if (out->root != NULL)
+    out->root->parent = NULL;
+}
+
+void
+list_rank_join(struct list_handle *handle, struct list_handle *src,
+	       size_t position)
+{
+  struct list_rank_node *left, *right;
+
+  rank_split(handle->root, position, &left, &right);
+  handle->root = rank_join(rank_join(left, src->root), right);
+  if (handle->root != NULL)
+    handle->root->parent = NULL;
+  src->root = NULL;
+}
+
+size_t
+list_rank_position(struct list_handle *handle, struct list_item *item)
+{
+  struct list_rank_node *node = RANK_NODE(item);
+  size_t position;
+
+  position = rank_size(node->left);
+  for (; node->parent != NULL; node = node->parent)
+    if (node->parent->right == node)
+      position += rank_size(node->parent->left) + 1;
+  return position;
+}
+
+void
+list_rank_rebuild(struct list_handle *handle)
+{
+  struct list_item *item;
+  size_t position;
+
+  handle->root = NULL;
+  if (handle->base == NULL)
+    return;
+  item = handle->base;
+  position = 0;
+  do {
+    list_rank_insert(handle, item, position++);
+    item = item->next;
+  } while (item != handle->base);
+}
+
+size_t
+list_rank_upper(struct list_handle *handle, void *data, list_cmp_t cmp)
+{
+  struct list_rank_node *curr = handle->root;
+  size_t position = 0;
+
+  while (curr != NULL) {
+    if (cmp(data, curr->item.data) < 0) {
+      curr = curr->left;
+    }
+    else {
+      position += rank_size(curr->left) + 1;
+      curr = curr->right;
+    }
+  }
+  return position;
+}
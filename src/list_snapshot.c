@@ -0,0 +1,183 @@
+/**
+ * @file
+ * Snapshot lists.
+ * The published versions of a list are immutable lists swapped
+ * atomically in the list handle. A version is reference counted by
+ * the list handle and by its snapshots; readers protect the current
+ * version with a hazard pointer only while taking their reference, so
+ * that the reference of the list handle on a replaced version is
+ * dropped when no reader can be about to take one.
+ * See list.h for API specification
+ */
+
+#include <stdlib.h>
+
+#include "libutils/error.h"
+#include "hazard.h"
+#include "list_internal.h"
+
+/* list modes kept by the published versions */
+#define LIST_VERSION_MODES (LIST_MODE_INDEXED | LIST_MODE_UNROLLED |	\
+			    LIST_MODE_HASHED)
+
+/* hazard pointer slot protecting the current version */
+#define HP_VERSION 0
+
+/**
+ * Drop a reference to a version, the last one frees it
+ */
+static void
+list_version_put(struct list_handle *version)
+{
+  if (atomic_fetch_sub(&version->refs, 1) == 1) {
+    version->mode &= ~LIST_MODE_VERSION;
+    list_destroy(version);
+  }
+}
+
+/**
+ * Hazard reclaim callback, drops the reference of the list handle
+ * on a replaced version
+ */
+static void
+list_version_reclaim(void *ptr, void *args)
+{
+  list_version_put(ptr);
+}
+
+/**
+ * Build a version holding a copy of the list, the items are
+ * constructed under the read lock so that the data can not be
+ * destructed by a concurrent writer before it is copied.
+ *
+ * @param[in] handle: the list handle
+ * @return: the version with a single reference or NULL
+ */
+static struct list_handle *
+list_version_new(struct list_handle *handle)
+{
+  struct list_handle *version;
+  list_iter_struct_t iter;
+  void **data = NULL;
+  size_t count = 0;
+  int err = UTILS_OK;
+
+  if (list_init_ex(&version, handle->ctor, handle->dtor,
+		   handle->mode & LIST_VERSION_MODES, &handle->allocator))
+    return NULL;
+
+  LIST_RDLOCK(handle);
+  if (handle->len > 0) {
+    data = LIST_ALLOC(handle, handle->len * sizeof(void *));
+    if (data == NULL)
+      err = UTILS_ERROR;
+  }
+  if (!err) {
+    for (list_iter_start(handle, &iter); !list_iter_end(&iter);
+	 list_iter_next(&iter))
+      data[count++] = list_iter_data(&iter);
+    err = list_append_n(version, data, count);
+  }
+  LIST_UNLOCK(handle);
+  if (data != NULL)
+    LIST_FREE(handle, data);
+
+  if (err) {
+    list_destroy(version);
+    return NULL;
+  }
+  version->mode |= LIST_MODE_VERSION;
+  atomic_store(&version->refs, 1);
+  return version;
+}
+
+/* snapshot list internal API */
+
+int
+list_snapshot_setup(struct list_handle *handle)
+{
+  handle->versions = LIST_ALLOC(handle, sizeof(struct hazard_domain));
+  if (handle->versions == NULL)
+    return UTILS_ERROR;
+  hazard_init(handle->versions, list_version_reclaim, NULL);
+  /* readers always find a version */
+  return list_publish(handle);
+}
+
+void
+list_snapshot_teardown(struct list_handle *handle)
+{
+  struct list_handle *version;
+
+  if (handle->versions == NULL)
+    return;
+  version = atomic_exchange(&handle->version, NULL);
+  if (version != NULL)
+    list_version_put(version);
+  hazard_destroy(handle->versions);
+  LIST_FREE(handle, handle->versions);
+  handle->versions = NULL;
+}
+
+/* list snapshot API */
+
+int
+list_publish(list_t handle)
+{
+  struct list_handle *version, *old;
+  struct hazard_record *hp;
+  int err = UTILS_OK;
+
+  ASSERT_HANDLE_VALID(handle);
+  if (!(handle->mode & LIST_MODE_SNAPSHOT))
+    return UTILS_ERROR;
+
+  hp = hazard_acquire(handle->versions);
+  if (hp == NULL)
+    return UTILS_ERROR;
+  version = list_version_new(handle);
+  if (version == NULL) {
+    hazard_release(hp);
+    return UTILS_ERROR;
+  }
+
+  old = atomic_exchange(&handle->version, version);
+  if (old != NULL) {
+    /* versions are few and large, reclaim them as soon as possible */
+    err = hazard_retire(handle->versions, hp, old);
+    hazard_scan(handle->versions, hp);
+  }
+  hazard_release(hp);
+  return err;
+}
+
+list_t
+list_snapshot(list_t handle)
+{
+  struct list_handle *version;
+  struct hazard_record *hp;
+
+  ASSERT_HANDLE_VALID_PTR(handle);
+  if (!(handle->mode & LIST_MODE_SNAPSHOT))
+    return NULL;
+
+  hp = hazard_acquire(handle->versions);
+  if (hp == NULL)
+    return NULL;
+  /* the protected version can not be reclaimed before it is referenced */
+  version = hazard_protect(hp, HP_VERSION, &handle->version);
+  atomic_fetch_add(&version->refs, 1);
+  hazard_release(hp);
+  return version;
+}
+
+int
+list_snapshot_release(list_t snapshot)
+{
+  ASSERT_HANDLE_VALID(snapshot);
+  if (!(snapshot->mode & LIST_MODE_VERSION))
+    return UTILS_ERROR;
+
+  list_version_put(snapshot);
+  return UTILS_OK;
+}
@@ -0,0 +1,299 @@
+/**
+ * @file
+ * Gaps of sparse lists.
+ * A run of empty elements, created by inserting past the end of the
+ * list, is stored in a single gap node holding the number of elements.
+ * An empty element is materialized in a list item, with the data built
+ * by the constructor from NULL, only when it is accessed.
+ * See list.h for API specification
+ */
+
+#include <stdlib.h>
+
+#include "libutils/error.h"
+#include "list_internal.h"
+
+#define GAP(itm) ((struct list_gap *)(itm))
+
+/* the data of a gap node, never a valid item data pointer */
+char list_gap_tag;
+
+/**
+ * Number of list positions covered by a node
+ */
+static size_t
+gap_count(struct list_item *item)
+{
+  return LIST_ITEM_GAP(item) ? GAP(item)->count : 1;
+}
+
+static size_t
+gap_distance(size_t a, size_t b)
+{
+  return (a > b) ? a - b : b - a;
+}
+
+/**
+ * Allocate a list node outside of the list pool, the list
+ * is marked as mixed so that the node is not released to the pool.
+ */
+static struct list_item *
+gap_alloc(struct list_handle *handle, size_t size)
+{
+  struct list_item *item;
+
+  item = LIST_ALLOC(handle, size);
+  if (item != NULL && handle->pool != NULL)
+    handle->mixed = true;
+  return item;
+}
+
+/**
+ * Allocate a gap node for the given number of empty elements
+ */
+static struct list_item *
+gap_new(struct list_handle *handle, size_t count)
+{
+  struct list_item *item;
+
+  item = gap_alloc(handle, sizeof(struct list_gap));
+  if (item == NULL)
+    return NULL;
+  item->data = &list_gap_tag;
+  GAP(item)->count = count;
+  return item;
+}
+
+/**
+ * Link a node after another node of the list
+ */
+static void
+gap_link_after(struct list_item *prev, struct list_item *item)
+{
+  item->prev = prev;
+  item->next = prev->next;
+  prev->next->prev = item;
+  prev->next = item;
+}
+
+struct list_item *
+list_gap_find(struct list_handle *handle, size_t position, size_t *offset)
+{
+  struct list_item *curr;
+  size_t from;
+
+  /* walk from the closest of the head, the tail and the cursor,
+   * from is the position of the first element of curr
+   */
+  if (handle->len - 1 - position < position) {
+    curr = handle->base->prev;
+    from = handle->len - gap_count(curr);
+  }
+  else {
+    curr = handle->base;
+    from = 0;
+  }
+  if (handle->cursor != NULL &&
+      gap_distance(handle->cursor_pos, position) <
+      gap_distance(from, position)) {
+    curr = handle->cursor;
+    from = handle->cursor_pos;
+  }
+  while (position >= from + gap_count(curr)) {
+    from += gap_count(curr);
+    curr = curr->next;
+  }
+  while (position < from) {
+    curr = curr->prev;
+    from -= gap_count(curr);
+  }
+
+  handle->cursor = curr;
+  handle->cursor_pos = from;
+  *offset = position - from;
+  return curr;
+}
+
+struct list_item *
+list_gap_fill(struct list_handle *handle, struct list_item *gap,
+	      size_t offset)
+{
+  struct list_item *item, *rest = NULL;
+  size_t count = GAP(gap)->count;
+
+  /* the gap node becomes the item if the element is the first,
+   * otherwise the gap keeps the elements before it
+   */
+  if (offset == 0) {
+    item = gap;
+  }
+  else {
+    item = gap_alloc(handle, handle->item_size);
+    if (item == NULL)
+      return NULL;
+  }
+  if (offset + 1 < count) {
+    rest = gap_new(handle, count - offset - 1);
+    if (rest == NULL) {
+      if (item != gap)
+	LIST_FREE(handle, item);
+      return NULL;
+    }
+  }
+
+  if (item != gap) {
+    GAP(gap)->count = offset;
+    gap_link_after(gap, item);
+  }
+  if (rest != NULL)
+    gap_link_after(item, rest);
+  if (handle->ctor != NULL)
+    handle->ctor(&item->data, NULL);
+  else
+    item->data = NULL;
+
+  /* the position of the gap start is unchanged */
+  if (handle->cursor == gap && item != gap) {
+    handle->cursor = item;
+    handle->cursor_pos += offset;
+  }
+  return item;
+}
+
+struct list_item *
+list_gap_item(struct list_handle *handle, size_t position)
+{
+  struct list_item *item;
+  size_t offset;
+
+  item = list_gap_find(handle, position, &offset);
+  if (LIST_ITEM_GAP(item))
+    item = list_gap_fill(handle, item, offset);
+  return item;
+}
+
+int
+list_gap_append(struct list_handle *handle, size_t count)
+{
+  struct list_item *tail, *gap;
+
+  if (count == 0)
+    return UTILS_OK;
+
+  if (handle->base != NULL && LIST_ITEM_GAP(handle->base->prev)) {
+    /* extend the trailing gap */
+    GAP(handle->base->prev)->count += count;
+    handle->len += count;
+    return UTILS_OK;
+  }
+  gap = gap_new(handle, count);
+  if (gap == NULL)
+    return UTILS_ERROR;
+  if (handle->base == NULL) {
+    gap->next = gap;
+    gap->prev = gap;
+    handle->base = gap;
+  }
+  else {
+    tail = handle->base->prev;
+    gap_link_after(tail, gap);
+  }
+  handle->len += count;
+  return UTILS_OK;
+}
+
+int
+list_gap_split(struct list_handle *handle, size_t position)
+{
+  struct list_item *gap, *rest;
+  size_t offset;
+
+  if (position >= handle->len)
+    return UTILS_OK;
+  gap = list_gap_find(handle, position, &offset);
+  if (offset == 0)
+    return UTILS_OK;
+
+  rest = gap_new(handle, GAP(gap)->count - offset);
+  if (rest == NULL)
+    return UTILS_ERROR;
+  GAP(gap)->count = offset;
+  gap_link_after(gap, rest);
+  return UTILS_OK;
+}
+
+void
+list_gap_shrink(struct list_handle *handle, struct list_item *gap)
+{
+  handle->len--;
+  if (--GAP(gap)->count > 0) {
+    if (handle->cursor != gap)
+      handle->cursor = NULL;
+    return;
+  }
+
+  handle->cursor = NULL;
+  if (gap->next == gap) {
+    handle->base = NULL;
+  }
+  else {
+    if (handle->base == gap)
+      handle->base = gap->next;
+    gap->prev->next = gap->next;
+    gap->next->prev = gap->prev;
+  }
+  LIST_FREE(handle, gap);
+}
+
+int
+list_gap_expand(struct list_handle *handle)
+{
+  struct list_item *curr;
+
+  if (handle->base == NULL)
+    return UTILS_OK;
+
+  curr = handle->base;
+  do {
+    /* each empty element in turn becomes the first of its gap */
+    if (LIST_ITEM_GAP(curr) && list_gap_fill(handle, curr, 0) == NULL)
+      return UTILS_ERROR;
+    curr = curr->next;
+  } while (curr != handle->base);
+  return UTILS_OK;
+}
+
+int
+list_gap_walk(struct list_handle *handle, list_cbk_t cbk, void *args)
+{
+  struct list_item *curr;
+  size_t i;
+  int err;
+
+  if (handle->base == NULL)
+    return UTILS_OK;
+
+  curr = handle->base;
+  do {
+    if (LIST_ITEM_GAP(curr) && handle->ctor != NULL) {
+      /* the constructor must run once for each element */
+      curr = list_gap_fill(handle, curr, 0);
+      if (curr == NULL)
+	return UTILS_ERROR;
+    }
+    if (LIST_ITEM_GAP(curr)) {
+      for (i = 0, err = UTILS_OK;
+	   i < GAP(curr)->count && err == UTILS_OK; i++)
+	err = cbk(NULL, args);
+    }
+    else {
+      err = cbk(curr->data, args);
+    }
+    if (err == UTILS_ITER_STOP)
+      return UTILS_OK;
+    if (err != UTILS_OK)
+      return UTILS_ERROR;
+    curr = curr->next;
+  } while (curr != handle->base);
+  return UTILS_OK;
+}
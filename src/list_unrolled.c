@@ -0,0 +1,432 @@
+/**
+ * @file
+ * Unrolled list storage.
+ * The list data is kept in a circular list of chunks, each chunk
+ * stores a small array of data pointers so that walking the list
+ * touches a fraction of the nodes of the plain list.
+ * See list.h for API specification
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "libutils/error.h"
+#include "list_internal.h"
+
+/**
+ * Allocate an empty chunk and link it after the given chunk,
+ * if prev is NULL the chunk becomes the only chunk of the list.
+ */
+static struct list_chunk *
+chunk_new(struct list_handle *handle, struct list_chunk *prev)
+{
+  struct list_chunk *chunk;
+
+  chunk = LIST_ALLOC(handle, sizeof(struct list_chunk));
+  if (chunk == NULL)
+    return NULL;
+  chunk->count = 0;
+  if (prev == NULL) {
+    chunk->next = chunk;
+    chunk->prev = chunk;
+    handle->chunks = chunk;
+  }
+  else {
+    chunk->prev = prev;
+    chunk->next = prev->next;
+    prev->next->prev = chunk;
+    prev->next = chunk;
+  }
+  return chunk;
+}
+
+/**
+ * Unlink and free an empty chunk
+ */
+static void
+chunk_free(struct list_handle *handle, struct list_chunk *chunk)
+{
+  if (chunk->next == chunk) {
+    handle->chunks = NULL;
+  }
+  else {
+    if (handle->chunks == chunk)
+      handle->chunks = chunk->next;
+    chunk->prev->next = chunk->next;
+    chunk->next->prev = chunk->prev;
+  }
+  LIST_FREE(handle, chunk);
+}
+
+struct list_chunk *
+list_chunk_find(struct list_handle *handle, size_t position, int *slot)
+{
+  struct list_chunk *chunk;
+  size_t index;
+
+  /* scan the chunks from the closest end */
+  if (position < handle->len / 2) {
+    chunk = handle->chunks;
+    index = 0;
+    while (position >= index + chunk->count) {
+      index += chunk->count;
+      chunk = chunk->next;
+    }
+  }
+  else {
+    chunk = handle->chunks->prev;
+    index = handle->len - chunk->count;
+    while (position < index) {
+      chunk = chunk->prev;
+      index -= chunk->count;
+    }
+  }
+  *slot = position - index;
+  return chunk;
+}
+
+int
+list_chunk_insert(struct list_handle *handle, void *data, size_t position)
+{
+  struct list_chunk *chunk, *split;
+  int slot, half;
+
+  if (handle->chunks == NULL) {
+    chunk = chunk_new(handle, NULL);
+    slot = 0;
+  }
+  else if (position == handle->len) {
+    /* append to the last chunk */
+    chunk = handle->chunks->prev;
+    slot = chunk->count;
+  }
+  else {
+    chunk = list_chunk_find(handle, position, &slot);
+  }
+  if (chunk == NULL)
+    return UTILS_ERROR;
+
+  if (chunk->count == LIST_CHUNK_ITEMS) {
+    if (slot == LIST_CHUNK_ITEMS) {
+      /* appending past a full chunk starts a new one */
+      chunk = chunk_new(handle, chunk);
+      if (chunk == NULL)
+	return UTILS_ERROR;
+      slot = 0;
+    }
+    else if (slot == 0) {
+      /* pushing before a full chunk starts a new one */
+      split = chunk_new(handle, chunk->prev);
+      if (split == NULL)
+	return UTILS_ERROR;
+      if (chunk == handle->chunks)
+	handle->chunks = split;
+      chunk = split;
+    }
+    else {
+      /* move the upper half of the chunk to a new chunk */
+      split = chunk_new(handle, chunk);
+      if (split == NULL)
+	return UTILS_ERROR;
+      half = LIST_CHUNK_ITEMS / 2;
+      memcpy(split->data, &chunk->data[half],
+	     (LIST_CHUNK_ITEMS - half) * sizeof(void *));
+      split->count = LIST_CHUNK_ITEMS - half;
+      chunk->count = half;
+      if (slot > half) {
+	chunk = split;
+	slot -= half;
+      }
+    }
+  }
+  memmove(&chunk->data[slot + 1], &chunk->data[slot],
+	  (chunk->count - slot) * sizeof(void *));
+  chunk->data[slot] = data;
+  chunk->count++;
+  handle->len++;
+  return UTILS_OK;
+}
+
+void *
+list_chunk_remove(struct list_handle *handle, size_t position)
+{
+  struct list_chunk *chunk;
+  int slot;
+
+  chunk = list_chunk_find(handle, position, &slot);
+  return list_chunk_remove_at(handle, &chunk, &slot);
+}
+
+void *
+list_chunk_remove_at(struct list_handle *handle, struct list_chunk **pchunk,
+		     int *pslot)
+{
+  struct list_chunk *chunk = *pchunk, *next;
+  void *data;
+  int slot = *pslot;
+  bool last;
+
+  data = chunk->data[slot];
+  chunk->count--;
+  memmove(&chunk->data[slot], &chunk->data[slot + 1],
+	  (chunk->count - slot) * sizeof(void *));
+  handle->len--;
+
+  next = chunk->next;
+  if (chunk->count == 0) {
+    last = (next == handle->chunks);
+    chunk_free(handle, chunk);
+    *pchunk = last ? NULL : next;
+    *pslot = 0;
+    return data;
+  }
+  /* merge sparse chunks with the next one */
+  if (next != handle->chunks && next != chunk &&
+      chunk->count + next->count <= LIST_CHUNK_ITEMS / 2) {
+    memcpy(&chunk->data[chunk->count], next->data,
+	   next->count * sizeof(void *));
+    chunk->count += next->count;
+    chunk_free(handle, next);
+  }
+  if (slot == chunk->count) {
+    /* the removed data was the last of the chunk */
+    *pchunk = (chunk->next == handle->chunks) ? NULL : chunk->next;
+    *pslot = 0;
+  }
+  return data;
+}
+
+void
+list_chunk_destroy(struct list_handle *handle)
+{
+  struct list_chunk *chunk;
+  int slot;
+
+  while (handle->chunks != NULL) {
+    chunk = handle->chunks;
+    if (handle->dtor != NULL)
+      for (slot = 0; slot < chunk->count; slot++)
+	handle->dtor(chunk->data[slot]);
+    chunk->count = 0;
+    chunk_free(handle, chunk);
+  }
+  handle->len = 0;
+}
+
+int
+list_chunk_walk(struct list_handle *handle, list_cbk_t cbk, void *args)
+{
+  struct list_chunk *chunk;
+  int slot, err;
+
+  chunk = handle->chunks;
+  if (chunk == NULL)
+    return UTILS_OK;
+  do {
+    for (slot = 0; slot < chunk->count; slot++) {
+      err = cbk(chunk->data[slot], args);
+      if (err == UTILS_ITER_STOP)
+	return UTILS_OK;
+      if (err != UTILS_OK)
+	return UTILS_ERROR;
+    }
+    chunk = chunk->next;
+  } while (chunk != handle->chunks);
+  return UTILS_OK;
+}
+
+void
+list_chunk_filter(struct list_handle *handle, list_pred_t pred, void *args)
+{
+  struct list_chunk *rchunk, *wchunk;
+  int rslot, wslot = 0;
+  void *data;
+
+  if (handle->chunks == NULL)
+    return;
+
+  /* the kept data is packed from the first chunk on, the write
+   * position never passes the read position
+   */
+  rchunk = wchunk = handle->chunks;
+  do {
+    for (rslot = 0; rslot < rchunk->count; rslot++) {
+      data = rchunk->data[rslot];
+      if (!pred(data, args)) {
+	handle->len--;
+	if (handle->dtor != NULL)
+	  handle->dtor(data);
+	continue;
+      }
+      if (wslot == LIST_CHUNK_ITEMS) {
+	wchunk->count = LIST_CHUNK_ITEMS;
+	wchunk = wchunk->next;
+	wslot = 0;
+      }
+      wchunk->data[wslot++] = data;
+    }
+    rchunk = rchunk->next;
+  } while (rchunk != handle->chunks);
+
+  /* release the chunks left empty */
+  wchunk->count = wslot;
+  while (wchunk->next != handle->chunks)
+    chunk_free(handle, wchunk->next);
+  if (wslot == 0)
+    chunk_free(handle, wchunk);
+}
+
+/**
+ * Make the given position the first slot of a chunk, splitting
+ * the chunk that holds it.
+ *
+ * @param[in] handle: the list handle
+ * @param[in] position: a valid list position
+ * @return: the chunk starting at position or NULL
+ */
+static struct list_chunk *
+chunk_cut(struct list_handle *handle, size_t position)
+{
+  struct list_chunk *chunk, *split;
+  int slot;
+
+  chunk = list_chunk_find(handle, position, &slot);
+  if (slot == 0)
+    return chunk;
+  split = chunk_new(handle, chunk);
+  if (split == NULL)
+    return NULL;
+  split->count = chunk->count - slot;
+  memcpy(split->data, &chunk->data[slot], split->count * sizeof(void *));
+  chunk->count = slot;
+  return split;
+}
+
+int
+list_chunk_split(struct list_handle *handle, struct list_handle *out,
+		 size_t position)
+{
+  struct list_chunk *first, *last;
+
+  first = chunk_cut(handle, position);
+  if (first == NULL)
+    return UTILS_ERROR;
+  last = handle->chunks->prev;
+  if (first == handle->chunks) {
+    handle->chunks = NULL;
+  }
+  else {
+    first->prev->next = handle->chunks;
+    handle->chunks->prev = first->prev;
+  }
+  first->prev = last;
+  last->next = first;
+  out->chunks = first;
+  return UTILS_OK;
+}
+
+int
+list_chunk_join(struct list_handle *handle, struct list_handle *src,
+		size_t position)
+{
+  struct list_chunk *next, *first, *last;
+
+  first = src->chunks;
+  last = first->prev;
+  if (handle->chunks == NULL) {
+    handle->chunks = first;
+    src->chunks = NULL;
+    return UTILS_OK;
+  }
+  /* both the head and the tail are linked before the first chunk */
+  if (position == 0 || position == handle->len)
+    next = handle->chunks;
+  else
+    next = chunk_cut(handle, position);
+  if (next == NULL)
+    return UTILS_ERROR;
+
+  first->prev = next->prev;
+  last->next = next;
+  next->prev->next = first;
+  next->prev = last;
+  if (position == 0)
+    handle->chunks = first;
+  src->chunks = NULL;
+  return UTILS_OK;
+}
+
+int
+list_chunk_sort(struct list_handle *handle, list_cmp_t cmp)
+{
+  struct list_chunk *chunk;
+  void **items, **src, **dst, **swap;
+  size_t width, lo, mid, hi, i, j, k;
+  int slot;
+
+  if (handle->len < 2)
+    return UTILS_OK;
+  items = LIST_ALLOC(handle, 2 * handle->len * sizeof(void *));
+  if (items == NULL)
+    return UTILS_ERROR;
+
+  k = 0;
+  chunk = handle->chunks;
+  do {
+    for (slot = 0; slot < chunk->count; slot++)
+      items[k++] = chunk->data[slot];
+    chunk = chunk->next;
+  } while (chunk != handle->chunks);
+
+  /* bottom-up merge sort between the two halves of the buffer */
+  src = items;
+  dst = items + handle->len;
+  for (width = 1; width < handle->len; width *= 2) {
+    for (lo = 0; lo < handle->len; lo += 2 * width) {
+      mid = (lo + width < handle->len) ? lo + width : handle->len;
+      hi = (mid + width < handle->len) ? mid + width : handle->len;
+      for (i = lo, j = mid, k = lo; k < hi; k++) {
+	if (i < mid && (j == hi || cmp(src[i], src[j]) <= 0))
+	  dst[k] = src[i++];
+	else
+	  dst[k] = src[j++];
+      }
+    }
+    swap = src;
+    src = dst;
+    dst = swap;
+  }
+
+  k = 0;
+  do {
+    for (slot = 0; slot < chunk->count; slot++)
+      chunk->data[slot] = src[k++];
+    chunk = chunk->next;
+  } while (chunk != handle->chunks);
+  LIST_FREE(handle, items);
+  return UTILS_OK;
+}
+
+size_t
+list_chunk_upper(struct list_handle *handle, void *data, list_cmp_t cmp)
+{
+  struct list_chunk *chunk;
+  size_t index;
+  int slot;
+
+  if (handle->chunks == NULL)
+    return 0;
+
+  /* skip the chunks whose last item is not greater than data */
+  chunk = handle->chunks;
+  index = 0;
+  while (cmp(data, chunk->data[chunk->count - 1]) >= 0) {
+    index += chunk->count;
+    chunk = chunk->next;
+    if (chunk == handle->chunks)
+      return index;
+  }
+  for (slot = 0; cmp(data, chunk->data[slot]) >= 0; slot++)
+    ;
+  return index + slot;
+}
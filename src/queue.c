@@ -0,0 +1,202 @@
+/**
+ * @file
+ * Lock-free queue implementation, after Michael and Scott.
+ * The queue always holds a dummy node at the head, the first item
+ * is the one following the dummy. Popping an item makes its node
+ * the new dummy and retires the old one.
+ * See queue.h for API specification
+ */
+
+#include <stdatomic.h>
+#include <stdlib.h>
+
+#include "libutils/error.h"
+#include "libutils/queue.h"
+#include "hazard.h"
+
+#define ASSERT_HANDLE_VALID(hnd) if (hnd == NULL) return UTILS_ERROR
+#define ASSERT_HANDLE_VALID_PTR(hnd) if (hnd == NULL) return NULL
+
+/* keep head and tail on separate cache lines */
+#define QUEUE_CACHE_LINE 64
+
+/* hazard pointer slots */
+#define HP_FIRST 0
+#define HP_NEXT 1
+
+/**
+ * queue node
+ */
+struct queue_node {
+  _Atomic(void *) next;
+  void *data;
+};
+
+/**
+ * queue internal representation
+ */
+struct queue_handle {
+  _Atomic(void *) head;
+  char pad_head[QUEUE_CACHE_LINE - sizeof(void *)];
+  _Atomic(void *) tail;
+  char pad_tail[QUEUE_CACHE_LINE - sizeof(void *)];
+  atomic_int len;
+  list_dtor_t dtor;
+  struct hazard_domain hazard;
+};
+
+/**
+ * Hazard reclaim callback for queue nodes
+ */
+static void
+queue_node_reclaim(void *ptr, void *args)
+{
+  free(ptr);
+}
+
+/* queue setup API */
+
+int
+queue_init(queue_t *phandle, list_dtor_t dtor)
+{
+  struct queue_node *dummy;
+  queue_t handle;
+
+  if (phandle == NULL)
+    return UTILS_ERROR;
+
+  handle = malloc(sizeof(struct queue_handle));
+  if (handle == NULL)
+    return UTILS_ERROR;
+  dummy = malloc(sizeof(struct queue_node));
+  if (dummy == NULL)
+    goto err_free_handle;
+
+  atomic_init(&dummy->next, NULL);
+  dummy->data = NULL;
+  atomic_init(&handle->head, dummy);
+  atomic_init(&handle->tail, dummy);
+  atomic_init(&handle->len, 0);
+  handle->dtor = dtor;
+  hazard_init(&handle->hazard, queue_node_reclaim, NULL);
+  *phandle = handle;
+  return UTILS_OK;
+
+ err_free_handle:
+  free(handle);
+  return UTILS_ERROR;
+}
+
+int
+queue_destroy(queue_t handle)
+{
+  struct queue_node *node, *next;
+  int err = UTILS_OK;
+
+  ASSERT_HANDLE_VALID(handle);
+
+  node = atomic_load(&handle->head);
+  next = atomic_load(&node->next);
+  free(node);
+  while (next != NULL) {
+    node = next;
+    next = atomic_load(&node->next);
+    if (handle->dtor != NULL && handle->dtor(node->data) != UTILS_OK)
+      err = UTILS_ERROR;
+    free(node);
+  }
+  hazard_destroy(&handle->hazard);
+  free(handle);
+  return err;
+}
+
+/* queue data API */
+
+int
+queue_length(queue_t handle)
+{
+  if (handle == NULL)
+    return -UTILS_ERROR;
+  return atomic_load_explicit(&handle->len, memory_order_relaxed);
+}
+
+int
+queue_push(queue_t handle, void *data)
+{
+  struct queue_node *node, *tail, *next;
+  struct hazard_record *hp;
+
+  ASSERT_HANDLE_VALID(handle);
+
+  node = malloc(sizeof(struct queue_node));
+  if (node == NULL)
+    return UTILS_ERROR;
+  atomic_init(&node->next, NULL);
+  node->data = data;
+
+  hp = hazard_acquire(&handle->hazard);
+  if (hp == NULL)
+    goto err_free_node;
+
+  for (;;) {
+    tail = hazard_protect(hp, HP_FIRST, &handle->tail);
+    next = atomic_load(&tail->next);
+    if (tail != atomic_load(&handle->tail))
+      continue;
+    if (next != NULL) {
+      /* help a lagging push by swinging the tail */
+      atomic_compare_exchange_strong(&handle->tail, (void **)&tail, next);
+      continue;
+    }
+    if (atomic_compare_exchange_strong(&tail->next, (void **)&next, node))
+      break;
+  }
+  atomic_compare_exchange_strong(&handle->tail, (void **)&tail, node);
+  atomic_fetch_add_explicit(&handle->len, 1, memory_order_relaxed);
+  hazard_release(hp);
+  return UTILS_OK;
+
+ err_free_node:
+  free(node);
+  return UTILS_ERROR;
+}
+
+void *
+queue_pop(queue_t handle)
+{
+  struct queue_node *head, *tail, *next;
+  struct hazard_record *hp;
+  void *data;
+
+  ASSERT_HANDLE_VALID_PTR(handle);
+
+  hp = hazard_acquire(&handle->hazard);
+  if (hp == NULL)
+    return NULL;
+
+  for (;;) {
+    head = hazard_protect(hp, HP_FIRST, &handle->head);
+    tail = atomic_load(&handle->tail);
+    next = hazard_protect(hp, HP_NEXT, &head->next);
+    if (head != atomic_load(&handle->head))
+      continue;
+    if (next == NULL) {
+      hazard_release(hp);
+      return NULL;
+    }
+    if (head == tail) {
+      /* the tail is lagging behind the pushed node */
+      atomic_compare_exchange_strong(&handle->tail, (void **)&tail, next);
+      continue;
+    }
+    data = next->data;
+    if (atomic_compare_exchange_strong(&handle->head, (void **)&head, next))
+      break;
+  }
+  atomic_fetch_sub_explicit(&handle->len, 1, memory_order_relaxed);
+  /* if the retire list can not grow the old dummy is leaked,
+   * it may still be protected by another thread */
+  hazard_retire(&handle->hazard, hp, head);
+  hazard_release(hp);
+  return data;
+}
@@ -0,0 +1,325 @@
+/**
+ * @file
+ * Growable contiguous vector implementation.
+ * See vec.h for API specification
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "libutils/error.h"
+#include "libutils/vec.h"
+
+#define ASSERT_HANDLE_VALID(hnd) if (hnd == NULL) return UTILS_ERROR
+#define ASSERT_HANDLE_VALID_PTR(hnd) if (hnd == NULL) return NULL
+
+/* capacity of the first allocation */
+#define VEC_MIN_CAPACITY 8
+
+/**
+ * vector internal representation
+ */
+struct vec_handle {
+  void **items;
+  size_t len;
+  size_t capacity;
+  list_ctor_t ctor;
+  list_dtor_t dtor;
+};
+
+/**
+ * Resize the vector storage
+ *
+ * @param[in] handle: the vector handle
+ * @param[in] capacity: the new capacity, at least the vector length
+ * @return: utils error code
+ */
+static int
+vec_resize(struct vec_handle *handle, size_t capacity)
+{
+  void **items;
+
+  if (capacity == 0) {
+    free(handle->items);
+    handle->items = NULL;
+    handle->capacity = 0;
+    return UTILS_OK;
+  }
+  items = realloc(handle->items, capacity * sizeof(void *));
+  if (items == NULL)
+    return UTILS_ERROR;
+  handle->items = items;
+  handle->capacity = capacity;
+  return UTILS_OK;
+}
+
+/**
+ * Grow the vector storage geometrically to hold the given
+ * number of items
+ */
+static int
+vec_grow(struct vec_handle *handle, size_t len)
+{
+  size_t capacity;
+
+  if (len <= handle->capacity)
+    return UTILS_OK;
+  capacity = (handle->capacity == 0) ? VEC_MIN_CAPACITY : handle->capacity;
+  while (capacity < len)
+    capacity *= 2;
+  return vec_resize(handle, capacity);
+}
+
+/* vector setup API */
+
+int
+vec_init(vec_t *phandle, list_ctor_t ctor, list_dtor_t dtor)
+{
+  vec_t handle;
+
+  if (phandle == NULL)
+    return UTILS_ERROR;
+  *phandle = malloc(sizeof(struct vec_handle));
+  if (*phandle == NULL)
+    return UTILS_ERROR;
+  handle = *phandle;
+  handle->items = NULL;
+  handle->len = 0;
+  handle->capacity = 0;
+  handle->ctor = ctor;
+  handle->dtor = dtor;
+  return UTILS_OK;
+}
+
+int
+vec_destroy(vec_t handle)
+{
+  size_t i;
+
+  ASSERT_HANDLE_VALID(handle);
+
+  if (handle->dtor != NULL)
+    for (i = 0; i < handle->len; i++)
+      handle->dtor(handle->items[i]);
+  free(handle->items);
+  free(handle);
+  return UTILS_OK;
+}
+
+int
+vec_reserve(vec_t handle, size_t capacity)
+{
+  ASSERT_HANDLE_VALID(handle);
+
+  if (capacity <= handle->capacity)
+    return UTILS_OK;
+  return vec_resize(handle, capacity);
+}
+
+int
+vec_shrink(vec_t handle)
+{
+  ASSERT_HANDLE_VALID(handle);
+
+  if (handle->len == handle->capacity)
+    return UTILS_OK;
+  return vec_resize(handle, handle->len);
+}
+
+int
+vec_capacity(vec_t handle)
+{
+  if (handle == NULL)
+    return -UTILS_ERROR;
+  return handle->capacity;
+}
+
+/* vector data API */
+
+int
+vec_length(vec_t handle)
+{
+  if (handle == NULL)
+    return -UTILS_ERROR;
+  return handle->len;
+}
+
+int
+vec_append(vec_t handle, void *data)
+{
+  ASSERT_HANDLE_VALID(handle);
+
+  if (vec_grow(handle, handle->len + 1))
+    return UTILS_ERROR;
+  if (handle->ctor != NULL)
+    handle->ctor(&handle->items[handle->len], data);
+  else
+    handle->items[handle->len] = data;
+  handle->len++;
+  return UTILS_OK;
+}
+
+int
+vec_push(vec_t handle, void *data)
+{
+  return vec_insert(handle, data, 0);
+}
+
+int
+vec_insert(vec_t handle, void *data, int position)
+{
+  size_t len;
+
+  ASSERT_HANDLE_VALID(handle);
+  if (position < 0)
+    return UTILS_ERROR;
+
+  /* positions past the end are filled with empty elements */
+  len = (position > handle->len) ? position + 1 : handle->len + 1;
+  if (vec_grow(handle, len))
+    return UTILS_ERROR;
+
+  while (position > handle->len) {
+    if (handle->ctor != NULL)
+      handle->ctor(&handle->items[handle->len], NULL);
+    else
+      handle->items[handle->len] = NULL;
+    handle->len++;
+  }
+
+  memmove(&handle->items[position + 1], &handle->items[position],
+	  (handle->len - position) * sizeof(void *));
+  if (handle->ctor != NULL)
+    handle->ctor(&handle->items[position], data);
+  else
+    handle->items[position] = data;
+  handle->len++;
+  return UTILS_OK;
+}
+
+void *
+vec_remove(vec_t handle, int position)
+{
+  void *data;
+
+  ASSERT_HANDLE_VALID_PTR(handle);
+  if (position < 0 || position >= handle->len)
+    return NULL;
+
+  data = handle->items[position];
+  handle->len--;
+  memmove(&handle->items[position], &handle->items[position + 1],
+	  (handle->len - position) * sizeof(void *));
+  return data;
+}
+
+void *
+vec_pop(vec_t handle)
+{
+  return vec_remove(handle, 0);
+}
+
+void *
+vec_get(vec_t handle, int position)
+{
+  ASSERT_HANDLE_VALID_PTR(handle);
+  if (position < 0 || position >= handle->len)
+    return NULL;
+
+  return handle->items[position];
+}
+
+int
+vec_indexof(vec_t handle, void *data)
+{
+  size_t i;
+
+  if (handle == NULL)
+    return -1;
+
+  for (i = 0; i < handle->len; i++)
+    if (handle->items[i] == data)
+      return i;
+  return -1;
+}
+
+int
+vec_delete(vec_t handle, int position)
+{
+  void *data;
+
+  ASSERT_HANDLE_VALID(handle);
+  if (position < 0 || position >= handle->len)
+    return UTILS_ERROR;
+
+  data = vec_remove(handle, position);
+  if (handle->dtor != NULL)
+    handle->dtor(data);
+  return UTILS_OK;
+}
+
+void **
+vec_data(vec_t handle)
+{
+  ASSERT_HANDLE_VALID_PTR(handle);
+
+  return handle->items;
+}
+
+int
+vec_walk(vec_t handle, list_cbk_t cbk, void *args)
+{
+  size_t i;
+  int err;
+
+  ASSERT_HANDLE_VALID(handle);
+  if (cbk == NULL)
+    return UTILS_ERROR;
+
+  for (i = 0; i < handle->len; i++) {
+    err = cbk(handle->items[i], args);
+    if (err == UTILS_ITER_STOP)
+      break;
+    if (err != UTILS_OK)
+      return UTILS_ERROR;
+  }
+  return UTILS_OK;
+}
+
+/* vector iterator API */
+
+int
+vec_iter_init(vec_t handle, vec_iter_t iter)
+{
+  ASSERT_HANDLE_VALID(handle);
+  if (iter == NULL)
+    return UTILS_ERROR;
+
+  iter->vec = handle;
+  iter->index = 0;
+  return UTILS_OK;
+}
+
+int
+vec_iter_next(vec_iter_t iter)
+{
+  if (iter == NULL)
+    return UTILS_ERROR;
+  if (iter->index < iter->vec->len)
+    iter->index++;
+  return UTILS_OK;
+}
+
+void *
+vec_iter_data(vec_iter_t iter)
+{
+  if (iter == NULL || iter->index >= iter->vec->len)
+    return NULL;
+  return iter->vec->items[iter->index];
+}
+
+bool
+vec_iter_end(vec_iter_t iter)
+{
+  return (iter == NULL || iter->index >= iter->vec->len);
+}
@@ -0,0 +1,376 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "libutils/error.h"
+#include "libutils/btree.h"
+
+/* number of distinct keys in the random tests */
+#define NKEYS 3000
+
+/* count calls to item ctor and dtor */
+static int ctor_count = 0;
+static int dtor_count = 0;
+static int walk_count = 0;
+
+static int
+ctor(void **item, void *data)
+{
+  ctor_count++;
+  *item = data;
+  return UTILS_OK;
+}
+
+static int
+dtor(void *data)
+{
+  dtor_count++;
+  return UTILS_OK;
+}
+
+static int
+cmp_long(void *a, void *b)
+{
+  return ((long)a > (long)b) - ((long)a < (long)b);
+}
+
+static int
+cmp_string(void *a, void *b)
+{
+  return strcmp(a, b);
+}
+
+/* check that the walked items are increasing */
+static int
+walk_cbk(void *item, void *args)
+{
+  long *last = args;
+
+  assert_true((long)item > *last);
+  *last = (long)item;
+  walk_count++;
+  return UTILS_OK;
+}
+
+static int
+stop_cbk(void *item, void *args)
+{
+  walk_count++;
+  if ((long)item == (long)args)
+    return UTILS_ITER_STOP;
+  return UTILS_OK;
+}
+
+static int
+setup_btree(void **state)
+{
+  btree_t tree;
+  int err;
+
+  ctor_count = 0;
+  dtor_count = 0;
+  walk_count = 0;
+
+  err = btree_init(&tree, cmp_long, ctor, dtor);
+  if (err)
+    return err;
+  *state = tree;
+  return 0;
+}
+
+static int
+teardown_btree(void **state)
+{
+  int err;
+
+  err = btree_destroy(*state);
+  assert_int_equal(ctor_count, dtor_count);
+  return err;
+}
+
+static void
+test_btree_string(void **state)
+{
+  btree_iter_struct_t iter;
+  const char *words[] = {"pear", "apple", "fig", "kiwi", "banana"};
+  const char *sorted[] = {"apple", "banana", "fig", "kiwi", "pear"};
+  char key[16];
+  btree_t tree;
+  int err, i;
+
+  err = btree_init(&tree, cmp_string, NULL, NULL);
+  assert_int_equal(err, UTILS_OK);
+  for (i = 0; i < 5; i++) {
+    err = btree_insert(tree, words[i], (void *)words[i]);
+    assert_int_equal(err, UTILS_OK);
+  }
+
+  /* keys are compared with the comparison function */
+  strcpy(key, "fig");
+  assert_string_equal(btree_find(tree, key), "fig");
+  assert_int_equal(btree_insert(tree, key, key), UTILS_ERROR);
+  assert_null(btree_find(tree, "grape"));
+  assert_int_equal(btree_length(tree), 5);
+
+  i = 0;
+  for (btree_iter_init(tree, &iter); !btree_iter_end(&iter);
+       btree_iter_next(&iter))
+    assert_string_equal(btree_iter_key(&iter), sorted[i++]);
+  assert_int_equal(i, 5);
+
+  btree_lower_bound(tree, "grape", &iter);
+  assert_string_equal(btree_iter_data(&iter), "kiwi");
+  btree_lower_bound(tree, "zucchini", &iter);
+  assert_true(btree_iter_end(&iter));
+  assert_null(btree_iter_key(&iter));
+  btree_destroy(tree);
+}
+
+static void
+test_btree_owned_keys(void **state)
+{
+  static char *keys[NKEYS];
+  btree_t tree;
+  int err, i;
+
+  err = btree_init(&tree, cmp_string, NULL, NULL);
+  assert_int_equal(err, UTILS_OK);
+  for (i = 0; i < NKEYS; i++) {
+    keys[i] = malloc(16);
+    snprintf(keys[i], 16, "%05d", i);
+    err = btree_insert(tree, keys[i], keys[i]);
+    assert_int_equal(err, UTILS_OK);
+  }
+
+  /* the keys are released as soon as they leave the map, the inner
+   * nodes must not keep any of them */
+  for (i = 0; i < NKEYS; i += 3) {
+    assert_ptr_equal(btree_remove(tree, keys[i]), keys[i]);
+    free(keys[i]);
+    keys[i] = NULL;
+  }
+  for (i = 0; i < NKEYS; i++)
+    if (keys[i] != NULL)
+      assert_ptr_equal(btree_find(tree, keys[i]), keys[i]);
+  for (i = 0; i < NKEYS; i++)
+    if (keys[i] != NULL) {
+      assert_ptr_equal(btree_remove(tree, keys[i]), keys[i]);
+      free(keys[i]);
+    }
+  assert_int_equal(btree_length(tree), 0);
+  btree_destroy(tree);
+}
+
+static void
+test_btree_sequence(void **state)
+{
+  long i, last;
+  void *data;
+  int err;
+
+  /* ascending insertions split the rightmost nodes only */
+  for (i = 0; i < NKEYS; i++) {
+    err = btree_insert(*state, (void *)i, (void *)i);
+    assert_int_equal(err, UTILS_OK);
+  }
+  assert_int_equal(btree_length(*state), NKEYS);
+  assert_int_equal(ctor_count, NKEYS);
+  for (i = 0; i < NKEYS; i++)
+    assert_int_equal((long)btree_find(*state, (void *)i), i);
+
+  last = -1;
+  err = btree_walk(*state, walk_cbk, &last);
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal(walk_count, NKEYS);
+
+  /* descending removals merge from the right */
+  for (i = NKEYS - 1; i >= NKEYS / 2; i--) {
+    err = btree_delete(*state, (void *)i);
+    assert_int_equal(err, UTILS_OK);
+  }
+  /* ascending removals merge from the left */
+  for (i = 0; i < NKEYS / 4; i++) {
+    data = btree_remove(*state, (void *)i);
+    assert_int_equal((long)data, i);
+    dtor(data);
+  }
+
+  assert_int_equal(btree_length(*state), NKEYS / 4);
+  assert_false(btree_contains(*state, (void *)0L));
+  assert_true(btree_contains(*state, (void *)(long)(NKEYS / 4)));
+  assert_int_equal(btree_delete(*state, (void *)0L), UTILS_ERROR);
+}
+
+static void
+test_btree_random(void **state)
+{
+  static bool present[NKEYS];
+  btree_iter_struct_t iter;
+  long k, last;
+  int i, len = 0;
+
+  memset(present, 0, sizeof(present));
+  srand(11);
+  for (i = 0; i < 30 * NKEYS; i++) {
+    k = rand() % NKEYS;
+    if (rand() % 2) {
+      assert_int_equal(btree_insert(*state, (void *)k, (void *)k),
+		       present[k] ? UTILS_ERROR : UTILS_OK);
+      if (!present[k])
+	len++;
+      present[k] = true;
+    }
+    else {
+      assert_int_equal(btree_delete(*state, (void *)k),
+		       present[k] ? UTILS_OK : UTILS_ERROR);
+      if (present[k])
+	len--;
+      present[k] = false;
+    }
+  }
+
+  assert_int_equal(btree_length(*state), len);
+  k = 0;
+  for (btree_iter_init(*state, &iter); !btree_iter_end(&iter);
+       btree_iter_next(&iter)) {
+    while (!present[k])
+      k++;
+    assert_int_equal((long)btree_iter_key(&iter), k++);
+  }
+  while (k < NKEYS)
+    assert_false(present[k++]);
+
+  /* lower bounds of every key */
+  for (k = 0; k < NKEYS; k++) {
+    btree_lower_bound(*state, (void *)k, &iter);
+    last = k;
+    while (last < NKEYS && !present[last])
+      last++;
+    if (last == NKEYS)
+      assert_true(btree_iter_end(&iter));
+    else
+      assert_int_equal((long)btree_iter_data(&iter), last);
+  }
+}
+
+static void
+test_btree_range(void **state)
+{
+  long i, last;
+  int err;
+
+  for (i = 0; i < NKEYS; i += 2) {
+    err = btree_insert(*state, (void *)i, (void *)i);
+    assert_int_equal(err, UTILS_OK);
+  }
+
+  /* [101, 201) holds the even keys from 102 to 200 */
+  last = 100;
+  err = btree_walk_range(*state, (void *)101L, (void *)201L, walk_cbk, &last);
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal(walk_count, 50);
+  assert_int_equal(last, 200);
+
+  walk_count = 0;
+  last = -1;
+  err = btree_walk_range(*state, NULL, (void *)10L, walk_cbk, &last);
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal(walk_count, 5);
+
+  walk_count = 0;
+  last = NKEYS - 11;
+  err = btree_walk_range(*state, (void *)(long)(NKEYS - 10), NULL,
+			 walk_cbk, &last);
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal(walk_count, 5);
+
+  walk_count = 0;
+  err = btree_walk(*state, stop_cbk, (void *)20L);
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal(walk_count, 11);
+}
+
+static void
+test_btree_full_duplicate(void **state)
+{
+  long i;
+  int err;
+
+  /* a rejected insertion in full nodes leaves the tree unchanged,
+   * the first 32 keys fill the root leaf */
+  for (i = 0; i < 32; i++) {
+    err = btree_insert(*state, (void *)i, (void *)i);
+    assert_int_equal(err, UTILS_OK);
+  }
+  err = btree_insert(*state, (void *)0L, (void *)0L);
+  assert_int_equal(err, UTILS_ERROR);
+  for (i = 32; i < 2000; i++) {
+    err = btree_insert(*state, (void *)i, (void *)i);
+    assert_int_equal(err, UTILS_OK);
+    err = btree_insert(*state, (void *)(i / 2), NULL);
+    assert_int_equal(err, UTILS_ERROR);
+  }
+  assert_int_equal(btree_length(*state), 2000);
+  for (i = 0; i < 2000; i++)
+    assert_int_equal((long)btree_find(*state, (void *)i), i);
+}
+
+static void
+test_btree_empty(void **state)
+{
+  btree_iter_struct_t iter;
+  long last = -1;
+  int err;
+
+  assert_int_equal(btree_length(*state), 0);
+  assert_null(btree_find(*state, (void *)1L));
+  assert_null(btree_remove(*state, (void *)1L));
+  err = btree_iter_init(*state, &iter);
+  assert_int_equal(err, UTILS_OK);
+  assert_true(btree_iter_end(&iter));
+  err = btree_walk(*state, walk_cbk, &last);
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal(walk_count, 0);
+
+  /* the tree shrinks back to empty */
+  err = btree_insert(*state, (void *)1L, NULL);
+  assert_int_equal(err, UTILS_OK);
+  err = btree_delete(*state, (void *)1L);
+  assert_int_equal(err, UTILS_OK);
+  btree_lower_bound(*state, (void *)0L, &iter);
+  assert_true(btree_iter_end(&iter));
+
+  assert_int_equal(btree_init(NULL, cmp_long, NULL, NULL), UTILS_ERROR);
+  assert_int_equal(btree_length(NULL), -UTILS_ERROR);
+  assert_int_equal(btree_destroy(NULL), UTILS_ERROR);
+}
+
+int
+main(int argc, char *argv[])
+{
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test(test_btree_string),
+    cmocka_unit_test(test_btree_owned_keys),
+    cmocka_unit_test_setup_teardown(test_btree_sequence,
+				    setup_btree,
+				    teardown_btree),
+    cmocka_unit_test_setup_teardown(test_btree_random,
+				    setup_btree,
+				    teardown_btree),
+    cmocka_unit_test_setup_teardown(test_btree_range,
+				    setup_btree,
+				    teardown_btree),
+    cmocka_unit_test_setup_teardown(test_btree_full_duplicate,
+				    setup_btree,
+				    teardown_btree),
+    cmocka_unit_test_setup_teardown(test_btree_empty,
+				    setup_btree,
+				    teardown_btree),
+  };
+  return cmocka_run_group_tests(tests, NULL, NULL);
+}
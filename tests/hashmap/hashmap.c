@@ -0,0 +1,272 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "libutils/error.h"
+#include "libutils/hashmap.h"
+
+/* number of keys in the random tests */
+#define NKEYS 2000
+
+/* count calls to item ctor and dtor */
+static int ctor_count = 0;
+static int dtor_count = 0;
+static int walk_count = 0;
+
+static int
+ctor(void **item, void *data)
+{
+  ctor_count++;
+  *item = data;
+  return UTILS_OK;
+}
+
+static int
+dtor(void *data)
+{
+  dtor_count++;
+  return UTILS_OK;
+}
+
+static int
+walk_cbk(void *item, void *args)
+{
+  walk_count++;
+  if (args != NULL && item == args)
+    return UTILS_ITER_STOP;
+  return UTILS_OK;
+}
+
+static int
+setup_hashmap_string(void **state)
+{
+  hashmap_t map;
+  int err;
+
+  ctor_count = 0;
+  dtor_count = 0;
+  walk_count = 0;
+
+  err = hashmap_init(&map, HASHMAP_KEY_STRING, ctor, dtor);
+  if (err)
+    return err;
+  *state = map;
+  return 0;
+}
+
+static int
+setup_hashmap_pointer(void **state)
+{
+  hashmap_t map;
+  int err;
+
+  ctor_count = 0;
+  dtor_count = 0;
+  walk_count = 0;
+
+  err = hashmap_init(&map, HASHMAP_KEY_POINTER, ctor, dtor);
+  if (err)
+    return err;
+  *state = map;
+  return 0;
+}
+
+static int
+teardown_hashmap(void **state)
+{
+  int err;
+
+  err = hashmap_destroy(*state);
+  assert_int_equal(ctor_count, dtor_count);
+  return err;
+}
+
+static void
+test_hashmap_string(void **state)
+{
+  char key[16];
+  void *data;
+  int err;
+
+  err = hashmap_insert(*state, "alpha", "1");
+  assert_int_equal(err, UTILS_OK);
+  err = hashmap_insert(*state, "beta", "2");
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal(hashmap_length(*state), 2);
+  assert_int_equal(ctor_count, 2);
+
+  /* keys are compared by value */
+  strcpy(key, "alpha");
+  assert_string_equal(hashmap_get(*state, key), "1");
+  assert_true(hashmap_contains(*state, key));
+  assert_string_equal(hashmap_get(*state, "beta"), "2");
+  assert_null(hashmap_get(*state, "gamma"));
+  assert_false(hashmap_contains(*state, "gamma"));
+
+  /* duplicate keys are rejected */
+  err = hashmap_insert(*state, key, "3");
+  assert_int_equal(err, UTILS_ERROR);
+  assert_int_equal(ctor_count, 2);
+  assert_string_equal(hashmap_get(*state, "alpha"), "1");
+
+  /* removed data is handed back to the caller */
+  data = hashmap_remove(*state, key);
+  assert_string_equal(data, "1");
+  dtor(data);
+  assert_null(hashmap_remove(*state, key));
+  assert_int_equal(hashmap_length(*state), 1);
+  err = hashmap_delete(*state, "beta");
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal(dtor_count, 2);
+  err = hashmap_delete(*state, "beta");
+  assert_int_equal(err, UTILS_ERROR);
+  assert_int_equal(hashmap_length(*state), 0);
+}
+
+static void
+test_hashmap_pointer(void **state)
+{
+  char a[] = "same", b[] = "same";
+  int err;
+
+  err = hashmap_insert(*state, a, "a");
+  assert_int_equal(err, UTILS_OK);
+  err = hashmap_insert(*state, b, "b");
+  assert_int_equal(err, UTILS_OK);
+  err = hashmap_insert(*state, NULL, "null");
+  assert_int_equal(err, UTILS_OK);
+
+  /* keys are compared by address */
+  assert_string_equal(hashmap_get(*state, a), "a");
+  assert_string_equal(hashmap_get(*state, b), "b");
+  assert_string_equal(hashmap_get(*state, NULL), "null");
+  assert_null(hashmap_get(*state, "same"));
+  assert_int_equal(hashmap_length(*state), 3);
+}
+
+static void
+test_hashmap_random(void **state)
+{
+  static char keys[NKEYS][16];
+  bool present[NKEYS] = {false};
+  int i, k, len = 0;
+
+  for (i = 0; i < NKEYS; i++)
+    snprintf(keys[i], sizeof(keys[i]), "key%d", i);
+
+  srand(7);
+  for (i = 0; i < 20 * NKEYS; i++) {
+    k = rand() % NKEYS;
+    if (rand() % 3 != 0) {
+      assert_int_equal(hashmap_insert(*state, keys[k], keys[k]),
+		       present[k] ? UTILS_ERROR : UTILS_OK);
+      if (!present[k])
+	len++;
+      present[k] = true;
+    }
+    else {
+      assert_int_equal(hashmap_delete(*state, keys[k]),
+		       present[k] ? UTILS_OK : UTILS_ERROR);
+      if (present[k])
+	len--;
+      present[k] = false;
+    }
+  }
+
+  assert_int_equal(hashmap_length(*state), len);
+  for (k = 0; k < NKEYS; k++) {
+    assert_int_equal(hashmap_contains(*state, keys[k]), present[k]);
+    if (present[k])
+      assert_ptr_equal(hashmap_get(*state, keys[k]), keys[k]);
+  }
+}
+
+static void
+test_hashmap_walk(void **state)
+{
+  static long values[NKEYS];
+  bool seen[NKEYS] = {false};
+  hashmap_iter_struct_t iter;
+  long *value;
+  int err, i, count;
+
+  err = hashmap_reserve(*state, NKEYS);
+  assert_int_equal(err, UTILS_OK);
+  for (i = 0; i < NKEYS; i++) {
+    values[i] = i;
+    err = hashmap_insert(*state, &values[i], &values[i]);
+    assert_int_equal(err, UTILS_OK);
+  }
+
+  err = hashmap_walk(*state, walk_cbk, NULL);
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal(walk_count, NKEYS);
+  walk_count = 0;
+  err = hashmap_walk(*state, walk_cbk, &values[NKEYS / 2]);
+  assert_int_equal(err, UTILS_OK);
+  assert_true(walk_count <= NKEYS);
+
+  count = 0;
+  for (hashmap_iter_init(*state, &iter); !hashmap_iter_end(&iter);
+       hashmap_iter_next(&iter)) {
+    value = hashmap_iter_data(&iter);
+    assert_ptr_equal(hashmap_iter_key(&iter), value);
+    assert_false(seen[*value]);
+    seen[*value] = true;
+    count++;
+  }
+  assert_int_equal(count, NKEYS);
+  assert_null(hashmap_iter_data(&iter));
+  assert_null(hashmap_iter_key(&iter));
+}
+
+static void
+test_hashmap_empty(void **state)
+{
+  hashmap_iter_struct_t iter;
+  int err;
+
+  assert_int_equal(hashmap_length(*state), 0);
+  assert_null(hashmap_get(*state, "none"));
+  assert_null(hashmap_get(*state, NULL));
+  assert_int_equal(hashmap_insert(*state, NULL, "null"), UTILS_ERROR);
+  err = hashmap_iter_init(*state, &iter);
+  assert_int_equal(err, UTILS_OK);
+  assert_true(hashmap_iter_end(&iter));
+  err = hashmap_walk(*state, walk_cbk, NULL);
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal(walk_count, 0);
+
+  assert_int_equal(hashmap_init(NULL, HASHMAP_KEY_STRING, NULL, NULL),
+		   UTILS_ERROR);
+  assert_int_equal(hashmap_length(NULL), -UTILS_ERROR);
+  assert_int_equal(hashmap_destroy(NULL), UTILS_ERROR);
+}
+
+int
+main(int argc, char *argv[])
+{
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test_setup_teardown(test_hashmap_string,
+				    setup_hashmap_string,
+				    teardown_hashmap),
+    cmocka_unit_test_setup_teardown(test_hashmap_pointer,
+				    setup_hashmap_pointer,
+				    teardown_hashmap),
+    cmocka_unit_test_setup_teardown(test_hashmap_random,
+				    setup_hashmap_string,
+				    teardown_hashmap),
+    cmocka_unit_test_setup_teardown(test_hashmap_walk,
+				    setup_hashmap_pointer,
+				    teardown_hashmap),
+    cmocka_unit_test_setup_teardown(test_hashmap_empty,
+				    setup_hashmap_string,
+				    teardown_hashmap),
+  };
+  return cmocka_run_group_tests(tests, NULL, NULL);
+}
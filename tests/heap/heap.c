@@ -0,0 +1,234 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <stdlib.h>
+
+#include "libutils/error.h"
+#include "libutils/heap.h"
+
+/* number of items in the random tests */
+#define NITEMS 2000
+
+/* count calls to item ctor and dtor */
+static int ctor_count = 0;
+static int dtor_count = 0;
+
+static int
+ctor(void **item, void *data)
+{
+  ctor_count++;
+  *item = data;
+  return UTILS_OK;
+}
+
+static int
+dtor(void *data)
+{
+  dtor_count++;
+  return UTILS_OK;
+}
+
+static int
+cmp_long(void *a, void *b)
+{
+  return ((long)a > (long)b) - ((long)a < (long)b);
+}
+
+/* items whose priority changes while they are queued */
+struct timer {
+  long deadline;
+  heap_entry_t entry;
+};
+
+static int
+cmp_timer(void *a, void *b)
+{
+  return cmp_long((void *)((struct timer *)a)->deadline,
+		  (void *)((struct timer *)b)->deadline);
+}
+
+static int
+setup_heap(void **state)
+{
+  heap_t heap;
+  int err;
+
+  ctor_count = 0;
+  dtor_count = 0;
+
+  err = heap_init(&heap, cmp_long, ctor, dtor);
+  if (err)
+    return err;
+  *state = heap;
+  return 0;
+}
+
+static int
+teardown_heap(void **state)
+{
+  int err;
+
+  err = heap_destroy(*state);
+  assert_int_equal(ctor_count, dtor_count);
+  return err;
+}
+
+/* pop items, checking the order and balancing the dtor count */
+static void
+drain(heap_t heap, int count)
+{
+  long data, last = -1;
+  int i, len;
+
+  len = heap_length(heap);
+  for (i = 0; i < count; i++) {
+    data = (long)heap_pop(heap);
+    assert_true(data >= last);
+    last = data;
+    dtor((void *)data);
+  }
+  assert_int_equal(heap_length(heap), len - count);
+}
+
+static void
+test_heap_push_pop(void **state)
+{
+  long values[] = {5, 3, 8, 1, 9, 1, 7};
+  int err, i;
+
+  for (i = 0; i < 7; i++) {
+    err = heap_push(*state, (void *)values[i], NULL);
+    assert_int_equal(err, UTILS_OK);
+  }
+  assert_int_equal(heap_length(*state), 7);
+  assert_int_equal(ctor_count, 7);
+  assert_int_equal((long)heap_peek(*state), 1);
+  assert_int_equal(heap_length(*state), 7);
+
+  drain(*state, 3);
+  assert_int_equal((long)heap_peek(*state), 5);
+  /* the destructor runs for the items left in the queue */
+}
+
+static void
+test_heap_random(void **state)
+{
+  int err, i;
+
+  srand(3);
+  for (i = 0; i < NITEMS; i++) {
+    err = heap_push(*state, (void *)(long)(rand() % 1000), NULL);
+    assert_int_equal(err, UTILS_OK);
+  }
+  drain(*state, NITEMS);
+  assert_null(heap_pop(*state));
+  assert_null(heap_peek(*state));
+}
+
+static void
+test_heap_push_n(void **state)
+{
+  static void *data[NITEMS];
+  int err, i;
+
+  srand(4);
+  for (i = 0; i < NITEMS; i++)
+    data[i] = (void *)(long)(rand() % 1000);
+
+  /* a large array rebuilds the heap, a small one is sifted in */
+  err = heap_push_n(*state, data, NITEMS / 2);
+  assert_int_equal(err, UTILS_OK);
+  err = heap_push_n(*state, &data[NITEMS / 2], NITEMS / 8);
+  assert_int_equal(err, UTILS_OK);
+  err = heap_push_n(*state, &data[NITEMS / 2 + NITEMS / 8],
+		    NITEMS - NITEMS / 2 - NITEMS / 8);
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal(heap_length(*state), NITEMS);
+  assert_int_equal(ctor_count, NITEMS);
+  drain(*state, NITEMS);
+}
+
+static void
+test_heap_update(void **state)
+{
+  static struct timer timers[NITEMS];
+  struct timer *timer;
+  heap_t heap;
+  long last;
+  int err, i, count;
+
+  err = heap_init(&heap, cmp_timer, NULL, NULL);
+  assert_int_equal(err, UTILS_OK);
+  srand(5);
+  for (i = 0; i < NITEMS; i++) {
+    timers[i].deadline = rand() % 10000;
+    err = heap_push(heap, &timers[i], &timers[i].entry);
+    assert_int_equal(err, UTILS_OK);
+  }
+
+  /* move deadlines in both directions and cancel some timers */
+  for (i = 0; i < NITEMS; i += 2) {
+    timers[i].deadline = (i % 4) ? timers[i].deadline / 2 :
+      timers[i].deadline * 2;
+    err = heap_update(heap, timers[i].entry);
+    assert_int_equal(err, UTILS_OK);
+    assert_ptr_equal(heap_entry_data(heap, timers[i].entry), &timers[i]);
+  }
+  count = NITEMS;
+  for (i = 1; i < NITEMS; i += 3) {
+    assert_ptr_equal(heap_remove(heap, timers[i].entry), &timers[i]);
+    count--;
+  }
+  assert_int_equal(heap_length(heap), count);
+
+  last = -1;
+  for (i = 0; i < count; i++) {
+    timer = heap_pop(heap);
+    assert_true(timer->deadline >= last);
+    assert_int_not_equal((timer - timers) % 3, 1);
+    last = timer->deadline;
+  }
+  assert_null(heap_pop(heap));
+  heap_destroy(heap);
+}
+
+static void
+test_heap_empty(void **state)
+{
+  heap_t heap;
+
+  assert_int_equal(heap_length(*state), 0);
+  assert_null(heap_pop(*state));
+  assert_null(heap_peek(*state));
+  assert_int_equal(heap_update(*state, NULL), UTILS_ERROR);
+  assert_null(heap_remove(*state, NULL));
+  assert_int_equal(heap_push_n(*state, NULL, 0), UTILS_OK);
+
+  assert_int_equal(heap_init(&heap, NULL, NULL, NULL), UTILS_ERROR);
+  assert_int_equal(heap_init(NULL, cmp_long, NULL, NULL), UTILS_ERROR);
+  assert_int_equal(heap_length(NULL), -UTILS_ERROR);
+  assert_int_equal(heap_destroy(NULL), UTILS_ERROR);
+}
+
+int
+main(int argc, char *argv[])
+{
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test_setup_teardown(test_heap_push_pop,
+				    setup_heap,
+				    teardown_heap),
+    cmocka_unit_test_setup_teardown(test_heap_random,
+				    setup_heap,
+				    teardown_heap),
+    cmocka_unit_test_setup_teardown(test_heap_push_n,
+				    setup_heap,
+				    teardown_heap),
+    cmocka_unit_test(test_heap_update),
+    cmocka_unit_test_setup_teardown(test_heap_empty,
+				    setup_heap,
+				    teardown_heap),
+  };
+  return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,211 @@
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <string.h>
+
+#include "libutils/error.h"
+#include "libutils/ilist.h"
+
+/* number of objects in the test list */
+#define NOBJS 4
+
+struct object {
+  int value;
+  struct ilist_link link;
+};
+
+static struct object objs[NOBJS];
+static struct ilist list;
+static int walk_count = 0;
+
+static int
+walk_cbk(struct ilist_link *link, void *args)
+{
+  struct object *obj = ilist_entry(link, struct object, link);
+
+  walk_count++;
+  if (args != NULL && obj->value == *(int *)args)
+    return UTILS_ITER_STOP;
+  return UTILS_OK;
+}
+
+static int
+walk_err_cbk(struct ilist_link *link, void *args)
+{
+  walk_count++;
+  return UTILS_ERROR;
+}
+
+static int
+walk_remove_cbk(struct ilist_link *link, void *args)
+{
+  return ilist_remove(args, link);
+}
+
+static int
+setup_ilist(void **state)
+{
+  int i, err;
+
+  walk_count = 0;
+  err = ilist_init(&list);
+  if (err)
+    return err;
+  for (i = 0; i < NOBJS; i++) {
+    objs[i].value = i;
+    err = ilist_append(&list, &objs[i].link);
+    if (err)
+      return err;
+  }
+  *state = &list;
+  return 0;
+}
+
+static void
+test_ilist_inv_hnd(void **state)
+{
+  struct ilist_link link;
+  int err;
+
+  err = ilist_init(NULL);
+  assert_int_equal(err, UTILS_ERROR);
+  err = ilist_push(NULL, &link);
+  assert_int_equal(err, UTILS_ERROR);
+  err = ilist_append(NULL, &link);
+  assert_int_equal(err, UTILS_ERROR);
+  err = ilist_remove(NULL, &link);
+  assert_int_equal(err, UTILS_ERROR);
+  err = ilist_walk(NULL, walk_cbk, NULL);
+  assert_int_equal(err, UTILS_ERROR);
+  assert_null(ilist_pop(NULL));
+  assert_true(ilist_length(NULL) < 0);
+}
+
+static void
+test_ilist_empty(void **state)
+{
+  struct ilist empty;
+  int err;
+
+  err = ilist_init(&empty);
+  assert_int_equal(err, UTILS_OK);
+  assert_true(ilist_empty(&empty));
+  assert_int_equal(ilist_length(&empty), 0);
+  assert_null(ilist_first(&empty));
+  assert_null(ilist_last(&empty));
+  assert_null(ilist_pop(&empty));
+  /* the head is not a removable link */
+  err = ilist_remove(&empty, &empty.head);
+  assert_int_equal(err, UTILS_ERROR);
+}
+
+static void
+test_ilist_order(void **state)
+{
+  struct ilist_link *link;
+  struct object extra;
+  int expect;
+
+  assert_int_equal(ilist_length(*state), NOBJS);
+  expect = 0;
+  ilist_foreach(&list, link) {
+    assert_int_equal(ilist_entry(link, struct object, link)->value, expect);
+    expect++;
+  }
+  assert_int_equal(expect, NOBJS);
+
+  /* push and insert around existing links */
+  extra.value = -1;
+  ilist_push(*state, &extra.link);
+  assert_ptr_equal(ilist_first(*state), &extra.link);
+  ilist_remove(*state, &extra.link);
+  ilist_insert_after(*state, &objs[1].link, &extra.link);
+  assert_ptr_equal(objs[1].link.next, &extra.link);
+  assert_ptr_equal(objs[2].link.prev, &extra.link);
+  ilist_remove(*state, &extra.link);
+  ilist_insert_before(*state, &objs[0].link, &extra.link);
+  assert_ptr_equal(ilist_first(*state), &extra.link);
+  assert_int_equal(ilist_length(*state), NOBJS + 1);
+}
+
+static void
+test_ilist_pop(void **state)
+{
+  struct ilist_link *link;
+  int i;
+
+  for (i = 0; i < NOBJS; i++) {
+    link = ilist_pop(*state);
+    assert_ptr_equal(link, &objs[i].link);
+  }
+  assert_true(ilist_empty(*state));
+  assert_null(ilist_pop(*state));
+}
+
+static void
+test_ilist_walk(void **state)
+{
+  int stop = 1;
+  int err;
+
+  err = ilist_walk(*state, walk_cbk, NULL);
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal(walk_count, NOBJS);
+
+  walk_count = 0;
+  err = ilist_walk(*state, walk_cbk, &stop);
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal(walk_count, 2);
+
+  walk_count = 0;
+  err = ilist_walk(*state, walk_err_cbk, NULL);
+  assert_int_equal(err, UTILS_ERROR);
+  assert_int_equal(walk_count, 1);
+
+  /* remove all the links while walking */
+  err = ilist_walk(*state, walk_remove_cbk, *state);
+  assert_int_equal(err, UTILS_OK);
+  assert_true(ilist_empty(*state));
+}
+
+static void
+test_ilist_iter_remove(void **state)
+{
+  ilist_iter_struct_t iter;
+  struct ilist_link *link;
+  int count = 0;
+  int err;
+
+  /* remove odd values during iteration */
+  for (ilist_iter_init(*state, &iter); !ilist_iter_end(&iter);
+       ilist_iter_next(&iter)) {
+    link = ilist_iter_link(&iter);
+    if (ilist_entry(link, struct object, link)->value % 2) {
+      err = ilist_remove(*state, link);
+      assert_int_equal(err, UTILS_OK);
+    }
+    count++;
+  }
+  assert_int_equal(count, NOBJS);
+  assert_null(ilist_iter_link(&iter));
+  assert_int_equal(ilist_length(*state), NOBJS / 2);
+  assert_ptr_equal(ilist_first(*state), &objs[0].link);
+  assert_ptr_equal(ilist_last(*state), &objs[2].link);
+}
+
+int
+main(int argc, char *argv[])
+{
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test(test_ilist_inv_hnd),
+    cmocka_unit_test(test_ilist_empty),
+    cmocka_unit_test_setup(test_ilist_order, setup_ilist),
+    cmocka_unit_test_setup(test_ilist_pop, setup_ilist),
+    cmocka_unit_test_setup(test_ilist_walk, setup_ilist),
+    cmocka_unit_test_setup(test_ilist_iter_remove, setup_ilist),
+  };
+  return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,296 @@
+#include "list_test.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/* number of items in the allocator tests */
+#define NALLOC 1000
+
+/* counting allocator, fails after a number of allocations */
+struct counter {
+  long allocs;
+  long frees;
+  long limit;
+};
+
+static void *
+counter_alloc(size_t size, void *ctx)
+{
+  struct counter *counter = ctx;
+
+  if (counter->limit >= 0 && counter->allocs >= counter->limit)
+    return NULL;
+  counter->allocs++;
+  return malloc(size);
+}
+
+static void
+counter_free(void *ptr, void *ctx)
+{
+  struct counter *counter = ctx;
+
+  counter->frees++;
+  free(ptr);
+}
+
+static void
+test_list_allocator_modes(void **state)
+{
+  int modes[] = {
+    0, LIST_MODE_INDEXED, LIST_MODE_UNROLLED, LIST_MODE_HASHED,
+    LIST_MODE_SPARSE, LIST_MODE_SNAPSHOT | LIST_MODE_INDEXED,
+  };
+  struct counter counter;
+  list_allocator_t allocator = {counter_alloc, counter_free, &counter};
+  list_iter_t iter;
+  list_t lst, snap;
+  long i;
+  int m, err;
+
+  for (m = 0; m < sizeof(modes) / sizeof(modes[0]); m++) {
+    counter.allocs = 0;
+    counter.frees = 0;
+    counter.limit = -1;
+    err = list_init_ex(&lst, NULL, NULL, modes[m], &allocator);
+    assert_int_equal(err, UTILS_OK);
+    for (i = 0; i < NALLOC; i++) {
+      err = list_insert(lst, (void *)i, (i % 3) ? i / 2 : i);
+      assert_int_equal(err, UTILS_OK);
+    }
+    if (modes[m] & LIST_MODE_SPARSE) {
+      err = list_insert(lst, NULL, 2 * NALLOC);
+      assert_int_equal(err, UTILS_OK);
+    }
+    for (i = 0; i < NALLOC / 2; i++)
+      list_remove(lst, i);
+    iter = list_iter(lst);
+    assert_non_null(iter);
+    list_iter_next(iter);
+    list_iter_free(iter);
+    if (modes[m] & LIST_MODE_SNAPSHOT) {
+      list_publish(lst);
+      snap = list_snapshot(lst);
+      list_snapshot_release(snap);
+    }
+
+    /* everything the list allocated went through the allocator */
+    assert_true(counter.allocs > NALLOC / 64);
+    list_destroy(lst);
+    assert_int_equal(counter.allocs, counter.frees);
+  }
+}
+
+static int
+cmp_long(void *itm_data_a, void *itm_data_b)
+{
+  return (long)itm_data_a - (long)itm_data_b;
+}
+
+static void
+test_list_allocator_scratch(void **state)
+{
+  struct counter counter = {0, 0, -1};
+  list_allocator_t allocator = {counter_alloc, counter_free, &counter};
+  void *data[NALLOC];
+  list_t lst;
+  long i, allocs;
+  int err;
+
+  err = list_init_ex(&lst, NULL, NULL, LIST_MODE_UNROLLED, &allocator);
+  assert_int_equal(err, UTILS_OK);
+  for (i = 0; i < NALLOC; i++)
+    data[i] = (void *)(NALLOC - i);
+  allocs = counter.allocs;
+  err = list_append_n(lst, data, NALLOC);
+  assert_int_equal(err, UTILS_OK);
+  assert_true(counter.allocs > allocs);
+
+  /* the sort buffer is the only allocation of the sort */
+  counter.limit = counter.allocs;
+  assert_int_equal(list_sort(lst, cmp_long), UTILS_ERROR);
+  counter.limit = -1;
+  allocs = counter.allocs;
+  err = list_sort(lst, cmp_long);
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal(counter.allocs, allocs + 1);
+  assert_int_equal((long)list_get(lst, 0), 1);
+  list_destroy(lst);
+  assert_int_equal(counter.allocs, counter.frees);
+}
+
+static int
+encode_long(void *itm_data, void *record, void *args)
+{
+  memcpy(record, &itm_data, sizeof(long));
+  return UTILS_OK;
+}
+
+static int
+decode_long(const void *record, void **data, void *args)
+{
+  memcpy(data, record, sizeof(long));
+  return UTILS_OK;
+}
+
+static void
+test_list_allocator_serialize(void **state)
+{
+  struct counter counter = {0, 0, -1};
+  list_allocator_t allocator = {counter_alloc, counter_free, &counter};
+  FILE *stream;
+  list_t lst;
+  long i, allocs;
+  int err;
+
+  stream = tmpfile();
+  assert_non_null(stream);
+  err = list_init_ex(&lst, NULL, NULL, 0, &allocator);
+  assert_int_equal(err, UTILS_OK);
+  for (i = 0; i < NALLOC; i++)
+    list_append(lst, (void *)i);
+
+  /* the record block is the only allocation of the serialization */
+  counter.limit = counter.allocs;
+  assert_int_equal(list_serialize(lst, stream, sizeof(long), encode_long,
+				  NULL), UTILS_ERROR);
+  assert_int_equal(ftell(stream), 0);
+  counter.limit = -1;
+  allocs = counter.allocs;
+  err = list_serialize(lst, stream, sizeof(long), encode_long, NULL);
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal(counter.allocs, allocs + 1);
+  list_destroy(lst);
+  assert_int_equal(counter.allocs, counter.frees);
+
+  /* the record block is taken before the items */
+  err = list_init_ex(&lst, NULL, NULL, 0, &allocator);
+  assert_int_equal(err, UTILS_OK);
+  rewind(stream);
+  counter.limit = counter.allocs;
+  assert_int_equal(list_deserialize(lst, stream, decode_long, NULL),
+		   UTILS_ERROR);
+  assert_int_equal(list_length(lst), 0);
+  counter.limit = -1;
+  rewind(stream);
+  allocs = counter.allocs;
+  err = list_deserialize(lst, stream, decode_long, NULL);
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal(list_length(lst), NALLOC);
+  assert_int_equal((long)list_get(lst, NALLOC - 1), NALLOC - 1);
+  assert_true(counter.allocs > allocs + 1);
+  assert_int_equal(counter.allocs - counter.frees, NALLOC + 1);
+  list_destroy(lst);
+  assert_int_equal(counter.allocs, counter.frees);
+  fclose(stream);
+}
+
+static void
+test_list_allocator_iter(void **state)
+{
+  struct counter counter = {0, 0, -1};
+  list_allocator_t allocator = {counter_alloc, counter_free, &counter};
+  list_iter_t iter;
+  list_t lst;
+  int err;
+
+  err = list_init_ex(&lst, NULL, NULL, 0, &allocator);
+  assert_int_equal(err, UTILS_OK);
+  err = list_append(lst, NULL);
+  assert_int_equal(err, UTILS_OK);
+  iter = list_iter(lst);
+  assert_non_null(iter);
+
+  /* the iterator is released by the allocator of its list */
+  list_destroy(lst);
+  assert_int_equal(counter.allocs, counter.frees + 1);
+  assert_int_equal(list_iter_free(iter), UTILS_OK);
+  assert_int_equal(counter.allocs, counter.frees);
+}
+
+static void
+test_list_allocator_failure(void **state)
+{
+  struct counter counter = {0, 0, 10};
+  list_allocator_t allocator = {counter_alloc, counter_free, &counter};
+  list_t lst;
+  void *data[20];
+  long i;
+  int err;
+
+  /* the handle takes the first allocation */
+  err = list_init_ex(&lst, ctor, dtor, 0, &allocator);
+  assert_int_equal(err, UTILS_OK);
+  for (i = 0; i < 9; i++) {
+    err = list_append(lst, (void *)i);
+    assert_int_equal(err, UTILS_OK);
+  }
+  assert_int_equal(list_append(lst, NULL), UTILS_ERROR);
+  for (i = 0; i < 20; i++)
+    data[i] = (void *)i;
+  assert_int_equal(list_append_n(lst, data, 20), UTILS_ERROR);
+  assert_null(list_iter(lst));
+  assert_int_equal(list_length(lst), 9);
+  list_destroy(lst);
+  assert_int_equal(counter.allocs, counter.frees);
+  assert_int_equal(ctor_count, dtor_count);
+
+  counter.limit = 0;
+  assert_int_equal(list_init_ex(&lst, NULL, NULL, 0, &allocator),
+		   UTILS_ERROR);
+}
+
+static void
+test_list_allocator_move(void **state)
+{
+  struct counter counter = {0, 0, -1}, other = {0, 0, -1};
+  list_allocator_t allocator = {counter_alloc, counter_free, &counter};
+  list_allocator_t other_allocator = {counter_alloc, counter_free, &other};
+  list_allocator_t invalid = {counter_alloc, NULL, &counter};
+  list_t a, b, c, out;
+  long i;
+  int err;
+
+  err = list_init_ex(&a, NULL, NULL, 0, &allocator);
+  assert_int_equal(err, UTILS_OK);
+  err = list_init_ex(&b, NULL, NULL, 0, &allocator);
+  assert_int_equal(err, UTILS_OK);
+  err = list_init_ex(&c, NULL, NULL, 0, &other_allocator);
+  assert_int_equal(err, UTILS_OK);
+  for (i = 0; i < 10; i++) {
+    list_append(a, (void *)i);
+    list_append(b, (void *)i);
+    list_append(c, (void *)i);
+  }
+
+  /* items only move between lists releasing them the same way */
+  assert_int_equal(list_concat(a, c), UTILS_ERROR);
+  assert_int_equal(list_splice(c, 0, b), UTILS_ERROR);
+  err = list_concat(a, b);
+  assert_int_equal(err, UTILS_OK);
+  err = list_split(a, 5, &out);
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal(list_length(out), 15);
+  list_destroy(a);
+  list_destroy(b);
+  list_destroy(out);
+  list_destroy(c);
+  assert_int_equal(counter.allocs, counter.frees);
+  assert_int_equal(other.allocs, other.frees);
+  assert_int_equal(other.allocs, 11);
+
+  assert_int_equal(list_init_ex(&a, NULL, NULL, 0, &invalid), UTILS_ERROR);
+}
+
+int
+main(int argc, char *argv[])
+{
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test(test_list_allocator_modes),
+    cmocka_unit_test(test_list_allocator_scratch),
+    cmocka_unit_test(test_list_allocator_serialize),
+    cmocka_unit_test(test_list_allocator_iter),
+    cmocka_unit_test(test_list_allocator_failure),
+    cmocka_unit_test(test_list_allocator_move),
+  };
+  return cmocka_run_group_tests(tests, NULL, NULL);
+}
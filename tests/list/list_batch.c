@@ -0,0 +1,161 @@
+
+#include "list_test.h"
+
+/* number of items inserted by the large batch */
+#define NBATCH 1000
+
+static char *data[] = {"a", "b", "c", "d"};
+
+static void
+test_list_batch_append(void **state)
+{
+  int err, i;
+
+  err = list_append_n(*state, (void **)data, 4);
+  assert_int_equal(err, UTILS_OK);
+  err = list_append_n(*state, (void **)data, 2);
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal(list_length(*state), 6);
+  assert_int_equal(ctor_count, 6);
+  for (i = 0; i < 4; i++)
+    assert_string_equal(list_get(*state, i), data[i]);
+  assert_string_equal(list_get(*state, 4), "a");
+  assert_string_equal(list_get(*state, 5), "b");
+
+  /* single insertions mix with the batch nodes */
+  err = list_insert(*state, "x", 3);
+  assert_int_equal(err, UTILS_OK);
+  assert_string_equal(list_get(*state, 3), "x");
+  assert_string_equal(list_remove(*state, 0), "a");
+  assert_int_equal(list_length(*state), 6);
+}
+
+static void
+test_list_batch_push(void **state)
+{
+  int err, i;
+
+  /* the list already holds items allocated without a pool */
+  err = list_push_n(*state, (void **)data, 4);
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal(list_length(*state), 8);
+  for (i = 0; i < 4; i++)
+    assert_string_equal(list_get(*state, i), data[i]);
+  assert_string_equal(list_get(*state, 4), "0");
+  assert_string_equal(list_get(*state, 7), "3");
+
+  /* release both kinds of nodes */
+  assert_string_equal(list_pop(*state), "a");
+  err = list_delete(*state, 4);
+  assert_int_equal(err, UTILS_OK);
+  err = list_destroy(*state);
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal(dtor_count, 7);
+}
+
+static void
+test_list_batch_empty(void **state)
+{
+  int err;
+
+  err = list_append_n(*state, NULL, 0);
+  assert_int_equal(err, UTILS_OK);
+  err = list_push_n(*state, (void **)data, 0);
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal(list_length(*state), 0);
+  err = list_append_n(*state, NULL, 1);
+  assert_int_equal(err, UTILS_ERROR);
+  err = list_append_n(NULL, (void **)data, 1);
+  assert_int_equal(err, UTILS_ERROR);
+  err = list_push_n(NULL, (void **)data, 1);
+  assert_int_equal(err, UTILS_ERROR);
+}
+
+static void
+test_list_batch_modes(void **state)
+{
+  int modes[] = {LIST_MODE_INDEXED, LIST_MODE_UNROLLED};
+  void *items[NBATCH];
+  list_t lst;
+  long i;
+  int m, err;
+
+  for (i = 0; i < NBATCH; i++)
+    items[i] = (void *)(i + 1);
+  for (m = 0; m < 2; m++) {
+    err = list_init_mode(&lst, NULL, NULL, modes[m]);
+    assert_int_equal(err, UTILS_OK);
+    err = list_append(lst, (void *)-1);
+    assert_int_equal(err, UTILS_OK);
+    err = list_append_n(lst, items, NBATCH);
+    assert_int_equal(err, UTILS_OK);
+    err = list_push_n(lst, items, NBATCH);
+    assert_int_equal(err, UTILS_OK);
+    assert_int_equal(list_length(lst), 2 * NBATCH + 1);
+    for (i = 0; i < NBATCH; i++) {
+      assert_ptr_equal(list_get(lst, i), items[i]);
+      assert_ptr_equal(list_get(lst, NBATCH + 1 + i), items[i]);
+    }
+    assert_ptr_equal(list_get(lst, NBATCH), (void *)-1);
+    list_destroy(lst);
+  }
+}
+
+static void
+test_list_batch_split(void **state)
+{
+  list_t a, b, c;
+  long i;
+  void *items[10];
+  int err;
+
+  for (i = 0; i < 10; i++)
+    items[i] = (void *)i;
+  /* a batch leaves a plain list movable to other plain lists */
+  err = list_init(&a, NULL, NULL);
+  assert_int_equal(err, UTILS_OK);
+  err = list_init(&c, NULL, NULL);
+  assert_int_equal(err, UTILS_OK);
+  err = list_append_n(a, items, 10);
+  assert_int_equal(err, UTILS_OK);
+  err = list_split(a, 5, &b);
+  assert_int_equal(err, UTILS_OK);
+  err = list_concat(c, b);
+  assert_int_equal(err, UTILS_OK);
+  err = list_concat(c, a);
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal(list_length(c), 10);
+  assert_ptr_equal(list_get(c, 0), (void *)5L);
+  assert_ptr_equal(list_get(c, 9), (void *)4L);
+  list_destroy(a);
+  list_destroy(b);
+  list_destroy(c);
+
+  /* pooled lists take the batch nodes from a single slab */
+  err = list_init_pool(&a, NULL, NULL, NULL);
+  assert_int_equal(err, UTILS_OK);
+  err = list_append(a, (void *)-1L);
+  assert_int_equal(err, UTILS_OK);
+  err = list_append_n(a, items, 10);
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal(list_delete(a, 0), UTILS_OK);
+  assert_ptr_equal(list_get(a, 9), (void *)9L);
+  list_destroy(a);
+}
+
+int
+main(int argc, char *argv[])
+{
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test_setup_teardown(test_list_batch_append,
+				    setup_list_empty,
+				    teardown_list),
+    cmocka_unit_test_setup(test_list_batch_push, setup_list_3),
+    cmocka_unit_test_setup_teardown(test_list_batch_empty,
+				    setup_list_empty,
+				    teardown_list),
+    cmocka_unit_test(test_list_batch_modes),
+    cmocka_unit_test(test_list_batch_split),
+  };
+  return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,201 @@
+
+#include "list_test.h"
+
+#include <pthread.h>
+
+/* number of worker threads and operations per thread */
+#define NTHREADS 8
+#define NOPS 2000
+
+struct worker_args {
+  list_t lst;
+  long id;
+  long popped;
+};
+
+static int
+setup_list_concurrent(void **state)
+{
+  list_t lst;
+  int err;
+
+  err = list_init_mode(&lst, NULL, NULL, LIST_MODE_CONCURRENT);
+  if (err)
+    return err;
+  *state = lst;
+  return 0;
+}
+
+static void *
+worker_push_pop(void *data)
+{
+  struct worker_args *args = data;
+  long i;
+
+  for (i = 0; i < NOPS; i++) {
+    if (i % 2)
+      list_push(args->lst, (void *)args->id);
+    else
+      list_append(args->lst, (void *)args->id);
+    if (list_pop(args->lst) != NULL)
+      args->popped++;
+  }
+  return NULL;
+}
+
+static void *
+worker_append(void *data)
+{
+  struct worker_args *args = data;
+  long i;
+
+  for (i = 0; i < NOPS; i++)
+    list_append(args->lst, (void *)args->id);
+  return NULL;
+}
+
+static void *
+worker_pop(void *data)
+{
+  struct worker_args *args = data;
+
+  while (args->popped < NOPS)
+    if (list_pop(args->lst) != NULL)
+      args->popped++;
+  return NULL;
+}
+
+static void *
+worker_read(void *data)
+{
+  struct worker_args *args = data;
+  long i;
+
+  for (i = 0; i < NOPS; i++) {
+    list_length(args->lst);
+    list_get(args->lst, 0);
+  }
+  return NULL;
+}
+
+static int
+count_cbk(void *item, void *args)
+{
+  ((long *)args)[(long)item]++;
+  return UTILS_OK;
+}
+
+static void
+test_list_concurrent_push_pop(void **state)
+{
+  pthread_t threads[NTHREADS];
+  struct worker_args args[NTHREADS];
+  long popped = 0;
+  int i;
+
+  for (i = 0; i < NTHREADS; i++) {
+    args[i].lst = *state;
+    args[i].id = i + 1;
+    args[i].popped = 0;
+    pthread_create(&threads[i], NULL, worker_push_pop, &args[i]);
+  }
+  for (i = 0; i < NTHREADS; i++) {
+    pthread_join(threads[i], NULL);
+    popped += args[i].popped;
+  }
+  /* every pop follows a push, so no pop can fail */
+  assert_int_equal(popped, NTHREADS * NOPS);
+  assert_int_equal(list_length(*state), 0);
+}
+
+static void
+test_list_concurrent_append(void **state)
+{
+  pthread_t threads[NTHREADS];
+  struct worker_args args[NTHREADS];
+  long count[NTHREADS + 1] = {0};
+  int err, i;
+
+  for (i = 0; i < NTHREADS; i++) {
+    args[i].lst = *state;
+    args[i].id = i + 1;
+    pthread_create(&threads[i], NULL, worker_append, &args[i]);
+  }
+  for (i = 0; i < NTHREADS; i++)
+    pthread_join(threads[i], NULL);
+
+  assert_int_equal(list_length(*state), NTHREADS * NOPS);
+  err = list_walk(*state, count_cbk, count);
+  assert_int_equal(err, UTILS_OK);
+  for (i = 1; i <= NTHREADS; i++)
+    assert_int_equal(count[i], NOPS);
+}
+
+static void
+test_list_concurrent_order(void **state)
+{
+  list_iter_struct_t iter;
+  long i;
+
+  /* appended items wait out of the list until it is read */
+  list_append(*state, (void *)2);
+  list_append(*state, (void *)3);
+  list_push(*state, (void *)1);
+  assert_int_equal(list_length(*state), 3);
+  list_append(*state, (void *)4);
+  assert_ptr_equal(list_get(*state, 3), (void *)4);
+  list_append(*state, (void *)5);
+  list_iter_init(*state, &iter);
+  for (i = 1; !list_iter_end(&iter); list_iter_next(&iter), i++)
+    assert_ptr_equal(list_iter_data(&iter), (void *)i);
+  assert_int_equal(i, 6);
+  list_append(*state, (void *)6);
+  for (i = 1; i <= 6; i++)
+    assert_ptr_equal(list_pop(*state), (void *)i);
+  assert_null(list_pop(*state));
+  assert_int_equal(list_length(*state), 0);
+}
+
+static void
+test_list_concurrent_queue(void **state)
+{
+  pthread_t threads[NTHREADS];
+  struct worker_args args[NTHREADS];
+  int i;
+
+  /* as many producers as consumers, the other threads read */
+  for (i = 0; i < NTHREADS; i++) {
+    args[i].lst = *state;
+    args[i].id = i + 1;
+    args[i].popped = 0;
+    if (i % 4 == 0)
+      pthread_create(&threads[i], NULL, worker_append, &args[i]);
+    else if (i % 4 == 1)
+      pthread_create(&threads[i], NULL, worker_pop, &args[i]);
+    else
+      pthread_create(&threads[i], NULL, worker_read, &args[i]);
+  }
+  for (i = 0; i < NTHREADS; i++)
+    pthread_join(threads[i], NULL);
+  assert_int_equal(list_length(*state), 0);
+}
+
+int
+main(int argc, char *argv[])
+{
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test_setup_teardown(test_list_concurrent_push_pop,
+				    setup_list_concurrent,
+				    teardown_list),
+    cmocka_unit_test_setup_teardown(test_list_concurrent_append,
+				    setup_list_concurrent,
+				    teardown_list),
+    cmocka_unit_test_setup_teardown(test_list_concurrent_order,
+				    setup_list_concurrent,
+				    teardown_list),
+    cmocka_unit_test_setup_teardown(test_list_concurrent_queue,
+				    setup_list_concurrent,
+				    teardown_list),
+  };
+  return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,166 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "libutils/list.hpp"
+
+/* number of values in the C++ list tests */
+#define NVALUES 100
+
+/* count live values of the tracked type */
+static int live_count = 0;
+
+struct tracked {
+  std::unique_ptr<int> value;
+  bool throws;
+
+  explicit tracked(int v, bool fail = false) : value(new int(v)), throws(fail)
+  {
+    if (fail)
+      throw std::runtime_error("tracked");
+    live_count++;
+  }
+
+  tracked(tracked &&other) : value(std::move(other.value)), throws(false)
+  {
+    live_count++;
+  }
+
+  ~tracked()
+  {
+    live_count--;
+  }
+};
+
+static void
+test_list_cpp_insert(void **state)
+{
+  libutils::list<std::string> lst;
+  std::string value("a value long enough to be allocated by the string");
+  int i;
+
+  assert_true(lst.empty());
+  for (i = 0; i < NVALUES; i++)
+    lst.push_back(std::to_string(i));
+  lst.push_front(std::move(value));
+  lst.emplace_front(3, 'x');
+  assert_int_equal(lst.size(), NVALUES + 2);
+  assert_true(lst.front() == "xxx");
+  assert_true(lst[1].size() > 40);
+  assert_true(lst.back() == std::to_string(NVALUES - 1));
+  assert_true(lst.at(2) == "0");
+
+  i = 0;
+  for (std::string &s : lst) {
+    if (i >= 2)
+      assert_true(s == std::to_string(i - 2));
+    i++;
+  }
+  assert_int_equal(i, NVALUES + 2);
+
+  lst.pop_front();
+  lst.pop_back();
+  assert_int_equal(lst.size(), NVALUES);
+  assert_true(lst.back() == std::to_string(NVALUES - 2));
+  try {
+    lst.at(NVALUES);
+  }
+  catch (std::out_of_range &) {
+    i = -1;
+  }
+  assert_int_equal(i, -1);
+}
+
+static void
+test_list_cpp_erase(void **state)
+{
+  libutils::list<int> lst(LIST_MODE_INDEXED);
+  libutils::list<int>::iterator it;
+  int i, sum = 0;
+
+  for (i = 0; i < NVALUES; i++)
+    lst.emplace_back(i);
+  /* keep the even values */
+  for (it = lst.begin(); it != lst.end();)
+    if (*it % 2)
+      it = lst.erase(it);
+    else
+      ++it;
+  assert_int_equal(lst.size(), NVALUES / 2);
+  assert_int_equal(lst[10], 20);
+
+  const libutils::list<int> &clst = lst;
+  for (libutils::list<int>::const_iterator cit = clst.begin();
+       cit != clst.end(); ++cit)
+    sum += *cit;
+  assert_int_equal(sum, (NVALUES / 2) * (NVALUES / 2 - 1));
+  assert_int_equal(list_length(lst.native()), NVALUES / 2);
+
+  lst.clear();
+  assert_true(lst.empty());
+  assert_true(lst.begin() == lst.end());
+  lst.push_back(1);
+  assert_int_equal(lst.front(), 1);
+
+  try {
+    libutils::list<int> unrolled(LIST_MODE_UNROLLED);
+  }
+  catch (std::invalid_argument &) {
+    sum = -1;
+  }
+  assert_int_equal(sum, -1);
+}
+
+static void
+test_list_cpp_ownership(void **state)
+{
+  std::vector<libutils::list<tracked>> lists;
+  int i;
+
+  live_count = 0;
+  {
+    libutils::list<tracked> lst;
+
+    for (i = 0; i < NVALUES; i++)
+      lst.emplace_back(i);
+    try {
+      lst.emplace_back(-1, true);
+    }
+    catch (std::runtime_error &) {
+      i = -1;
+    }
+    assert_int_equal(i, -1);
+    /* the value that failed to construct is not kept */
+    assert_int_equal(lst.size(), NVALUES);
+    assert_int_equal(*lst.back().value, NVALUES - 1);
+    assert_int_equal(live_count, NVALUES);
+
+    lists.push_back(std::move(lst));
+    assert_true(lst.empty());
+    lst.emplace_back(0);
+    lists.push_back(std::move(lst));
+    lists[1] = std::move(lists[0]);
+    assert_int_equal(live_count, NVALUES);
+    lists[1].erase(lists[1].begin());
+    assert_int_equal(*lists[1].front().value, 1);
+    assert_int_equal(live_count, NVALUES - 1);
+  }
+  lists.clear();
+  assert_int_equal(live_count, 0);
+}
+
+int
+main(int argc, char *argv[])
+{
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test(test_list_cpp_insert),
+    cmocka_unit_test(test_list_cpp_erase),
+    cmocka_unit_test(test_list_cpp_ownership),
+  };
+  return cmocka_run_group_tests(tests, NULL, NULL);
+}
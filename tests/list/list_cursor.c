@@ -0,0 +1,102 @@
+
+#include "list_test.h"
+
+#include <stdlib.h>
+
+/* number of random operations checked against the array model */
+#define NCURSOR_OPS 5000
+/* maximum length of the model */
+#define NCURSOR_MAX 200
+
+static long model[NCURSOR_MAX];
+static int model_len = 0;
+
+static void
+model_insert(int position, long value)
+{
+  memmove(&model[position + 1], &model[position],
+	  (model_len - position) * sizeof(long));
+  model[position] = value;
+  model_len++;
+}
+
+static void
+model_remove(int position)
+{
+  model_len--;
+  memmove(&model[position], &model[position + 1],
+	  (model_len - position) * sizeof(long));
+}
+
+static void
+test_list_cursor_sequential(void **state)
+{
+  long i;
+
+  for (i = 0; i < NCURSOR_MAX; i++)
+    list_append(*state, (void *)i);
+  for (i = 0; i < NCURSOR_MAX; i++)
+    assert_int_equal((long)list_get(*state, i), i);
+  for (i = NCURSOR_MAX - 1; i >= 0; i--)
+    assert_int_equal((long)list_get(*state, i), i);
+  for (i = 0; i < NCURSOR_MAX; i += 7)
+    assert_int_equal((long)list_get(*state, i), i);
+
+  /* remove every other item walking forward */
+  for (i = 0; i < NCURSOR_MAX / 2; i++)
+    assert_int_equal((long)list_remove(*state, i), 2 * i);
+  for (i = 0; i < NCURSOR_MAX / 2; i++)
+    assert_int_equal((long)list_get(*state, i), 2 * i + 1);
+}
+
+static void
+test_list_cursor_random(void **state)
+{
+  long value = 0;
+  int i, op, position;
+
+  srand(3);
+  model_len = 0;
+  for (i = 0; i < NCURSOR_OPS; i++) {
+    op = rand() % 4;
+    position = (model_len > 0) ? rand() % model_len : 0;
+    if (op == 0 && model_len < NCURSOR_MAX) {
+      position = rand() % (model_len + 1);
+      assert_int_equal(list_insert(*state, (void *)value, position),
+		       UTILS_OK);
+      model_insert(position, value++);
+    }
+    else if (op == 1 && model_len > 0) {
+      assert_int_equal((long)list_remove(*state, position), model[position]);
+      model_remove(position);
+    }
+    else if (op == 2) {
+      if (model_len == NCURSOR_MAX) {
+	assert_int_equal((long)list_pop(*state), model[0]);
+	model_remove(0);
+      }
+      assert_int_equal(list_push(*state, (void *)value), UTILS_OK);
+      model_insert(0, value++);
+    }
+    else if (model_len > 0) {
+      assert_int_equal((long)list_get(*state, position), model[position]);
+    }
+  }
+  assert_int_equal(list_length(*state), model_len);
+  for (i = 0; i < model_len; i++)
+    assert_int_equal((long)list_get(*state, i), model[i]);
+}
+
+int
+main(int argc, char *argv[])
+{
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test_setup_teardown(test_list_cursor_sequential,
+				    setup_list_empty,
+				    teardown_list),
+    cmocka_unit_test_setup_teardown(test_list_cursor_random,
+				    setup_list_empty,
+				    teardown_list),
+  };
+  return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,158 @@
+
+#include "list_test.h"
+
+#include <stdlib.h>
+
+/* number of items in the large lists */
+#define NHASH 2000
+
+static long values[NHASH];
+
+static int
+setup_list_hashed(void **state)
+{
+  list_t lst;
+  int err;
+
+  ctor_count = 0;
+  dtor_count = 0;
+
+  err = list_init_mode(&lst, ctor, dtor, LIST_MODE_HASHED);
+  if (err)
+    return err;
+  *state = lst;
+  return 0;
+}
+
+static void
+test_list_hashed_indexof(void **state)
+{
+  char *data[] = {"0", "1", "2", "3"};
+  list_item_t item;
+  int err, i;
+
+  for (i = 0; i < 4; i++) {
+    err = list_append(*state, data[i]);
+    assert_int_equal(err, UTILS_OK);
+  }
+  for (i = 0; i < 4; i++) {
+    assert_int_equal(list_indexof(*state, data[i]), i);
+    item = list_find_item(*state, data[i]);
+    assert_non_null(item);
+    assert_ptr_equal(list_item_getdata(item), data[i]);
+  }
+  assert_int_equal(list_indexof(*state, "x"), -1);
+  assert_null(list_find_item(*state, "x"));
+
+  /* remove by data */
+  item = list_find_item(*state, data[1]);
+  assert_ptr_equal(list_item_remove(*state, item), data[1]);
+  assert_int_equal(list_indexof(*state, data[1]), -1);
+  assert_int_equal(list_indexof(*state, data[2]), 1);
+  assert_ptr_equal(list_pop(*state), data[0]);
+  assert_int_equal(list_indexof(*state, data[3]), 1);
+}
+
+static void
+test_list_hashed_duplicates(void **state)
+{
+  char *a = "a", *b = "b";
+  list_item_t item;
+
+  list_append(*state, b);
+  list_append(*state, a);
+  list_append(*state, b);
+  list_append(*state, a);
+  assert_int_equal(list_indexof(*state, a), 1);
+  assert_int_equal(list_indexof(*state, b), 0);
+
+  /* the first occurrence changes as items are removed */
+  list_delete(*state, 0);
+  assert_int_equal(list_indexof(*state, b), 1);
+  item = list_find_item(*state, a);
+  assert_ptr_equal(item, list_item_get(*state, 0));
+  list_item_remove(*state, item);
+  assert_int_equal(list_indexof(*state, a), 1);
+  assert_int_equal(list_indexof(*state, b), 0);
+  list_delete(*state, 1);
+  assert_int_equal(list_indexof(*state, a), -1);
+  assert_int_equal(list_indexof(*state, b), 0);
+}
+
+static void
+test_list_hashed_modes(void **state)
+{
+  int modes[] = {LIST_MODE_HASHED, LIST_MODE_HASHED | LIST_MODE_INDEXED,
+		 LIST_MODE_HASHED | LIST_MODE_CONCURRENT};
+  list_t lst;
+  size_t bytes;
+  long i;
+  int m, err, pos;
+
+  for (i = 0; i < NHASH; i++)
+    values[i] = i;
+  for (m = 0; m < 3; m++) {
+    err = list_init_mode(&lst, NULL, NULL, modes[m]);
+    assert_int_equal(err, UTILS_OK);
+    for (i = 0; i < NHASH; i++)
+      list_append(lst, &values[i]);
+    err = list_index_memory(lst, &bytes);
+    assert_int_equal(err, UTILS_OK);
+    assert_true(bytes >= NHASH * sizeof(void *));
+
+    /* remove random items and compare with the positional lookup */
+    srand(m);
+    for (i = 0; i < NHASH / 2; i++)
+      list_delete(lst, rand() % list_length(lst));
+    for (i = 0; i < NHASH; i++) {
+      pos = list_indexof(lst, &values[i]);
+      if (pos >= 0)
+	assert_ptr_equal(list_get(lst, pos), &values[i]);
+    }
+    for (i = 0; i < list_length(lst); i++)
+      assert_int_equal(list_indexof(lst, list_get(lst, i)), i);
+    list_destroy(lst);
+  }
+}
+
+static void
+test_list_hashed_inv(void **state)
+{
+  size_t bytes;
+  list_t lst;
+  int err;
+
+  err = list_init_mode(&lst, NULL, NULL,
+		       LIST_MODE_HASHED | LIST_MODE_UNROLLED);
+  assert_int_equal(err, UTILS_ERROR);
+  err = list_index_memory(NULL, &bytes);
+  assert_int_equal(err, UTILS_ERROR);
+  err = list_index_memory(*state, NULL);
+  assert_int_equal(err, UTILS_ERROR);
+  err = list_index_memory(*state, &bytes);
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal(bytes, 0);
+  assert_null(list_find_item(NULL, "0"));
+  /* lists without the hash index scan */
+  assert_ptr_equal(list_find_item(*state, list_get(*state, 2)),
+		   list_item_get(*state, 2));
+  assert_null(list_find_item(*state, "x"));
+}
+
+int
+main(int argc, char *argv[])
+{
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test_setup_teardown(test_list_hashed_indexof,
+				    setup_list_hashed,
+				    teardown_list),
+    cmocka_unit_test_setup_teardown(test_list_hashed_duplicates,
+				    setup_list_hashed,
+				    teardown_list),
+    cmocka_unit_test(test_list_hashed_modes),
+    cmocka_unit_test_setup_teardown(test_list_hashed_inv,
+				    setup_list_3,
+				    teardown_list),
+  };
+  return cmocka_run_group_tests(tests, NULL, NULL);
+}
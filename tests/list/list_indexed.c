@@ -0,0 +1,143 @@
+
+#include "list_test.h"
+
+#include <stdlib.h>
+
+/* number of items used in the randomized test */
+#define NITEMS 512
+
+static int
+setup_list_indexed(void **state)
+{
+  list_t lst;
+  int err;
+
+  ctor_count = 0;
+  dtor_count = 0;
+
+  err = list_init_mode(&lst, ctor, dtor, LIST_MODE_INDEXED);
+  if (err)
+    return err;
+  *state = lst;
+  return 0;
+}
+
+static void
+test_list_indexed_insert_get(void **state)
+{
+  int err;
+
+  err = list_insert(*state, "1", 0);
+  assert_int_equal(err, UTILS_OK);
+  err = list_insert(*state, "0", 0);
+  assert_int_equal(err, UTILS_OK);
+  err = list_append(*state, "3");
+  assert_int_equal(err, UTILS_OK);
+  err = list_insert(*state, "2", 2);
+  assert_int_equal(err, UTILS_OK);
+  /* list[4] is created automatically */
+  err = list_insert(*state, "5", 5);
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal(list_length(*state), 6);
+  assert_int_equal(ctor_count, 6);
+
+  assert_string_equal(list_get(*state, 0), "0");
+  assert_string_equal(list_get(*state, 1), "1");
+  assert_string_equal(list_get(*state, 2), "2");
+  assert_string_equal(list_get(*state, 3), "3");
+  assert_null(list_get(*state, 4));
+  assert_string_equal(list_get(*state, 5), "5");
+  assert_null(list_get(*state, 6));
+  assert_null(list_get(*state, -1));
+}
+
+static void
+test_list_indexed_remove(void **state)
+{
+  list_item_t item;
+  int err;
+
+  err = list_append(*state, "0");
+  assert_int_equal(err, UTILS_OK);
+  err = list_append(*state, "1");
+  assert_int_equal(err, UTILS_OK);
+  err = list_append(*state, "2");
+  assert_int_equal(err, UTILS_OK);
+  err = list_append(*state, "3");
+  assert_int_equal(err, UTILS_OK);
+
+  assert_string_equal(list_remove(*state, 2), "2");
+  assert_string_equal(list_get(*state, 2), "3");
+  item = list_item_get(*state, 0);
+  assert_string_equal(list_item_remove(*state, item), "0");
+  assert_string_equal(list_get(*state, 0), "1");
+  err = list_delete(*state, 1);
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal(dtor_count, 1);
+  assert_int_equal(list_length(*state), 1);
+  assert_string_equal(list_pop(*state), "1");
+  assert_int_equal(list_length(*state), 0);
+  assert_null(list_get(*state, 0));
+}
+
+static void
+test_list_indexed_random(void **state)
+{
+  /* compare the list against an array after random operations */
+  long ref[NITEMS];
+  long value, data;
+  int len = 0;
+  int i, pos, err;
+
+  srand(1);
+  for (value = 1; value < 4 * NITEMS; value++) {
+    if (len == 0 || (len < NITEMS && rand() % 3 != 0)) {
+      pos = rand() % (len + 1);
+      err = list_insert(*state, (void *)value, pos);
+      assert_int_equal(err, UTILS_OK);
+      memmove(&ref[pos + 1], &ref[pos], (len - pos) * sizeof(long));
+      ref[pos] = value;
+      len++;
+    }
+    else {
+      pos = rand() % len;
+      data = (long)list_remove(*state, pos);
+      assert_int_equal(data, ref[pos]);
+      memmove(&ref[pos], &ref[pos + 1], (len - pos - 1) * sizeof(long));
+      len--;
+    }
+  }
+  assert_int_equal(list_length(*state), len);
+  for (i = 0; i < len; i++)
+    assert_int_equal((long)list_get(*state, i), ref[i]);
+}
+
+static void
+test_list_indexed_inv_mode(void **state)
+{
+  list_t lst;
+  int err;
+
+  err = list_init_mode(&lst, NULL, NULL, ~LIST_MODE_INDEXED);
+  assert_int_equal(err, UTILS_ERROR);
+  err = list_init_mode(NULL, NULL, NULL, LIST_MODE_INDEXED);
+  assert_int_equal(err, UTILS_ERROR);
+}
+
+int
+main(int argc, char *argv[])
+{
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test_setup_teardown(test_list_indexed_insert_get,
+				    setup_list_indexed,
+				    teardown_list),
+    cmocka_unit_test_setup_teardown(test_list_indexed_remove,
+				    setup_list_indexed,
+				    teardown_list),
+    cmocka_unit_test_setup_teardown(test_list_indexed_random,
+				    setup_list_indexed,
+				    teardown_list),
+    cmocka_unit_test(test_list_indexed_inv_mode),
+  };
+  return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,225 @@
+
+#include "list_test.h"
+
+/* number of items in the filtered lists */
+#define NITER 100
+
+static int
+setup_list_mode(void **state, int mode)
+{
+  list_t lst;
+  long i;
+  int err;
+
+  ctor_count = 0;
+  dtor_count = 0;
+
+  err = list_init_mode(&lst, ctor, dtor, mode);
+  if (err)
+    return err;
+  for (i = 0; i < NITER; i++) {
+    err = list_append(lst, (void *)i);
+    if (err)
+      return err;
+  }
+  *state = lst;
+  return 0;
+}
+
+static int
+setup_list_plain(void **state)
+{
+  return setup_list_mode(state, 0);
+}
+
+static int
+setup_list_unrolled(void **state)
+{
+  return setup_list_mode(state, LIST_MODE_UNROLLED);
+}
+
+static int
+setup_list_indexed(void **state)
+{
+  return setup_list_mode(state, LIST_MODE_INDEXED);
+}
+
+static int
+setup_list_hashed(void **state)
+{
+  return setup_list_mode(state, LIST_MODE_HASHED);
+}
+
+static void
+test_list_iter_filter(void **state)
+{
+  /* drop the odd values in a single pass */
+  list_iter_struct_t iter;
+  long expect;
+  int rc;
+
+  for (list_iter_init(*state, &iter); !list_iter_end(&iter);
+       list_iter_next(&iter)) {
+    if ((long)list_iter_data(&iter) % 2) {
+      rc = list_iter_delete(&iter);
+      assert_int_equal(rc, UTILS_OK);
+      assert_null(list_iter_data(&iter));
+      assert_null(list_iter_remove(&iter));
+    }
+  }
+  assert_int_equal(dtor_count, NITER / 2);
+  assert_int_equal(list_length(*state), NITER / 2);
+
+  expect = 0;
+  for (list_iter_init(*state, &iter); !list_iter_end(&iter);
+       list_iter_next(&iter)) {
+    assert_int_equal((long)list_iter_data(&iter), expect);
+    assert_int_equal((long)list_get(*state, expect / 2), expect);
+    expect += 2;
+  }
+  assert_int_equal(expect, NITER);
+}
+
+static void
+test_list_iter_filter_all(void **state)
+{
+  list_iter_struct_t iter;
+  long expect = 0;
+
+  for (list_iter_init(*state, &iter); !list_iter_end(&iter);
+       list_iter_next(&iter))
+    assert_int_equal((long)list_iter_remove(&iter), expect++);
+  assert_int_equal(expect, NITER);
+  assert_int_equal(list_length(*state), 0);
+  assert_true(list_iter_end(&iter));
+}
+
+static void
+test_list_iter_reverse(void **state)
+{
+  /* drop the odd values walking backwards */
+  list_iter_struct_t iter;
+  long expect;
+  int rc;
+
+  expect = NITER - 1;
+  for (list_iter_init_tail(*state, &iter); !list_iter_end(&iter);
+       list_iter_prev(&iter)) {
+    assert_int_equal((long)list_iter_data(&iter), expect);
+    if (expect % 2) {
+      rc = list_iter_delete(&iter);
+      assert_int_equal(rc, UTILS_OK);
+    }
+    expect--;
+  }
+  assert_int_equal(expect, -1);
+  assert_null(list_iter_data(&iter));
+  assert_int_equal(list_length(*state), NITER / 2);
+
+  expect = NITER - 2;
+  for (list_iter_init_tail(*state, &iter); !list_iter_end(&iter);
+       list_iter_prev(&iter)) {
+    assert_int_equal((long)list_iter_data(&iter), expect);
+    expect -= 2;
+  }
+  assert_int_equal(expect, -2);
+}
+
+static void
+test_list_iter_remove_step(void **state)
+{
+  /* after a removal the iterator steps to both neighbours */
+  list_iter_struct_t iter;
+  int rc;
+
+  rc = list_iter_init(*state, &iter);
+  assert_int_equal(rc, UTILS_OK);
+  rc = list_iter_seek(&iter, 50);
+  assert_int_equal(rc, UTILS_OK);
+  assert_int_equal((long)list_iter_remove(&iter), 50);
+  assert_int_equal(list_iter_prev(&iter), UTILS_OK);
+  assert_int_equal((long)list_iter_data(&iter), 49);
+  assert_int_equal(list_iter_next(&iter), UTILS_OK);
+  assert_int_equal((long)list_iter_data(&iter), 51);
+
+  /* head removal, the previous element is past the list head */
+  rc = list_iter_seek(&iter, 0);
+  assert_int_equal(rc, UTILS_OK);
+  assert_int_equal((long)list_iter_remove(&iter), 0);
+  assert_int_equal(list_iter_prev(&iter), UTILS_OK);
+  assert_true(list_iter_end(&iter));
+
+  /* tail removal, the previous element is the new tail */
+  rc = list_iter_seek(&iter, list_length(*state) - 1);
+  assert_int_equal(rc, UTILS_OK);
+  assert_int_equal((long)list_iter_remove(&iter), NITER - 1);
+  assert_int_equal(list_iter_prev(&iter), UTILS_OK);
+  assert_false(list_iter_end(&iter));
+  assert_int_equal((long)list_iter_data(&iter), NITER - 2);
+
+  rc = list_iter_init_tail(*state, &iter);
+  assert_int_equal(rc, UTILS_OK);
+  assert_int_equal((long)list_iter_remove(&iter), NITER - 2);
+  assert_int_equal(list_iter_next(&iter), UTILS_OK);
+  assert_true(list_iter_end(&iter));
+  assert_int_equal(list_length(*state), NITER - 4);
+}
+
+static void
+test_list_iter_seek_tail(void **state)
+{
+  list_iter_struct_t iter;
+  int rc, i;
+
+  rc = list_iter_init(*state, &iter);
+  assert_int_equal(rc, UTILS_OK);
+  for (i = NITER - 1; i >= 0; i -= 3) {
+    rc = list_iter_seek(&iter, i);
+    assert_int_equal(rc, UTILS_OK);
+    assert_int_equal((long)list_iter_data(&iter), i);
+  }
+  rc = list_iter_seek(&iter, -1);
+  assert_int_equal(rc, UTILS_ERROR);
+  assert_true(list_iter_end(&iter));
+}
+
+static void
+test_list_iter_reverse_empty(void **state)
+{
+  list_iter_struct_t iter;
+  int rc;
+
+  rc = list_iter_init_tail(*state, &iter);
+  assert_int_equal(rc, UTILS_OK);
+  assert_true(list_iter_end(&iter));
+  assert_null(list_iter_remove(&iter));
+  assert_int_equal(list_iter_delete(&iter), UTILS_ERROR);
+  assert_int_equal(list_iter_prev(&iter), UTILS_ERROR);
+}
+
+#define ITER_MODE_TESTS(setup)						\
+  cmocka_unit_test_setup_teardown(test_list_iter_filter, setup,		\
+				  teardown_list),			\
+    cmocka_unit_test_setup_teardown(test_list_iter_filter_all, setup,	\
+				    teardown_list),			\
+    cmocka_unit_test_setup_teardown(test_list_iter_reverse, setup,	\
+				    teardown_list),			\
+    cmocka_unit_test_setup_teardown(test_list_iter_remove_step, setup,	\
+				    teardown_list),			\
+    cmocka_unit_test_setup_teardown(test_list_iter_seek_tail, setup,	\
+				    teardown_list)
+
+int
+main(int argc, char *argv[])
+{
+  const struct CMUnitTest tests[] = {
+    ITER_MODE_TESTS(setup_list_plain),
+    ITER_MODE_TESTS(setup_list_unrolled),
+    ITER_MODE_TESTS(setup_list_indexed),
+    ITER_MODE_TESTS(setup_list_hashed),
+    cmocka_unit_test_setup_teardown(test_list_iter_reverse_empty,
+				    setup_list_empty,
+				    teardown_list),
+  };
+  return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,253 @@
+#include "list_test.h"
+
+/* number of items in the processed lists */
+#define NPIPE 100
+
+static int
+setup_list_mode(void **state, int mode)
+{
+  list_t lst;
+  long i;
+  int err;
+
+  ctor_count = 0;
+  dtor_count = 0;
+
+  err = list_init_mode(&lst, ctor, dtor, mode);
+  if (err)
+    return err;
+  for (i = 0; i < NPIPE; i++) {
+    err = list_append(lst, (void *)i);
+    if (err)
+      return err;
+  }
+  *state = lst;
+  return 0;
+}
+
+static int
+setup_list_plain(void **state)
+{
+  return setup_list_mode(state, 0);
+}
+
+static int
+setup_list_unrolled(void **state)
+{
+  return setup_list_mode(state, LIST_MODE_UNROLLED);
+}
+
+static int
+setup_list_indexed(void **state)
+{
+  return setup_list_mode(state, LIST_MODE_INDEXED);
+}
+
+static int
+setup_list_hashed(void **state)
+{
+  return setup_list_mode(state, LIST_MODE_HASHED);
+}
+
+static bool
+is_even(void *itm_data, void *args)
+{
+  return (long)itm_data % 2 == 0;
+}
+
+static bool
+is_below(void *itm_data, void *args)
+{
+  return (long)itm_data < (long)args;
+}
+
+static void *
+square(void *itm_data, void *args)
+{
+  return (void *)((long)itm_data * (long)itm_data);
+}
+
+static int
+sum(void *itm_data, void *acc)
+{
+  *(long *)acc += (long)itm_data;
+  return UTILS_OK;
+}
+
+static int
+count_to_10(void *itm_data, void *acc)
+{
+  if (++*(long *)acc == 10)
+    return UTILS_ITER_STOP;
+  return UTILS_OK;
+}
+
+static void
+test_list_filter(void **state)
+{
+  list_iter_struct_t iter;
+  long expect;
+  int err;
+
+  err = list_filter(*state, is_even, NULL);
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal(dtor_count, NPIPE / 2);
+  assert_int_equal(list_length(*state), NPIPE / 2);
+
+  expect = 0;
+  for (list_iter_init(*state, &iter); !list_iter_end(&iter);
+       list_iter_next(&iter)) {
+    assert_int_equal((long)list_iter_data(&iter), expect);
+    assert_int_equal((long)list_get(*state, expect / 2), expect);
+    expect += 2;
+  }
+  assert_int_equal(expect, NPIPE);
+
+  /* the list stays usable after the compaction */
+  err = list_insert(*state, (void *)1L, 1);
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal((long)list_get(*state, 2), 2);
+  assert_int_equal(list_indexof(*state, (void *)1L), 1);
+
+  /* drop the upper half and then everything */
+  err = list_filter(*state, is_below, (void *)50L);
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal(list_length(*state), 26);
+  assert_int_equal((long)list_get(*state, 25), 48);
+  err = list_filter(*state, is_below, (void *)0L);
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal(list_length(*state), 0);
+  assert_int_equal(dtor_count, ctor_count);
+  err = list_append(*state, (void *)7L);
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal((long)list_get(*state, 0), 7);
+}
+
+static void
+test_list_map_reduce(void **state)
+{
+  list_t out;
+  long total = 0;
+  int err;
+
+  err = list_init_mode(&out, NULL, NULL, 0);
+  assert_int_equal(err, UTILS_OK);
+  err = list_map(*state, out, square, NULL);
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal(list_length(out), NPIPE);
+  assert_int_equal((long)list_get(out, 7), 49);
+  /* the source is not modified */
+  assert_int_equal(list_length(*state), NPIPE);
+  assert_int_equal(dtor_count, 0);
+
+  err = list_reduce(out, sum, &total);
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal(total, (NPIPE - 1) * NPIPE * (2 * NPIPE - 1) / 6);
+
+  total = 0;
+  err = list_reduce(*state, count_to_10, &total);
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal(total, 10);
+
+  assert_int_equal(list_map(*state, *state, square, NULL), UTILS_ERROR);
+  assert_int_equal(list_map(*state, NULL, square, NULL), UTILS_ERROR);
+  assert_int_equal(list_reduce(*state, NULL, &total), UTILS_ERROR);
+  list_destroy(out);
+}
+
+static void
+test_list_pipeline(void **state)
+{
+  list_t out;
+  long total = 0, count = 0;
+  int err;
+  list_stage_t stages[] = {
+    LIST_FILTER(is_even, NULL),
+    LIST_MAP(square, NULL),
+    LIST_REDUCE(sum, &total),
+    LIST_FILTER(is_below, (void *)1000L),
+  };
+  list_stage_t stop[] = {
+    LIST_REDUCE(count_to_10, &count),
+  };
+  list_stage_t invalid[] = {
+    LIST_MAP(NULL, NULL),
+  };
+
+  err = list_init(&out, ctor, dtor);
+  assert_int_equal(err, UTILS_OK);
+  err = list_pipeline(*state, stages, 4, out);
+  assert_int_equal(err, UTILS_OK);
+  /* squares of 0, 2, ... 98 summed, the ones below 1000 kept */
+  assert_int_equal(total, 4 * 49 * 50 * 99 / 6);
+  assert_int_equal(list_length(out), 16);
+  assert_int_equal((long)list_get(out, 15), 900);
+  assert_int_equal(ctor_count, NPIPE + 16);
+
+  err = list_pipeline(*state, stop, 1, NULL);
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal(count, 10);
+
+  /* without stages the items are copied */
+  err = list_pipeline(*state, NULL, 0, out);
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal(list_length(out), 16 + NPIPE);
+
+  assert_int_equal(list_pipeline(*state, invalid, 1, NULL), UTILS_ERROR);
+  assert_int_equal(list_pipeline(*state, stages, 4, *state), UTILS_ERROR);
+  assert_int_equal(list_pipeline(NULL, stages, 4, NULL), UTILS_ERROR);
+  list_destroy(out);
+}
+
+static void
+test_list_filter_sparse(void **state)
+{
+  list_t lst;
+  long total = 0;
+  int err;
+  list_stage_t stages[] = {
+    LIST_FILTER(is_even, NULL),
+    LIST_REDUCE(sum, &total),
+  };
+
+  err = list_init_mode(&lst, NULL, NULL, LIST_MODE_SPARSE);
+  assert_int_equal(err, UTILS_OK);
+  err = list_insert(lst, (void *)3L, 10);
+  assert_int_equal(err, UTILS_OK);
+  err = list_insert(lst, (void *)4L, 20);
+  assert_int_equal(err, UTILS_OK);
+
+  /* empty elements are walked as NULL, which is even */
+  err = list_pipeline(lst, stages, 2, NULL);
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal(total, 4);
+  assert_int_equal(list_length(lst), 21);
+
+  err = list_filter(lst, is_below, (void *)4L);
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal(list_length(lst), 20);
+  assert_int_equal((long)list_get(lst, 10), 3);
+  assert_null(list_get(lst, 19));
+  list_destroy(lst);
+}
+
+#define PIPE_MODE_TESTS(setup)						\
+  cmocka_unit_test_setup_teardown(test_list_filter, setup,		\
+				  teardown_list),			\
+    cmocka_unit_test_setup_teardown(test_list_map_reduce, setup,	\
+				    teardown_list),			\
+    cmocka_unit_test_setup_teardown(test_list_pipeline, setup,		\
+				    teardown_list)
+
+int
+main(int argc, char *argv[])
+{
+  const struct CMUnitTest tests[] = {
+    PIPE_MODE_TESTS(setup_list_plain),
+    PIPE_MODE_TESTS(setup_list_unrolled),
+    PIPE_MODE_TESTS(setup_list_indexed),
+    PIPE_MODE_TESTS(setup_list_hashed),
+    cmocka_unit_test(test_list_filter_sparse),
+  };
+  return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,145 @@
+
+#include "list_test.h"
+
+static int
+setup_list_pool(void **state)
+{
+  list_t lst;
+  int err;
+
+  ctor_count = 0;
+  dtor_count = 0;
+
+  err = list_init_pool(&lst, ctor, dtor, NULL);
+  if (err)
+    return err;
+  *state = lst;
+  return 0;
+}
+
+static void
+test_list_pool_push_pop(void **state)
+{
+  int err;
+  char *item;
+
+  err = list_push(*state, "1");
+  assert_int_equal(err, UTILS_OK);
+  err = list_push(*state, "0");
+  assert_int_equal(err, UTILS_OK);
+  err = list_append(*state, "2");
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal(list_length(*state), 3);
+  assert_int_equal(ctor_count, 3);
+
+  item = list_pop(*state);
+  assert_string_equal(item, "0");
+  item = list_pop(*state);
+  assert_string_equal(item, "1");
+  item = list_pop(*state);
+  assert_string_equal(item, "2");
+  assert_int_equal(list_length(*state), 0);
+  assert_int_equal(dtor_count, 0);
+}
+
+static void
+test_list_pool_recycle(void **state)
+{
+  list_item_t first, second;
+  int err;
+
+  /* a removed node is handed out again by the pool */
+  err = list_push(*state, "0");
+  assert_int_equal(err, UTILS_OK);
+  first = list_item_get(*state, 0);
+  list_pop(*state);
+  err = list_push(*state, "1");
+  assert_int_equal(err, UTILS_OK);
+  second = list_item_get(*state, 0);
+  assert_ptr_equal(first, second);
+  assert_string_equal(list_get(*state, 0), "1");
+}
+
+static void
+test_list_pool_many(void **state)
+{
+  int err, i;
+
+  /* grow the pool over multiple slabs */
+  for (i = 0; i < 1000; i++) {
+    err = list_append(*state, "x");
+    assert_int_equal(err, UTILS_OK);
+  }
+  assert_int_equal(list_length(*state), 1000);
+  for (i = 0; i < 500; i++)
+    assert_string_equal(list_pop(*state), "x");
+  assert_int_equal(list_length(*state), 500);
+
+  /* the destructor runs for the remaining items */
+  err = list_destroy(*state);
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal(dtor_count, 500);
+}
+
+static void
+test_list_pool_shared(void **state)
+{
+  list_pool_t pool;
+  list_t l0, l1;
+  int err;
+
+  err = list_pool_init(&pool, 4);
+  assert_int_equal(err, UTILS_OK);
+  err = list_init_pool(&l0, NULL, NULL, pool);
+  assert_int_equal(err, UTILS_OK);
+  err = list_init_pool(&l1, NULL, NULL, pool);
+  assert_int_equal(err, UTILS_OK);
+
+  err = list_push(l0, "0");
+  assert_int_equal(err, UTILS_OK);
+  err = list_push(l1, "1");
+  assert_int_equal(err, UTILS_OK);
+
+  /* the pool is in use */
+  err = list_pool_destroy(pool);
+  assert_int_equal(err, UTILS_ERROR);
+
+  err = list_destroy(l0);
+  assert_int_equal(err, UTILS_OK);
+  assert_string_equal(list_get(l1, 0), "1");
+  err = list_destroy(l1);
+  assert_int_equal(err, UTILS_OK);
+
+  err = list_pool_destroy(pool);
+  assert_int_equal(err, UTILS_OK);
+}
+
+static void
+test_list_pool_inv_hnd(void **state)
+{
+  int err;
+
+  err = list_init_pool(NULL, NULL, NULL, NULL);
+  assert_int_equal(err, UTILS_ERROR);
+  err = list_pool_init(NULL, 0);
+  assert_int_equal(err, UTILS_ERROR);
+  err = list_pool_destroy(NULL);
+  assert_int_equal(err, UTILS_ERROR);
+}
+
+int
+main(int argc, char *argv[])
+{
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test_setup_teardown(test_list_pool_push_pop,
+				    setup_list_pool,
+				    teardown_list),
+    cmocka_unit_test_setup_teardown(test_list_pool_recycle,
+				    setup_list_pool,
+				    teardown_list),
+    cmocka_unit_test_setup(test_list_pool_many, setup_list_pool),
+    cmocka_unit_test(test_list_pool_shared),
+    cmocka_unit_test(test_list_pool_inv_hnd),
+  };
+  return cmocka_run_group_tests(tests, NULL, NULL);
+}
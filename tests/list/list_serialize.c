@@ -0,0 +1,290 @@
+#include "list_test.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+/* number of serialized records */
+#define NREC 3000
+
+/* fixed-size record of the serialized lists */
+struct point {
+  long id;
+  double x;
+  double y;
+};
+
+static char path[] = "/tmp/list_serialize_XXXXXX";
+
+static int
+encode_point(void *itm_data, void *record, void *args)
+{
+  memcpy(record, itm_data, sizeof(struct point));
+  return UTILS_OK;
+}
+
+static int
+decode_point(const void *record, void **data, void *args)
+{
+  *data = malloc(sizeof(struct point));
+  if (*data == NULL)
+    return UTILS_ERROR;
+  memcpy(*data, record, sizeof(struct point));
+  return UTILS_OK;
+}
+
+static int
+free_point(void *data)
+{
+  dtor_count++;
+  free(data);
+  return UTILS_OK;
+}
+
+static int
+sum_id(void *itm_data, void *args)
+{
+  *(long *)args += ((struct point *)itm_data)->id;
+  return UTILS_OK;
+}
+
+static bool
+is_odd(void *itm_data, void *args)
+{
+  return ((struct point *)itm_data)->id % 2;
+}
+
+static int
+setup_file(void **state)
+{
+  struct point *p;
+  list_t lst;
+  FILE *stream;
+  long i;
+  int fd, err;
+
+  fd = mkstemp(path);
+  if (fd < 0)
+    return UTILS_ERROR;
+  stream = fdopen(fd, "wb");
+  if (stream == NULL)
+    return UTILS_ERROR;
+
+  err = list_init(&lst, NULL, free_point);
+  if (err)
+    return err;
+  for (i = 0; i < NREC; i++) {
+    p = malloc(sizeof(struct point));
+    p->id = i;
+    p->x = i / 2.0;
+    p->y = -i;
+    err = list_append(lst, p);
+    if (err)
+      return err;
+  }
+  err = list_serialize(lst, stream, sizeof(struct point), encode_point, NULL);
+  fclose(stream);
+  list_destroy(lst);
+  ctor_count = 0;
+  dtor_count = 0;
+  *state = path;
+  return err;
+}
+
+static int
+teardown_file(void **state)
+{
+  unlink(path);
+  strcpy(path, "/tmp/list_serialize_XXXXXX");
+  return 0;
+}
+
+static void
+test_list_deserialize(void **state)
+{
+  struct point *p;
+  list_t lst;
+  FILE *stream;
+  long i;
+  int err;
+
+  err = list_init(&lst, ctor, free_point);
+  assert_int_equal(err, UTILS_OK);
+  stream = fopen(*state, "rb");
+  assert_non_null(stream);
+  err = list_deserialize(lst, stream, decode_point, NULL);
+  fclose(stream);
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal(list_length(lst), NREC);
+  assert_int_equal(ctor_count, NREC);
+
+  for (i = 0; i < NREC; i += 7) {
+    p = list_get(lst, i);
+    assert_int_equal(p->id, i);
+    assert_true(p->x == i / 2.0);
+    assert_true(p->y == -i);
+  }
+  list_destroy(lst);
+  assert_int_equal(dtor_count, NREC);
+}
+
+static void
+test_list_mapped(void **state)
+{
+  list_iter_struct_t iter;
+  struct point *p;
+  list_t lst, out;
+  long i, total = 0;
+  int err;
+  list_stage_t stages[] = {
+    LIST_FILTER(is_odd, NULL),
+  };
+
+  err = list_init_mapped(&lst, *state);
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal(list_length(lst), NREC);
+  p = list_get(lst, 10);
+  assert_int_equal(p->id, 10);
+  assert_true(p->x == 5.0);
+  assert_int_equal(list_indexof(lst, p), 10);
+  assert_int_equal(list_indexof(lst, (char *)p + 1), -1);
+  assert_int_equal(list_indexof(lst, &total), -1);
+  assert_null(list_get(lst, NREC));
+
+  /* iteration in both directions and from a position */
+  i = 0;
+  for (list_iter_init(lst, &iter); !list_iter_end(&iter);
+       list_iter_next(&iter))
+    assert_int_equal(((struct point *)list_iter_data(&iter))->id, i++);
+  assert_int_equal(i, NREC);
+  for (list_iter_init_tail(lst, &iter); !list_iter_end(&iter);
+       list_iter_prev(&iter))
+    assert_int_equal(((struct point *)list_iter_data(&iter))->id, --i);
+  assert_int_equal(i, 0);
+  err = list_iter_seek(&iter, 100);
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal(((struct point *)list_iter_data(&iter))->id, 100);
+
+  err = list_walk(lst, sum_id, &total);
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal(total, (long)NREC * (NREC - 1) / 2);
+
+  err = list_init(&out, NULL, NULL);
+  assert_int_equal(err, UTILS_OK);
+  err = list_pipeline(lst, stages, 1, out);
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal(list_length(out), NREC / 2);
+  assert_ptr_equal(list_get(out, 0), list_get(lst, 1));
+  list_destroy(out);
+  list_destroy(lst);
+}
+
+static void
+test_list_mapped_readonly(void **state)
+{
+  list_iter_struct_t iter;
+  list_t lst, copy;
+  FILE *stream;
+  int err;
+
+  err = list_init_mapped(&lst, *state);
+  assert_int_equal(err, UTILS_OK);
+
+  assert_int_equal(list_append(lst, NULL), UTILS_ERROR);
+  assert_int_equal(list_insert(lst, NULL, 0), UTILS_ERROR);
+  assert_null(list_remove(lst, 0));
+  assert_int_equal(list_delete(lst, 0), UTILS_ERROR);
+  assert_int_equal(list_filter(lst, is_odd, NULL), UTILS_ERROR);
+  assert_null(list_item_get(lst, 0));
+  assert_int_equal(list_item_delete(lst, NULL), UTILS_ERROR);
+  list_iter_init(lst, &iter);
+  assert_null(list_iter_remove(&iter));
+  assert_int_equal(list_iter_delete(&iter), UTILS_ERROR);
+  assert_int_equal(list_length(lst), NREC);
+
+  /* a mapped list can be written again */
+  stream = tmpfile();
+  assert_non_null(stream);
+  err = list_serialize(lst, stream, sizeof(struct point), encode_point, NULL);
+  assert_int_equal(err, UTILS_OK);
+  rewind(stream);
+  err = list_init(&copy, NULL, free_point);
+  assert_int_equal(err, UTILS_OK);
+  err = list_deserialize(copy, stream, decode_point, NULL);
+  assert_int_equal(err, UTILS_OK);
+  fclose(stream);
+  assert_int_equal(list_length(copy), NREC);
+  assert_int_equal(((struct point *)list_get(copy, NREC - 1))->id, NREC - 1);
+  list_destroy(copy);
+  list_destroy(lst);
+}
+
+static void
+test_list_serialize_invalid(void **state)
+{
+  list_t lst, mapped;
+  FILE *stream;
+  int err;
+
+  err = list_init(&lst, NULL, NULL);
+  assert_int_equal(err, UTILS_OK);
+
+  /* a stream without header */
+  stream = tmpfile();
+  assert_non_null(stream);
+  fputs("not a list file, not a list file", stream);
+  rewind(stream);
+  err = list_deserialize(lst, stream, decode_point, NULL);
+  assert_int_equal(err, UTILS_ERROR);
+  fclose(stream);
+
+  /* an empty list has no record */
+  stream = tmpfile();
+  assert_non_null(stream);
+  err = list_serialize(lst, stream, sizeof(struct point), encode_point, NULL);
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal(list_serialize(lst, stream, 0, encode_point, NULL),
+		   UTILS_ERROR);
+  assert_int_equal(list_serialize(lst, NULL, 8, encode_point, NULL),
+		   UTILS_ERROR);
+  assert_int_equal(list_deserialize(lst, stream, NULL, NULL), UTILS_ERROR);
+  fclose(stream);
+
+  assert_int_equal(list_init_mapped(&mapped, "/nonexistent/list"),
+		   UTILS_ERROR);
+  assert_int_equal(list_init_mapped(NULL, "/nonexistent/list"), UTILS_ERROR);
+  list_destroy(lst);
+}
+
+static void
+test_list_mapped_truncated(void **state)
+{
+  list_t lst;
+
+  /* the header counts more records than the file holds */
+  assert_int_equal(truncate(*state, 32 + 10 * sizeof(struct point) - 1), 0);
+  assert_int_equal(list_init_mapped(&lst, *state), UTILS_ERROR);
+  assert_int_equal(truncate(*state, 16), 0);
+  assert_int_equal(list_init_mapped(&lst, *state), UTILS_ERROR);
+}
+
+int
+main(int argc, char *argv[])
+{
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test_setup_teardown(test_list_deserialize,
+				    setup_file,
+				    teardown_file),
+    cmocka_unit_test_setup_teardown(test_list_mapped,
+				    setup_file,
+				    teardown_file),
+    cmocka_unit_test_setup_teardown(test_list_mapped_readonly,
+				    setup_file,
+				    teardown_file),
+    cmocka_unit_test(test_list_serialize_invalid),
+    cmocka_unit_test_setup_teardown(test_list_mapped_truncated,
+				    setup_file,
+				    teardown_file),
+  };
+  return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,251 @@
+#include "list_test.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+
+/* number of reader threads */
+#define NREADERS 4
+/* number of versions published while reading */
+#define NVERSIONS 200
+
+struct reader_args {
+  list_t lst;
+  atomic_bool *done;
+};
+
+static int
+setup_list_snapshot(void **state)
+{
+  list_t lst;
+  int err;
+
+  ctor_count = 0;
+  dtor_count = 0;
+  walk_count = 0;
+
+  err = list_init_mode(&lst, ctor, dtor, LIST_MODE_SNAPSHOT);
+  if (err)
+    return err;
+  *state = lst;
+  return 0;
+}
+
+static void
+test_list_publish(void **state)
+{
+  list_iter_struct_t iter;
+  list_t first, second;
+  long i;
+  int err;
+
+  /* the first version is empty */
+  first = list_snapshot(*state);
+  assert_non_null(first);
+  assert_int_equal(list_length(first), 0);
+  for (i = 0; i < 10; i++) {
+    err = list_append(*state, (void *)i);
+    assert_int_equal(err, UTILS_OK);
+  }
+  assert_int_equal(list_length(first), 0);
+
+  err = list_publish(*state);
+  assert_int_equal(err, UTILS_OK);
+  second = list_snapshot(*state);
+  assert_int_equal(list_length(second), 10);
+  assert_int_equal(ctor_count, 20);
+
+  /* later changes are not visible in the snapshot */
+  err = list_delete(*state, 0);
+  assert_int_equal(err, UTILS_OK);
+  err = list_append(*state, (void *)10L);
+  assert_int_equal(err, UTILS_OK);
+  i = 0;
+  for (list_iter_init(second, &iter); !list_iter_end(&iter);
+       list_iter_next(&iter))
+    assert_int_equal((long)list_iter_data(&iter), i++);
+  assert_int_equal(i, 10);
+  assert_int_equal((long)list_get(second, 9), 9);
+  assert_int_equal(list_indexof(second, (void *)3L), 3);
+
+  assert_int_equal(list_snapshot_release(first), UTILS_OK);
+  /* the current version is kept after its last snapshot is released */
+  assert_int_equal(list_snapshot_release(second), UTILS_OK);
+  assert_int_equal(dtor_count, 1);
+  second = list_snapshot(*state);
+  assert_int_equal(list_length(second), 10);
+  assert_int_equal((long)list_get(second, 0), 0);
+
+  /* a replaced version is freed by the release of its last snapshot */
+  err = list_publish(*state);
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal(dtor_count, 1);
+  assert_int_equal(list_snapshot_release(second), UTILS_OK);
+  assert_int_equal(dtor_count, 11);
+  assert_int_equal(ctor_count, 31);
+}
+
+static void
+test_list_snapshot_readonly(void **state)
+{
+  list_t snap, out;
+  int err;
+
+  err = list_append(*state, (void *)1L);
+  assert_int_equal(err, UTILS_OK);
+  err = list_publish(*state);
+  assert_int_equal(err, UTILS_OK);
+  snap = list_snapshot(*state);
+
+  assert_int_equal(list_append(snap, NULL), UTILS_ERROR);
+  assert_int_equal(list_insert(snap, NULL, 0), UTILS_ERROR);
+  assert_null(list_remove(snap, 0));
+  assert_int_equal(list_delete(snap, 0), UTILS_ERROR);
+  assert_int_equal(list_push(snap, NULL), UTILS_ERROR);
+  assert_null(list_item_remove(snap, list_item_get(snap, 0)));
+  assert_int_equal(list_item_delete(snap, list_item_get(snap, 0)),
+		   UTILS_ERROR);
+  assert_int_equal(dtor_count, 0);
+  assert_int_equal(list_destroy(snap), UTILS_ERROR);
+  assert_int_equal(list_length(snap), 1);
+
+  /* snapshots are read as any list */
+  err = list_init(&out, NULL, NULL);
+  assert_int_equal(err, UTILS_OK);
+  err = list_concat(out, snap);
+  assert_int_equal(err, UTILS_ERROR);
+  err = list_pipeline(snap, NULL, 0, out);
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal(list_length(out), 1);
+  err = list_walk(snap, list_walk_cbk, NULL);
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal(walk_count, 1);
+  list_destroy(out);
+
+  assert_int_equal(list_snapshot_release(*state), UTILS_ERROR);
+  assert_int_equal(list_snapshot_release(snap), UTILS_OK);
+}
+
+static void
+test_list_snapshot_outlives(void **state)
+{
+  list_t lst, snap;
+  long i;
+  int err;
+
+  ctor_count = 0;
+  dtor_count = 0;
+  err = list_init_mode(&lst, ctor, dtor,
+		       LIST_MODE_SNAPSHOT | LIST_MODE_UNROLLED);
+  assert_int_equal(err, UTILS_OK);
+  for (i = 0; i < 100; i++)
+    list_append(lst, (void *)i);
+  err = list_publish(lst);
+  assert_int_equal(err, UTILS_OK);
+  snap = list_snapshot(lst);
+  list_destroy(lst);
+
+  assert_int_equal(dtor_count, 100);
+  assert_int_equal((long)list_get(snap, 42), 42);
+  list_snapshot_release(snap);
+  assert_int_equal(ctor_count, dtor_count);
+
+  /* versions keep the lookup modes of the list */
+  err = list_init_mode(&lst, NULL, NULL,
+		       LIST_MODE_SNAPSHOT | LIST_MODE_INDEXED |
+		       LIST_MODE_HASHED);
+  assert_int_equal(err, UTILS_OK);
+  for (i = 0; i < 100; i++)
+    list_append(lst, (void *)i);
+  list_publish(lst);
+  snap = list_snapshot(lst);
+  assert_int_equal(list_indexof(snap, (void *)77L), 77);
+  assert_int_equal((long)list_get(snap, 23), 23);
+  list_snapshot_release(snap);
+  list_destroy(lst);
+
+  assert_int_equal(list_init_mode(&lst, NULL, NULL,
+				  LIST_MODE_SNAPSHOT | LIST_MODE_SPARSE),
+		   UTILS_ERROR);
+  err = list_init(&lst, NULL, NULL);
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal(list_publish(lst), UTILS_ERROR);
+  assert_null(list_snapshot(lst));
+  list_destroy(lst);
+}
+
+/**
+ * Check that every snapshot holds 0 to n - 1 for some n
+ * that never decreases
+ */
+static void *
+reader(void *data)
+{
+  struct reader_args *args = data;
+  list_iter_struct_t iter;
+  list_t snap;
+  long i, last = 0;
+
+  while (!atomic_load(args->done)) {
+    snap = list_snapshot(args->lst);
+    i = 0;
+    for (list_iter_init(snap, &iter); !list_iter_end(&iter);
+	 list_iter_next(&iter))
+      if ((long)list_iter_data(&iter) != i++)
+	return NULL;
+    if (i < last || list_length(snap) != i)
+      return NULL;
+    last = i;
+    list_snapshot_release(snap);
+  }
+  return args;
+}
+
+static void
+test_list_snapshot_threads(void **state)
+{
+  pthread_t threads[NREADERS];
+  struct reader_args args[NREADERS];
+  atomic_bool done;
+  list_t lst;
+  void *ret;
+  long i;
+  int err;
+
+  /* the counting destructor is not thread safe */
+  err = list_init_mode(&lst, NULL, NULL, LIST_MODE_SNAPSHOT);
+  assert_int_equal(err, UTILS_OK);
+  atomic_init(&done, false);
+  for (i = 0; i < NREADERS; i++) {
+    args[i].lst = lst;
+    args[i].done = &done;
+    pthread_create(&threads[i], NULL, reader, &args[i]);
+  }
+  for (i = 0; i < NVERSIONS; i++) {
+    err = list_append(lst, (void *)i);
+    assert_int_equal(err, UTILS_OK);
+    err = list_publish(lst);
+    assert_int_equal(err, UTILS_OK);
+  }
+  atomic_store(&done, true);
+  for (i = 0; i < NREADERS; i++) {
+    pthread_join(threads[i], &ret);
+    assert_ptr_equal(ret, &args[i]);
+  }
+  list_destroy(lst);
+}
+
+int
+main(int argc, char *argv[])
+{
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test_setup_teardown(test_list_publish,
+				    setup_list_snapshot,
+				    teardown_list),
+    cmocka_unit_test_setup_teardown(test_list_snapshot_readonly,
+				    setup_list_snapshot,
+				    teardown_list),
+    cmocka_unit_test(test_list_snapshot_outlives),
+    cmocka_unit_test(test_list_snapshot_threads),
+  };
+  return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,161 @@
+
+#include "list_test.h"
+
+#include <stdlib.h>
+
+/* number of items in the sorted lists */
+#define NSORT 500
+/* number of distinct keys, to have equal elements */
+#define NKEYS 37
+
+struct record {
+  int key;
+  int seq;
+};
+
+static struct record records[NSORT];
+
+static int
+record_cmp(void *a, void *b)
+{
+  return ((struct record *)a)->key - ((struct record *)b)->key;
+}
+
+static int
+check_cbk(void *item, void *args)
+{
+  struct record **prev = args;
+  struct record *curr = item;
+
+  /* equal keys keep the insertion order */
+  if (*prev != NULL && ((*prev)->key > curr->key ||
+			((*prev)->key == curr->key && (*prev)->seq > curr->seq)))
+    return UTILS_ERROR;
+  *prev = curr;
+  walk_count++;
+  return UTILS_OK;
+}
+
+static void
+check_sorted(list_t lst)
+{
+  struct record *prev = NULL;
+  int err;
+
+  walk_count = 0;
+  err = list_walk(lst, check_cbk, &prev);
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal(walk_count, NSORT);
+}
+
+static void
+fill_records(void)
+{
+  int i;
+
+  srand(1);
+  for (i = 0; i < NSORT; i++) {
+    records[i].key = rand() % NKEYS;
+    records[i].seq = i;
+  }
+}
+
+static void
+test_list_sort_modes(void **state)
+{
+  int modes[] = {0, LIST_MODE_INDEXED, LIST_MODE_UNROLLED};
+  list_t lst;
+  int m, i, err;
+
+  fill_records();
+  for (m = 0; m < 3; m++) {
+    err = list_init_mode(&lst, NULL, NULL, modes[m]);
+    assert_int_equal(err, UTILS_OK);
+    err = list_sort(lst, record_cmp);
+    assert_int_equal(err, UTILS_OK);
+    for (i = 0; i < NSORT; i++)
+      list_append(lst, &records[i]);
+    err = list_sort(lst, record_cmp);
+    assert_int_equal(err, UTILS_OK);
+    check_sorted(lst);
+    /* positional access follows the new order */
+    for (i = 1; i < NSORT; i++)
+      assert_true(record_cmp(list_get(lst, i - 1), list_get(lst, i)) <= 0);
+    list_destroy(lst);
+  }
+}
+
+static void
+test_list_sort_items(void **state)
+{
+  list_item_t item;
+  int err;
+
+  /* items are relinked, not reallocated */
+  item = list_item_get(*state, 0);
+  err = list_sort(*state, (list_cmp_t)strcmp);
+  assert_int_equal(err, UTILS_OK);
+  assert_string_equal(list_get(*state, 0), "0");
+  assert_string_equal(list_get(*state, 3), "3");
+
+  err = list_push(*state, "2");
+  assert_int_equal(err, UTILS_OK);
+  err = list_sort(*state, (list_cmp_t)strcmp);
+  assert_int_equal(err, UTILS_OK);
+  assert_string_equal(list_get(*state, 2), "2");
+  assert_string_equal(list_get(*state, 4), "3");
+  assert_ptr_equal(list_item_get(*state, 0), item);
+  assert_int_equal(ctor_count, 5);
+}
+
+static void
+test_list_insert_sorted(void **state)
+{
+  int modes[] = {0, LIST_MODE_INDEXED, LIST_MODE_UNROLLED};
+  list_t lst;
+  int m, i, err;
+
+  fill_records();
+  for (m = 0; m < 3; m++) {
+    err = list_init_mode(&lst, NULL, NULL, modes[m]);
+    assert_int_equal(err, UTILS_OK);
+    for (i = 0; i < NSORT; i++) {
+      err = list_insert_sorted(lst, &records[i], record_cmp);
+      assert_int_equal(err, UTILS_OK);
+    }
+    check_sorted(lst);
+    list_destroy(lst);
+  }
+}
+
+static void
+test_list_sort_inv(void **state)
+{
+  int err;
+
+  err = list_sort(NULL, record_cmp);
+  assert_int_equal(err, UTILS_ERROR);
+  err = list_sort(*state, NULL);
+  assert_int_equal(err, UTILS_ERROR);
+  err = list_insert_sorted(NULL, "0", record_cmp);
+  assert_int_equal(err, UTILS_ERROR);
+  err = list_insert_sorted(*state, "0", NULL);
+  assert_int_equal(err, UTILS_ERROR);
+  assert_int_equal(list_length(*state), 4);
+}
+
+int
+main(int argc, char *argv[])
+{
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test(test_list_sort_modes),
+    cmocka_unit_test_setup_teardown(test_list_sort_items,
+				    setup_list_3,
+				    teardown_list),
+    cmocka_unit_test(test_list_insert_sorted),
+    cmocka_unit_test_setup_teardown(test_list_sort_inv,
+				    setup_list_3,
+				    teardown_list),
+  };
+  return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,327 @@
+
+#include "list_test.h"
+
+#include <stdlib.h>
+
+/* position of the far insertions */
+#define FAR 1000000
+/* position of the insertions materialized by the constructor */
+#define NEAR 1000
+/* number of random operations checked against the array model */
+#define NSPARSE_OPS 4000
+/* maximum length of the model */
+#define NSPARSE_MAX 400
+
+static long model[NSPARSE_MAX];
+static int model_len = 0;
+
+/* value built by the constructor for empty elements */
+#define DEFAULT_VALUE -1L
+
+static int
+default_ctor(void **itm_data, void *data)
+{
+  long *value;
+
+  value = malloc(sizeof(long));
+  if (value == NULL)
+    return UTILS_ERROR;
+  *value = (data == NULL) ? DEFAULT_VALUE : *(long *)data;
+  *itm_data = value;
+  ctor_count++;
+  return UTILS_OK;
+}
+
+static int
+default_dtor(void *itm_data)
+{
+  free(itm_data);
+  dtor_count++;
+  return UTILS_OK;
+}
+
+static int
+setup_list_sparse(void **state)
+{
+  list_t lst;
+  int err;
+
+  ctor_count = 0;
+  dtor_count = 0;
+  walk_count = 0;
+
+  err = list_init_mode(&lst, NULL, NULL, LIST_MODE_SPARSE);
+  if (err)
+    return err;
+  *state = lst;
+  return 0;
+}
+
+static int
+setup_list_sparse_ctor(void **state)
+{
+  list_t lst;
+  int err;
+
+  ctor_count = 0;
+  dtor_count = 0;
+  walk_count = 0;
+
+  err = list_init_mode(&lst, default_ctor, default_dtor, LIST_MODE_SPARSE);
+  if (err)
+    return err;
+  *state = lst;
+  return 0;
+}
+
+static int
+teardown_list_sparse_ctor(void **state)
+{
+  int err;
+
+  err = list_destroy(*state);
+  /* every materialized element is destructed */
+  assert_int_equal(ctor_count, dtor_count);
+  return err;
+}
+
+static int
+sum_cbk(void *itm_data, void *args)
+{
+  if (itm_data != NULL)
+    *(long *)args += *(long *)itm_data;
+  walk_count++;
+  return UTILS_OK;
+}
+
+static void
+test_list_sparse_far(void **state)
+{
+  int err;
+
+  err = list_insert(*state, "far", FAR);
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal(list_length(*state), FAR + 1);
+  assert_null(list_get(*state, 0));
+  assert_null(list_get(*state, FAR / 2));
+  assert_string_equal(list_get(*state, FAR), "far");
+  assert_int_equal(list_indexof(*state, NULL), 0);
+
+  /* insert in the middle of the gap */
+  err = list_insert(*state, "mid", FAR / 2);
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal(list_length(*state), FAR + 2);
+  assert_null(list_get(*state, FAR / 2 - 1));
+  assert_string_equal(list_get(*state, FAR / 2), "mid");
+  assert_null(list_get(*state, FAR / 2 + 1));
+  assert_string_equal(list_get(*state, FAR + 1), "far");
+  assert_int_equal(list_indexof(*state, list_get(*state, FAR / 2)),
+		   FAR / 2);
+
+  /* empty elements are walked as NULL */
+  err = list_walk(*state, list_walk_cbk, NULL);
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal(walk_count, FAR + 2);
+
+  /* removing empty elements shrinks the gap */
+  assert_null(list_remove(*state, 0));
+  assert_null(list_pop(*state));
+  assert_int_equal(list_length(*state), FAR);
+  assert_string_equal(list_get(*state, FAR / 2 - 2), "mid");
+
+  /* append past the trailing data */
+  err = list_insert(*state, "end", 2 * FAR);
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal(list_length(*state), 2 * FAR + 1);
+  assert_string_equal(list_get(*state, FAR - 1), "far");
+  assert_null(list_get(*state, FAR));
+  assert_string_equal(list_get(*state, 2 * FAR), "end");
+}
+
+static void
+test_list_sparse_ctor(void **state)
+{
+  list_iter_struct_t iter;
+  long value = 7, sum;
+  long *data;
+  int err, count;
+
+  err = list_insert(*state, &value, NEAR);
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal(ctor_count, 1);
+
+  /* empty elements are built on access and keep their data */
+  data = list_get(*state, 10);
+  assert_non_null(data);
+  assert_int_equal(*data, DEFAULT_VALUE);
+  assert_ptr_equal(list_get(*state, 10), data);
+  assert_int_equal(ctor_count, 2);
+  assert_int_equal(*(long *)list_get(*state, NEAR), 7);
+  assert_int_equal(ctor_count, 2);
+
+  err = list_delete(*state, 11);
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal(ctor_count, 3);
+  assert_int_equal(dtor_count, 1);
+  assert_int_equal(list_length(*state), NEAR);
+
+  /* an iterator materializes the elements it visits */
+  count = 0;
+  for (list_iter_init_tail(*state, &iter); !list_iter_end(&iter) &&
+	 count < 4; list_iter_prev(&iter))
+    count++;
+  assert_int_equal(ctor_count, 7);
+  assert_int_equal(*(long *)list_iter_data(&iter), DEFAULT_VALUE);
+  assert_int_equal(list_iter_delete(&iter), UTILS_OK);
+  assert_int_equal(list_length(*state), NEAR - 1);
+  assert_int_equal(*(long *)list_get(*state, NEAR - 2), 7);
+
+  sum = 0;
+  walk_count = 0;
+  err = list_walk(*state, sum_cbk, &sum);
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal(walk_count, NEAR - 1);
+  assert_int_equal(sum, 7 + (NEAR - 2) * DEFAULT_VALUE);
+}
+
+static void
+test_list_sparse_random(void **state)
+{
+  list_iter_struct_t iter;
+  long value = 1;
+  int i, op, position;
+
+  srand(5);
+  model_len = 0;
+  for (i = 0; i < NSPARSE_OPS; i++) {
+    op = rand() % 5;
+    position = (model_len > 0) ? rand() % model_len : 0;
+    if (op == 0 && model_len < NSPARSE_MAX - 20) {
+      /* insert past the end */
+      position = model_len + rand() % 20;
+      assert_int_equal(list_insert(*state, (void *)value, position),
+		       UTILS_OK);
+      memset(&model[model_len], 0,
+	     (position - model_len) * sizeof(long));
+      model_len = position + 1;
+      model[position] = value++;
+    }
+    else if (op == 1 && model_len < NSPARSE_MAX) {
+      position = rand() % (model_len + 1);
+      assert_int_equal(list_insert(*state, (void *)value, position),
+		       UTILS_OK);
+      memmove(&model[position + 1], &model[position],
+	      (model_len - position) * sizeof(long));
+      model[position] = value++;
+      model_len++;
+    }
+    else if (op == 2 && model_len > 0) {
+      assert_int_equal((long)list_remove(*state, position), model[position]);
+      model_len--;
+      memmove(&model[position], &model[position + 1],
+	      (model_len - position) * sizeof(long));
+    }
+    else if (model_len > 0) {
+      assert_int_equal((long)list_get(*state, position), model[position]);
+    }
+  }
+
+  assert_int_equal(list_length(*state), model_len);
+  i = model_len - 1;
+  for (list_iter_init_tail(*state, &iter); !list_iter_end(&iter);
+       list_iter_prev(&iter))
+    assert_int_equal((long)list_iter_data(&iter), model[i--]);
+  assert_int_equal(i, -1);
+}
+
+static void
+test_list_sparse_splice(void **state)
+{
+  list_t out;
+  int err;
+
+  err = list_insert(*state, "far", FAR);
+  assert_int_equal(err, UTILS_OK);
+
+  /* split in the middle of the gap */
+  err = list_split(*state, FAR / 2, &out);
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal(list_length(*state), FAR / 2);
+  assert_int_equal(list_length(out), FAR / 2 + 1);
+  assert_null(list_get(*state, FAR / 2 - 1));
+  assert_string_equal(list_get(out, FAR / 2), "far");
+
+  /* and splice the tail back in the middle of the head gap */
+  err = list_splice(*state, 10, out);
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal(list_length(*state), FAR + 1);
+  assert_string_equal(list_get(*state, 10 + FAR / 2), "far");
+  assert_null(list_get(*state, 11 + FAR / 2));
+  list_destroy(out);
+}
+
+static int
+cmp_long(void *a, void *b)
+{
+  return (long)a - (long)b;
+}
+
+static void
+test_list_sparse_sort(void **state)
+{
+  int err;
+
+  err = list_insert(*state, (void *)3L, 2);
+  assert_int_equal(err, UTILS_OK);
+  err = list_insert(*state, (void *)1L, 5);
+  assert_int_equal(err, UTILS_OK);
+  err = list_sort(*state, cmp_long);
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal(list_length(*state), 6);
+  assert_int_equal(list_indexof(*state, (void *)1L), 4);
+  assert_int_equal(list_indexof(*state, (void *)3L), 5);
+  assert_null(list_get(*state, 3));
+  err = list_insert_sorted(*state, (void *)2L, cmp_long);
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal((long)list_get(*state, 5), 2);
+}
+
+static void
+test_list_sparse_modes(void **state)
+{
+  list_t lst;
+
+  assert_int_equal(list_init_mode(&lst, NULL, NULL,
+				  LIST_MODE_SPARSE | LIST_MODE_INDEXED),
+		   UTILS_ERROR);
+  assert_int_equal(list_init_mode(&lst, NULL, NULL,
+				  LIST_MODE_SPARSE | LIST_MODE_UNROLLED),
+		   UTILS_ERROR);
+  assert_int_equal(list_init_mode(&lst, NULL, NULL,
+				  LIST_MODE_SPARSE | LIST_MODE_HASHED),
+		   UTILS_ERROR);
+}
+
+int
+main(int argc, char *argv[])
+{
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test_setup_teardown(test_list_sparse_far,
+				    setup_list_sparse,
+				    teardown_list),
+    cmocka_unit_test_setup_teardown(test_list_sparse_ctor,
+				    setup_list_sparse_ctor,
+				    teardown_list_sparse_ctor),
+    cmocka_unit_test_setup_teardown(test_list_sparse_random,
+				    setup_list_sparse,
+				    teardown_list),
+    cmocka_unit_test_setup_teardown(test_list_sparse_splice,
+				    setup_list_sparse,
+				    teardown_list),
+    cmocka_unit_test_setup_teardown(test_list_sparse_sort,
+				    setup_list_sparse,
+				    teardown_list),
+    cmocka_unit_test(test_list_sparse_modes),
+  };
+  return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,260 @@
+
+#include "list_test.h"
+
+/* number of items in the lists of each mode */
+#define NSPLICE 100
+
+static long values[2 * NSPLICE];
+
+/**
+ * Fill a list with values from first to last, excluded
+ */
+static void
+fill_list(list_t lst, int first, int last)
+{
+  int i;
+
+  for (i = first; i < last; i++)
+    assert_int_equal(list_append(lst, &values[i]), UTILS_OK);
+}
+
+/**
+ * Check the list positions and data lookups against the values
+ * from first to last
+ */
+static void
+check_list(list_t lst, int first, int last)
+{
+  int i;
+
+  assert_int_equal(list_length(lst), last - first);
+  for (i = first; i < last; i++) {
+    assert_ptr_equal(list_get(lst, i - first), &values[i]);
+    assert_int_equal(list_indexof(lst, &values[i]), i - first);
+  }
+}
+
+static void
+test_list_concat(void **state)
+{
+  list_t src;
+  int err;
+
+  err = list_init(&src, ctor, dtor);
+  assert_int_equal(err, UTILS_OK);
+  list_append(src, "4");
+  list_append(src, "5");
+  err = list_concat(*state, src);
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal(list_length(*state), 6);
+  assert_int_equal(list_length(src), 0);
+  assert_string_equal(list_get(*state, 3), "3");
+  assert_string_equal(list_get(*state, 4), "4");
+  assert_string_equal(list_get(*state, 5), "5");
+
+  /* the source list is still usable */
+  err = list_concat(*state, src);
+  assert_int_equal(err, UTILS_OK);
+  list_push(src, "x");
+  assert_string_equal(list_get(src, 0), "x");
+  err = list_destroy(src);
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal(dtor_count, 1);
+}
+
+static void
+test_list_splice(void **state)
+{
+  list_t src;
+  int err;
+
+  err = list_init(&src, ctor, dtor);
+  assert_int_equal(err, UTILS_OK);
+  list_append(src, "a");
+  list_append(src, "b");
+  err = list_splice(*state, 2, src);
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal(list_length(*state), 6);
+  assert_string_equal(list_get(*state, 1), "1");
+  assert_string_equal(list_get(*state, 2), "a");
+  assert_string_equal(list_get(*state, 3), "b");
+  assert_string_equal(list_get(*state, 4), "2");
+
+  list_append(src, "c");
+  err = list_splice(*state, 0, src);
+  assert_int_equal(err, UTILS_OK);
+  assert_string_equal(list_get(*state, 0), "c");
+  assert_string_equal(list_get(*state, 1), "0");
+  assert_string_equal(list_get(*state, 6), "3");
+
+  /* invalid splices leave the lists unchanged */
+  list_append(src, "d");
+  err = list_splice(*state, 8, src);
+  assert_int_equal(err, UTILS_ERROR);
+  err = list_splice(*state, -1, src);
+  assert_int_equal(err, UTILS_ERROR);
+  err = list_splice(*state, 0, *state);
+  assert_int_equal(err, UTILS_ERROR);
+  err = list_concat(NULL, src);
+  assert_int_equal(err, UTILS_ERROR);
+  err = list_concat(*state, NULL);
+  assert_int_equal(err, UTILS_ERROR);
+  assert_int_equal(list_length(*state), 7);
+  assert_int_equal(list_length(src), 1);
+  list_destroy(src);
+}
+
+static void
+test_list_split(void **state)
+{
+  list_t out, tail;
+  int err;
+
+  err = list_split(*state, 1, &out);
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal(list_length(*state), 1);
+  assert_int_equal(list_length(out), 3);
+  assert_string_equal(list_get(*state, 0), "0");
+  assert_string_equal(list_get(out, 0), "1");
+  assert_string_equal(list_get(out, 2), "3");
+
+  err = list_split(out, 3, &tail);
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal(list_length(tail), 0);
+  list_destroy(tail);
+  err = list_split(out, 0, &tail);
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal(list_length(out), 0);
+  assert_int_equal(list_length(tail), 3);
+
+  err = list_split(tail, 4, &out);
+  assert_int_equal(err, UTILS_ERROR);
+  err = list_split(tail, 0, NULL);
+  assert_int_equal(err, UTILS_ERROR);
+
+  /* the new lists keep the destructor */
+  list_destroy(out);
+  list_destroy(tail);
+  assert_int_equal(dtor_count, 3);
+}
+
+static void
+test_list_splice_modes(void **state)
+{
+  int modes[] = {0, LIST_MODE_INDEXED, LIST_MODE_UNROLLED, LIST_MODE_HASHED,
+		 LIST_MODE_INDEXED | LIST_MODE_HASHED, LIST_MODE_CONCURRENT};
+  list_t dst, src, out;
+  int m, err;
+
+  for (m = 0; m < 6; m++) {
+    list_init_mode(&dst, NULL, NULL, modes[m]);
+    list_init_mode(&src, NULL, NULL, modes[m]);
+    fill_list(dst, 0, NSPLICE / 2);
+    fill_list(dst, NSPLICE + NSPLICE / 2, 2 * NSPLICE);
+    fill_list(src, NSPLICE / 2, NSPLICE + NSPLICE / 2);
+    err = list_splice(dst, NSPLICE / 2, src);
+    assert_int_equal(err, UTILS_OK);
+    check_list(dst, 0, 2 * NSPLICE);
+
+    /* split in the middle of an unrolled chunk */
+    err = list_split(dst, NSPLICE + 5, &out);
+    assert_int_equal(err, UTILS_OK);
+    check_list(dst, 0, NSPLICE + 5);
+    check_list(out, NSPLICE + 5, 2 * NSPLICE);
+    list_destroy(src);
+    err = list_split(dst, 7, &src);
+    assert_int_equal(err, UTILS_OK);
+    err = list_concat(dst, src);
+    assert_int_equal(err, UTILS_OK);
+    err = list_concat(dst, out);
+    assert_int_equal(err, UTILS_OK);
+    check_list(dst, 0, 2 * NSPLICE);
+
+    list_destroy(src);
+    list_destroy(out);
+    list_destroy(dst);
+  }
+
+  /* lists with different modes can not be merged */
+  list_init_mode(&dst, NULL, NULL, LIST_MODE_INDEXED);
+  list_init(&src, NULL, NULL);
+  list_append(src, "0");
+  err = list_concat(dst, src);
+  assert_int_equal(err, UTILS_ERROR);
+  list_destroy(src);
+  list_destroy(dst);
+}
+
+static void
+test_list_splice_pools(void **state)
+{
+  list_pool_t shared, other;
+  list_t heap, private, in_shared, in_other, out;
+  int err;
+
+  list_pool_init(&shared, 4);
+  list_pool_init(&other, 4);
+  list_init(&heap, NULL, NULL);
+  list_init_pool(&private, NULL, NULL, NULL);
+  list_init_pool(&in_shared, NULL, NULL, shared);
+  list_init_pool(&in_other, NULL, NULL, other);
+
+  /* malloc and private pool items move anywhere */
+  fill_list(heap, 0, 10);
+  fill_list(private, 10, 20);
+  err = list_concat(heap, private);
+  assert_int_equal(err, UTILS_OK);
+  fill_list(private, 20, 30);
+  err = list_concat(in_shared, private);
+  assert_int_equal(err, UTILS_OK);
+  err = list_concat(in_shared, heap);
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal(list_length(in_shared), 30);
+  assert_ptr_equal(list_get(in_shared, 0), &values[20]);
+  assert_ptr_equal(list_get(in_shared, 10), &values[0]);
+
+  /* shared pool items stay with their pool */
+  fill_list(in_other, 0, 5);
+  err = list_concat(in_shared, in_other);
+  assert_int_equal(err, UTILS_ERROR);
+  err = list_split(in_shared, 5, &out);
+  assert_int_equal(err, UTILS_OK);
+  err = list_pool_destroy(shared);
+  assert_int_equal(err, UTILS_ERROR);
+
+  /* split lists share the private pool of the source */
+  list_destroy(in_shared);
+  list_destroy(out);
+  list_destroy(private);
+  list_init_pool(&private, NULL, NULL, NULL);
+  fill_list(private, 0, 20);
+  err = list_split(private, 10, &out);
+  assert_int_equal(err, UTILS_OK);
+  list_destroy(private);
+  fill_list(out, 0, 10);
+  assert_int_equal(list_length(out), 20);
+  assert_ptr_equal(list_get(out, 0), &values[10]);
+  assert_ptr_equal(list_get(out, 10), &values[0]);
+  list_destroy(out);
+
+  list_destroy(heap);
+  list_destroy(in_other);
+  list_pool_destroy(shared);
+  list_pool_destroy(other);
+}
+
+int
+main(int argc, char *argv[])
+{
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test_setup_teardown(test_list_concat, setup_list_3,
+				    teardown_list),
+    cmocka_unit_test_setup_teardown(test_list_splice, setup_list_3,
+				    teardown_list),
+    cmocka_unit_test_setup_teardown(test_list_split, setup_list_3,
+				    teardown_list),
+    cmocka_unit_test(test_list_splice_modes),
+    cmocka_unit_test(test_list_splice_pools),
+  };
+  return cmocka_run_group_tests(tests, NULL, NULL);
+}
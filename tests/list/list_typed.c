@@ -0,0 +1,184 @@
+#include "list_test.h"
+
+#include "libutils/list_typed.h"
+
+/* number of values in the typed list tests */
+#define NVALUES 100
+
+struct point {
+  long x;
+  long y;
+};
+
+static void
+point_ctor(struct point *itm_data, struct point data)
+{
+  ctor_count++;
+  *itm_data = data;
+}
+
+static void
+point_dtor(struct point *itm_data)
+{
+  dtor_count++;
+}
+
+LIST_DECLARE(longs, long)
+LIST_DECLARE_EX(points, struct point, point_ctor, point_dtor)
+
+static int
+sum_cbk(long *itm_data, void *args)
+{
+  *(long *)args += *itm_data;
+  return (*itm_data == NVALUES / 2) ? UTILS_ITER_STOP : UTILS_OK;
+}
+
+/* fails on the first item with a code other than UTILS_ERROR */
+static int
+fail_cbk(long *itm_data, void *args)
+{
+  return -1;
+}
+
+static void
+test_list_typed_data(void **state)
+{
+  longs_t lst;
+  long value, sum = 0;
+  long *ptr;
+  int i, err;
+
+  err = longs_init(&lst);
+  assert_int_equal(err, UTILS_OK);
+  for (i = 0; i < NVALUES; i++) {
+    err = longs_append(lst, i);
+    assert_int_equal(err, UTILS_OK);
+  }
+  err = longs_push(lst, -1);
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal(longs_length(lst), NVALUES + 1);
+  assert_int_equal(*longs_get(lst, 0), -1);
+  assert_int_equal(*longs_get(lst, NVALUES), NVALUES - 1);
+  assert_null(longs_get(lst, NVALUES + 1));
+
+  /* values are stored in the list */
+  ptr = longs_get(lst, 70);
+  *ptr = 700;
+  assert_int_equal(*longs_get(lst, 70), 700);
+  assert_int_equal(longs_indexof(lst, ptr), 70);
+  assert_true(longs_indexof(lst, &value) < 0);
+
+  err = longs_pop(lst, &value);
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal(value, -1);
+  err = longs_remove(lst, 10, &value);
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal(value, 10);
+  err = longs_delete(lst, 10);
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal(*longs_get(lst, 10), 12);
+  assert_int_equal(longs_delete(lst, NVALUES), UTILS_ERROR);
+  assert_int_equal(longs_remove(lst, 0, NULL), UTILS_ERROR);
+
+  /* insertion past the end pads with zeroed values */
+  err = longs_insert(lst, 42, NVALUES + 2);
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal(longs_length(lst), NVALUES + 3);
+  assert_int_equal(*longs_get(lst, NVALUES - 3), 99);
+  for (i = NVALUES - 2; i < NVALUES + 2; i++)
+    assert_int_equal(*longs_get(lst, i), 0);
+  assert_int_equal(*longs_get(lst, NVALUES + 2), 42);
+
+  err = longs_walk(lst, sum_cbk, &sum);
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal(sum, (NVALUES / 2) * (NVALUES / 2 + 1) / 2 - 10 - 11);
+  assert_int_equal(longs_walk(lst, fail_cbk, NULL), UTILS_ERROR);
+  longs_destroy(lst);
+}
+
+static void
+test_list_typed_iter(void **state)
+{
+  longs_t lst;
+  longs_iter_struct_t iter;
+  long value;
+  int i, err;
+
+  longs_init(&lst);
+  longs_iter_init(lst, &iter);
+  assert_true(longs_iter_end(&iter));
+  assert_null(longs_iter_data(&iter));
+  for (i = 0; i < NVALUES; i++)
+    longs_append(lst, i);
+
+  /* filter the odd values in a single pass */
+  for (longs_iter_init(lst, &iter); !longs_iter_end(&iter);
+       longs_iter_next(&iter))
+    if (*longs_iter_data(&iter) % 2)
+      longs_iter_delete(&iter);
+  assert_int_equal(longs_length(lst), NVALUES / 2);
+
+  i = NVALUES - 2;
+  for (longs_iter_init_tail(lst, &iter); !longs_iter_end(&iter);
+       longs_iter_prev(&iter)) {
+    assert_int_equal(*longs_iter_data(&iter), i);
+    i -= 2;
+  }
+  assert_int_equal(i, -2);
+
+  err = longs_iter_seek(&iter, NVALUES / 2 - 1);
+  assert_int_equal(err, UTILS_OK);
+  err = longs_iter_remove(&iter, &value);
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal(value, NVALUES - 2);
+  assert_null(longs_iter_data(&iter));
+  /* the removed value was the last, step back to the new last */
+  longs_iter_prev(&iter);
+  assert_int_equal(*longs_iter_data(&iter), NVALUES - 4);
+  assert_int_equal(longs_iter_seek(&iter, NVALUES), UTILS_ERROR);
+  assert_true(longs_iter_end(&iter));
+  longs_destroy(lst);
+}
+
+static void
+test_list_typed_ctor(void **state)
+{
+  points_t lst;
+  struct point p;
+  int i, err;
+
+  ctor_count = 0;
+  dtor_count = 0;
+  err = points_init(&lst);
+  assert_int_equal(err, UTILS_OK);
+  for (i = 0; i < NVALUES; i++) {
+    p.x = i;
+    p.y = -i;
+    points_append(lst, p);
+  }
+  points_insert(lst, p, NVALUES + 1);
+  assert_int_equal(ctor_count, NVALUES + 2);
+  assert_int_equal(points_get(lst, NVALUES)->x, 0);
+
+  /* removed values are moved out without being destructed */
+  err = points_remove(lst, 5, &p);
+  assert_int_equal(err, UTILS_OK);
+  assert_true(p.x == 5 && p.y == -5);
+  assert_int_equal(dtor_count, 0);
+  points_delete(lst, 0);
+  assert_int_equal(dtor_count, 1);
+  points_destroy(lst);
+  assert_int_equal(dtor_count, NVALUES + 1);
+  assert_int_equal(points_init(NULL), UTILS_ERROR);
+}
+
+int
+main(int argc, char *argv[])
+{
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test(test_list_typed_data),
+    cmocka_unit_test(test_list_typed_iter),
+    cmocka_unit_test(test_list_typed_ctor),
+  };
+  return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,220 @@
+
+#include "list_test.h"
+
+#include <stdlib.h>
+
+/* number of items used in the randomized test */
+#define NITEMS 512
+
+static int
+setup_list_unrolled(void **state)
+{
+  list_t lst;
+  int err;
+
+  ctor_count = 0;
+  dtor_count = 0;
+  walk_count = 0;
+
+  err = list_init_mode(&lst, ctor, dtor, LIST_MODE_UNROLLED);
+  if (err)
+    return err;
+  *state = lst;
+  return 0;
+}
+
+static int
+setup_list_unrolled_100(void **state)
+{
+  long i;
+  int err;
+
+  err = setup_list_unrolled(state);
+  if (err)
+    return err;
+  for (i = 0; i < 100; i++) {
+    err = list_append(*state, (void *)i);
+    if (err)
+      return err;
+  }
+  return 0;
+}
+
+static int
+walk_stop_cbk(void *item, void *args)
+{
+  walk_count++;
+  if ((long)item == (long)args)
+    return UTILS_ITER_STOP;
+  return UTILS_OK;
+}
+
+static void
+test_list_unrolled_push_pop(void **state)
+{
+  int err;
+
+  err = list_push(*state, "1");
+  assert_int_equal(err, UTILS_OK);
+  err = list_push(*state, "0");
+  assert_int_equal(err, UTILS_OK);
+  err = list_insert(*state, "3", 3);
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal(list_length(*state), 4);
+  /* the ctor is called also for the empty item list[2] */
+  assert_int_equal(ctor_count, 4);
+
+  assert_string_equal(list_pop(*state), "0");
+  assert_string_equal(list_pop(*state), "1");
+  assert_null(list_pop(*state));
+  assert_string_equal(list_pop(*state), "3");
+  assert_null(list_pop(*state));
+  assert_int_equal(list_length(*state), 0);
+  assert_int_equal(dtor_count, 0);
+}
+
+static void
+test_list_unrolled_get(void **state)
+{
+  long i;
+
+  for (i = 0; i < 100; i++)
+    assert_int_equal((long)list_get(*state, i), i);
+  assert_null(list_get(*state, 100));
+  assert_null(list_get(*state, -1));
+  assert_int_equal(list_indexof(*state, (void *)42), 42);
+  assert_int_equal(list_indexof(*state, (void *)100), -1);
+  /* no item handles in unrolled lists */
+  assert_null(list_item_get(*state, 0));
+}
+
+static void
+test_list_unrolled_walk(void **state)
+{
+  int err;
+
+  err = list_walk(*state, list_walk_cbk, NULL);
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal(walk_count, 100);
+
+  walk_count = 0;
+  err = list_walk(*state, walk_stop_cbk, (void *)50);
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal(walk_count, 51);
+}
+
+static void
+test_list_unrolled_iter(void **state)
+{
+  list_iter_struct_t iter;
+  long expect;
+  int rc;
+
+  expect = 0;
+  for (list_iter_init(*state, &iter); !list_iter_end(&iter);
+       list_iter_next(&iter)) {
+    assert_int_equal((long)list_iter_data(&iter), expect);
+    expect++;
+  }
+  assert_int_equal(expect, 100);
+  assert_null(list_iter_data(&iter));
+
+  rc = list_iter_seek(&iter, 77);
+  assert_int_equal(rc, UTILS_OK);
+  assert_false(list_iter_end(&iter));
+  assert_int_equal((long)list_iter_data(&iter), 77);
+  rc = list_iter_seek(&iter, 100);
+  assert_int_equal(rc, UTILS_ERROR);
+}
+
+static void
+test_list_unrolled_random(void **state)
+{
+  /* compare the list against an array after random operations */
+  long ref[NITEMS];
+  long value, data;
+  int len = 0;
+  int i, pos, err;
+
+  srand(1);
+  for (value = 1; value < 4 * NITEMS; value++) {
+    if (len == 0 || (len < NITEMS && rand() % 3 != 0)) {
+      pos = rand() % (len + 1);
+      err = list_insert(*state, (void *)value, pos);
+      assert_int_equal(err, UTILS_OK);
+      memmove(&ref[pos + 1], &ref[pos], (len - pos) * sizeof(long));
+      ref[pos] = value;
+      len++;
+    }
+    else {
+      pos = rand() % len;
+      data = (long)list_remove(*state, pos);
+      assert_int_equal(data, ref[pos]);
+      memmove(&ref[pos], &ref[pos + 1], (len - pos - 1) * sizeof(long));
+      len--;
+    }
+  }
+  assert_int_equal(list_length(*state), len);
+  for (i = 0; i < len; i++)
+    assert_int_equal((long)list_get(*state, i), ref[i]);
+}
+
+static void
+test_list_unrolled_destroy(void **state)
+{
+  int err;
+
+  err = list_destroy(*state);
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal(dtor_count, 100);
+}
+
+static void
+test_list_unrolled_item_delete(void **state)
+{
+  /* unrolled lists have no item handles */
+  assert_null(list_item_get(*state, 0));
+  assert_int_equal(list_item_delete(*state, NULL), UTILS_ERROR);
+  assert_int_equal(dtor_count, 0);
+  assert_int_equal(list_length(*state), 100);
+}
+
+static void
+test_list_unrolled_inv_mode(void **state)
+{
+  list_t lst;
+  int err;
+
+  err = list_init_mode(&lst, NULL, NULL,
+		       LIST_MODE_UNROLLED | LIST_MODE_INDEXED);
+  assert_int_equal(err, UTILS_ERROR);
+}
+
+int
+main(int argc, char *argv[])
+{
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test_setup_teardown(test_list_unrolled_push_pop,
+				    setup_list_unrolled,
+				    teardown_list),
+    cmocka_unit_test_setup_teardown(test_list_unrolled_get,
+				    setup_list_unrolled_100,
+				    teardown_list),
+    cmocka_unit_test_setup_teardown(test_list_unrolled_walk,
+				    setup_list_unrolled_100,
+				    teardown_list),
+    cmocka_unit_test_setup_teardown(test_list_unrolled_iter,
+				    setup_list_unrolled_100,
+				    teardown_list),
+    cmocka_unit_test_setup_teardown(test_list_unrolled_random,
+				    setup_list_unrolled,
+				    teardown_list),
+    cmocka_unit_test_setup(test_list_unrolled_destroy,
+			   setup_list_unrolled_100),
+    cmocka_unit_test_setup_teardown(test_list_unrolled_item_delete,
+				    setup_list_unrolled_100,
+				    teardown_list),
+    cmocka_unit_test(test_list_unrolled_inv_mode),
+  };
+  return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,170 @@
+#include "list_test.h"
+
+/* number of values in the value tests */
+#define NVALUES 1000
+
+struct point {
+  double x;
+  double y;
+};
+
+static int
+sum_cbk(void *itm_data, void *args)
+{
+  struct point *p = itm_data;
+
+  *(double *)args += p->x + p->y;
+  return UTILS_OK;
+}
+
+static void
+test_list_value_copy(void **state)
+{
+  int modes[] = {
+    0, LIST_MODE_INDEXED, LIST_MODE_CONCURRENT | LIST_MODE_HASHED,
+  };
+  struct point p, *stored;
+  list_iter_struct_t iter;
+  list_t lst;
+  double sum;
+  int i, m, err;
+
+  for (m = 0; m < sizeof(modes) / sizeof(modes[0]); m++) {
+    err = list_init_value(&lst, sizeof(struct point), modes[m]);
+    assert_int_equal(err, UTILS_OK);
+    for (i = 0; i < NVALUES; i++) {
+      p.x = i;
+      p.y = -2 * i;
+      err = list_append(lst, &p);
+      assert_int_equal(err, UTILS_OK);
+    }
+    /* the list holds a copy of the values */
+    p.x = 42;
+    stored = list_get(lst, 10);
+    assert_non_null(stored);
+    assert_true(stored != &p);
+    assert_true(stored->x == 10 && stored->y == -20);
+    assert_int_equal(list_indexof(lst, stored), 10);
+
+    err = list_get_value(lst, NVALUES - 1, &p);
+    assert_int_equal(err, UTILS_OK);
+    assert_true(p.x == NVALUES - 1 && p.y == -2 * (NVALUES - 1));
+    assert_int_equal(list_get_value(lst, NVALUES, &p), UTILS_ERROR);
+
+    sum = 0;
+    err = list_walk(lst, sum_cbk, &sum);
+    assert_int_equal(err, UTILS_OK);
+    assert_true(sum == -(double)NVALUES * (NVALUES - 1) / 2);
+
+    /* values are updated in place */
+    i = 0;
+    for (list_iter_init(lst, &iter); !list_iter_end(&iter);
+	 list_iter_next(&iter)) {
+      stored = list_iter_data(&iter);
+      stored->y = i++;
+    }
+    err = list_remove_value(lst, 3, &p);
+    assert_int_equal(err, UTILS_OK);
+    assert_true(p.x == 3 && p.y == 3);
+    err = list_remove_value(lst, 0, NULL);
+    assert_int_equal(err, UTILS_OK);
+    assert_int_equal(list_length(lst), NVALUES - 2);
+    err = list_get_value(lst, 2, &p);
+    assert_int_equal(err, UTILS_OK);
+    assert_true(p.x == 4 && p.y == 4);
+    list_destroy(lst);
+  }
+}
+
+static void
+test_list_value_remove(void **state)
+{
+  list_iter_struct_t iter;
+  list_t lst, out;
+  long value, values[10];
+  void *data[10];
+  long i;
+  int err;
+
+  err = list_init_value(&lst, sizeof(long), LIST_MODE_INDEXED);
+  assert_int_equal(err, UTILS_OK);
+  for (i = 0; i < 10; i++) {
+    values[i] = i;
+    data[i] = &values[i];
+  }
+  err = list_append_n(lst, data, 10);
+  assert_int_equal(err, UTILS_OK);
+  /* the positions skipped by an insertion hold zeroed values */
+  value = 7;
+  err = list_insert(lst, &value, 12);
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal(*(long *)list_get(lst, 10), 0);
+  assert_int_equal(*(long *)list_get(lst, 11), 0);
+
+  /* the removed values can not be returned by address */
+  assert_null(list_remove(lst, 0));
+  assert_null(list_pop(lst));
+  assert_null(list_item_remove(lst, list_item_get(lst, 0)));
+  list_iter_init(lst, &iter);
+  assert_null(list_iter_remove(&iter));
+  assert_int_equal(list_length(lst), 13);
+
+  err = list_iter_delete(&iter);
+  assert_int_equal(err, UTILS_OK);
+  err = list_item_delete(lst, list_item_get(lst, 0));
+  assert_int_equal(err, UTILS_OK);
+  err = list_delete(lst, 10);
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal(list_length(lst), 10);
+  assert_int_equal(*(long *)list_get(lst, 0), 2);
+
+  /* items move between value lists of the same size */
+  err = list_split(lst, 5, &out);
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal(list_get_value(out, 0, &value), UTILS_OK);
+  assert_int_equal(value, 7);
+  err = list_concat(out, lst);
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal(list_length(out), 10);
+  assert_int_equal(list_get_value(out, 5, &value), UTILS_OK);
+  assert_int_equal(value, 2);
+  list_destroy(lst);
+
+  err = list_init_value(&lst, sizeof(int), LIST_MODE_INDEXED);
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal(list_concat(out, lst), UTILS_ERROR);
+  list_destroy(lst);
+  err = list_init_mode(&lst, NULL, NULL, LIST_MODE_INDEXED);
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal(list_concat(lst, out), UTILS_ERROR);
+  assert_int_equal(list_get_value(lst, 0, &value), UTILS_ERROR);
+  assert_int_equal(list_remove_value(lst, 0, &value), UTILS_ERROR);
+  list_destroy(lst);
+  list_destroy(out);
+}
+
+static void
+test_list_value_modes(void **state)
+{
+  list_t lst;
+
+  assert_int_equal(list_init_value(&lst, 0, 0), UTILS_ERROR);
+  assert_int_equal(list_init_value(&lst, 8, LIST_MODE_UNROLLED),
+		   UTILS_ERROR);
+  assert_int_equal(list_init_value(&lst, 8, LIST_MODE_SPARSE),
+		   UTILS_ERROR);
+  assert_int_equal(list_init_value(&lst, 8, LIST_MODE_SNAPSHOT),
+		   UTILS_ERROR);
+  assert_int_equal(list_init_value(NULL, 8, 0), UTILS_ERROR);
+}
+
+int
+main(int argc, char *argv[])
+{
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test(test_list_value_copy),
+    cmocka_unit_test(test_list_value_remove),
+    cmocka_unit_test(test_list_value_modes),
+  };
+  return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,119 @@
+
+#include "list_test.h"
+
+#include <stdatomic.h>
+
+/* number of items in the walked lists */
+#define NWALK 1000
+
+static atomic_long visit_sum;
+static atomic_int visit_count;
+
+static int
+sum_cbk(void *item, void *args)
+{
+  atomic_fetch_add(&visit_sum, (long)item);
+  atomic_fetch_add(&visit_count, 1);
+  return UTILS_OK;
+}
+
+static int
+stop_cbk(void *item, void *args)
+{
+  atomic_fetch_add(&visit_count, 1);
+  if ((long)item == *(long *)args)
+    return UTILS_ITER_STOP;
+  return UTILS_OK;
+}
+
+static int
+err_cbk(void *item, void *args)
+{
+  atomic_fetch_add(&visit_count, 1);
+  if ((long)item == *(long *)args)
+    return UTILS_ERROR;
+  return UTILS_OK;
+}
+
+static void
+test_list_walk_parallel_modes(void **state)
+{
+  int modes[] = {0, LIST_MODE_INDEXED, LIST_MODE_UNROLLED,
+		 LIST_MODE_CONCURRENT};
+  int nthreads[] = {1, 2, 3, 8, 2 * NWALK};
+  list_t lst;
+  long i;
+  int m, t, err;
+
+  for (m = 0; m < 4; m++) {
+    err = list_init_mode(&lst, NULL, NULL, modes[m]);
+    assert_int_equal(err, UTILS_OK);
+    for (i = 1; i <= NWALK; i++)
+      list_append(lst, (void *)i);
+    for (t = 0; t < 5; t++) {
+      atomic_store(&visit_sum, 0);
+      atomic_store(&visit_count, 0);
+      err = list_walk_parallel(lst, sum_cbk, NULL, nthreads[t]);
+      assert_int_equal(err, UTILS_OK);
+      /* every item is visited exactly once */
+      assert_int_equal(atomic_load(&visit_count), NWALK);
+      assert_int_equal(atomic_load(&visit_sum), NWALK * (NWALK + 1) / 2);
+    }
+    list_destroy(lst);
+  }
+}
+
+static void
+test_list_walk_parallel_stop(void **state)
+{
+  list_t lst;
+  long i, target = 10;
+  int err;
+
+  list_init(&lst, NULL, NULL);
+  for (i = 1; i <= NWALK; i++)
+    list_append(lst, (void *)i);
+
+  atomic_store(&visit_count, 0);
+  err = list_walk_parallel(lst, stop_cbk, &target, 4);
+  assert_int_equal(err, UTILS_OK);
+  assert_true(atomic_load(&visit_count) >= target);
+  assert_true(atomic_load(&visit_count) <= NWALK);
+
+  atomic_store(&visit_count, 0);
+  target = NWALK;
+  err = list_walk_parallel(lst, err_cbk, &target, 4);
+  assert_int_equal(err, UTILS_ERROR);
+  assert_true(atomic_load(&visit_count) >= 1);
+
+  list_destroy(lst);
+}
+
+static void
+test_list_walk_parallel_inv(void **state)
+{
+  int err;
+
+  err = list_walk_parallel(NULL, sum_cbk, NULL, 2);
+  assert_int_equal(err, UTILS_ERROR);
+  err = list_walk_parallel(*state, NULL, NULL, 2);
+  assert_int_equal(err, UTILS_ERROR);
+  err = list_walk_parallel(*state, sum_cbk, NULL, 0);
+  assert_int_equal(err, UTILS_ERROR);
+  /* empty list */
+  err = list_walk_parallel(*state, sum_cbk, NULL, 4);
+  assert_int_equal(err, UTILS_OK);
+}
+
+int
+main(int argc, char *argv[])
+{
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test(test_list_walk_parallel_modes),
+    cmocka_unit_test(test_list_walk_parallel_stop),
+    cmocka_unit_test_setup_teardown(test_list_walk_parallel_inv,
+				    setup_list_empty,
+				    teardown_list),
+  };
+  return cmocka_run_group_tests(tests, NULL, NULL);
+}
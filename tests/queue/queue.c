@@ -0,0 +1,184 @@
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <pthread.h>
+#include <stdlib.h>
+
+#include "libutils/error.h"
+#include "libutils/queue.h"
+
+/* number of producer and consumer threads */
+#define NPRODUCERS 4
+#define NCONSUMERS 4
+/* number of items pushed by each producer */
+#define NITEMS 20000
+
+static int dtor_count = 0;
+
+struct worker_args {
+  queue_t queue;
+  long id;
+  long count;
+  long sum;
+  char *seen;
+};
+
+static int
+dtor(void *data)
+{
+  dtor_count++;
+  return UTILS_OK;
+}
+
+static int
+setup_queue(void **state)
+{
+  queue_t queue;
+  int err;
+
+  dtor_count = 0;
+  err = queue_init(&queue, dtor);
+  if (err)
+    return err;
+  *state = queue;
+  return 0;
+}
+
+static int
+teardown_queue(void **state)
+{
+  return queue_destroy(*state);
+}
+
+static void
+test_queue_inv_hnd(void **state)
+{
+  int err;
+
+  err = queue_init(NULL, NULL);
+  assert_int_equal(err, UTILS_ERROR);
+  err = queue_destroy(NULL);
+  assert_int_equal(err, UTILS_ERROR);
+  err = queue_push(NULL, NULL);
+  assert_int_equal(err, UTILS_ERROR);
+  assert_null(queue_pop(NULL));
+  assert_true(queue_length(NULL) < 0);
+}
+
+static void
+test_queue_fifo(void **state)
+{
+  long i;
+  int err;
+
+  assert_null(queue_pop(*state));
+  for (i = 1; i <= 100; i++) {
+    err = queue_push(*state, (void *)i);
+    assert_int_equal(err, UTILS_OK);
+  }
+  assert_int_equal(queue_length(*state), 100);
+  for (i = 1; i <= 50; i++)
+    assert_int_equal((long)queue_pop(*state), i);
+  assert_int_equal(queue_length(*state), 50);
+  assert_int_equal(dtor_count, 0);
+}
+
+static void
+test_queue_destroy(void **state)
+{
+  queue_t queue;
+  long i;
+  int err;
+
+  dtor_count = 0;
+  err = queue_init(&queue, dtor);
+  assert_int_equal(err, UTILS_OK);
+  for (i = 1; i <= 10; i++)
+    queue_push(queue, (void *)i);
+  queue_pop(queue);
+  err = queue_destroy(queue);
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal(dtor_count, 9);
+}
+
+static void *
+producer(void *data)
+{
+  struct worker_args *args = data;
+  long i;
+
+  for (i = 0; i < NITEMS; i++)
+    queue_push(args->queue, (void *)(args->id * NITEMS + i + 1));
+  return NULL;
+}
+
+static void *
+consumer(void *data)
+{
+  struct worker_args *args = data;
+  long item;
+
+  while (args->count < NPRODUCERS * NITEMS / NCONSUMERS) {
+    item = (long)queue_pop(args->queue);
+    if (item == 0)
+      continue;
+    args->seen[item - 1]++;
+    args->count++;
+  }
+  return NULL;
+}
+
+static void
+test_queue_stress(void **state)
+{
+  pthread_t threads[NPRODUCERS + NCONSUMERS];
+  struct worker_args args[NPRODUCERS + NCONSUMERS];
+  char *seen[NCONSUMERS];
+  long i, total;
+  int c;
+
+  for (i = 0; i < NCONSUMERS; i++)
+    seen[i] = calloc(NPRODUCERS * NITEMS, 1);
+  for (i = 0; i < NPRODUCERS + NCONSUMERS; i++) {
+    args[i].queue = *state;
+    args[i].id = i;
+    args[i].count = 0;
+    if (i < NPRODUCERS) {
+      pthread_create(&threads[i], NULL, producer, &args[i]);
+    } else {
+      args[i].seen = seen[i - NPRODUCERS];
+      pthread_create(&threads[i], NULL, consumer, &args[i]);
+    }
+  }
+  for (i = 0; i < NPRODUCERS + NCONSUMERS; i++)
+    pthread_join(threads[i], NULL);
+
+  /* every item is popped exactly once */
+  assert_int_equal(queue_length(*state), 0);
+  assert_null(queue_pop(*state));
+  for (i = 0; i < NPRODUCERS * NITEMS; i++) {
+    total = 0;
+    for (c = 0; c < NCONSUMERS; c++)
+      total += seen[c][i];
+    assert_int_equal(total, 1);
+  }
+  for (i = 0; i < NCONSUMERS; i++)
+    free(seen[i]);
+}
+
+int
+main(int argc, char *argv[])
+{
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test(test_queue_inv_hnd),
+    cmocka_unit_test_setup_teardown(test_queue_fifo,
+				    setup_queue, teardown_queue),
+    cmocka_unit_test(test_queue_destroy),
+    cmocka_unit_test_setup_teardown(test_queue_stress,
+				    setup_queue, teardown_queue),
+  };
+  return cmocka_run_group_tests(tests, NULL, NULL);
+}
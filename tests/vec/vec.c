@@ -0,0 +1,292 @@
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <string.h>
+
+#include "libutils/error.h"
+#include "libutils/vec.h"
+
+/* count calls to item ctor and dtor */
+static int ctor_count = 0;
+static int dtor_count = 0;
+static int walk_count = 0;
+
+static int
+ctor(void **item, void *data)
+{
+  ctor_count++;
+  *item = data;
+  return UTILS_OK;
+}
+
+static int
+dtor(void *data)
+{
+  dtor_count++;
+  return UTILS_OK;
+}
+
+static int
+walk_cbk(void *item, void *args)
+{
+  walk_count++;
+  if (args != NULL && strcmp(item, args) == 0)
+    return UTILS_ITER_STOP;
+  return UTILS_OK;
+}
+
+static int
+setup_vec_empty(void **state)
+{
+  vec_t vec;
+  int err;
+
+  ctor_count = 0;
+  dtor_count = 0;
+  walk_count = 0;
+
+  err = vec_init(&vec, ctor, dtor);
+  if (err)
+    return err;
+  *state = vec;
+  return 0;
+}
+
+static int
+setup_vec_3(void **state)
+{
+  int err;
+
+  err = setup_vec_empty(state);
+  if (err)
+    return err;
+  err = vec_append(*state, "0");
+  if (err)
+    return err;
+  err = vec_append(*state, "1");
+  if (err)
+    return err;
+  err = vec_append(*state, "2");
+  if (err)
+    return err;
+  err = vec_append(*state, "3");
+  if (err)
+    return err;
+  return 0;
+}
+
+static int
+teardown_vec(void **state)
+{
+  return vec_destroy(*state);
+}
+
+static void
+test_vec_inv_hnd(void **state)
+{
+  int err;
+
+  err = vec_init(NULL, NULL, NULL);
+  assert_int_equal(err, UTILS_ERROR);
+  err = vec_destroy(NULL);
+  assert_int_equal(err, UTILS_ERROR);
+  err = vec_append(NULL, "0");
+  assert_int_equal(err, UTILS_ERROR);
+  err = vec_insert(NULL, "0", 0);
+  assert_int_equal(err, UTILS_ERROR);
+  err = vec_walk(NULL, walk_cbk, NULL);
+  assert_int_equal(err, UTILS_ERROR);
+  err = vec_reserve(NULL, 1);
+  assert_int_equal(err, UTILS_ERROR);
+  assert_true(vec_length(NULL) < 0);
+  assert_null(vec_get(NULL, 0));
+  assert_null(vec_pop(NULL));
+  err = vec_push(NULL, "0");
+  assert_int_equal(err, UTILS_ERROR);
+  err = vec_iter_init(NULL, NULL);
+  assert_int_equal(err, UTILS_ERROR);
+  assert_null(vec_remove(NULL, 0));
+}
+
+static void
+test_vec_append_get(void **state)
+{
+  int err, i;
+
+  for (i = 0; i < 100; i++) {
+    err = vec_append(*state, "x");
+    assert_int_equal(err, UTILS_OK);
+  }
+  assert_int_equal(vec_length(*state), 100);
+  assert_int_equal(ctor_count, 100);
+  assert_true(vec_capacity(*state) >= 100);
+  for (i = 0; i < 100; i++)
+    assert_string_equal(vec_get(*state, i), "x");
+  assert_null(vec_get(*state, 100));
+  assert_null(vec_get(*state, -1));
+}
+
+static void
+test_vec_insert(void **state)
+{
+  int err;
+
+  err = vec_insert(*state, "1", 0);
+  assert_int_equal(err, UTILS_OK);
+  err = vec_insert(*state, "0", 0);
+  assert_int_equal(err, UTILS_OK);
+  /* element 2 is created automatically */
+  err = vec_insert(*state, "3", 3);
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal(vec_length(*state), 4);
+  assert_int_equal(ctor_count, 4);
+
+  assert_string_equal(vec_get(*state, 0), "0");
+  assert_string_equal(vec_get(*state, 1), "1");
+  assert_null(vec_get(*state, 2));
+  assert_string_equal(vec_get(*state, 3), "3");
+
+  err = vec_insert(*state, "x", -1);
+  assert_int_equal(err, UTILS_ERROR);
+}
+
+static void
+test_vec_remove(void **state)
+{
+  int err;
+
+  assert_string_equal(vec_remove(*state, 1), "1");
+  assert_string_equal(vec_get(*state, 1), "2");
+  /* pop from the head as list_pop */
+  assert_string_equal(vec_pop(*state), "0");
+  assert_int_equal(vec_length(*state), 2);
+  assert_null(vec_remove(*state, 2));
+  assert_int_equal(dtor_count, 0);
+
+  err = vec_delete(*state, 0);
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal(dtor_count, 1);
+  assert_string_equal(vec_get(*state, 0), "3");
+  err = vec_delete(*state, 1);
+  assert_int_equal(err, UTILS_ERROR);
+  assert_int_equal(vec_length(*state), 1);
+}
+
+static void
+test_vec_indexof(void **state)
+{
+  void **data;
+
+  assert_int_equal(vec_indexof(*state, vec_get(*state, 2)), 2);
+  assert_int_equal(vec_indexof(*state, "4"), -1);
+  data = vec_data(*state);
+  assert_ptr_equal(data[3], vec_get(*state, 3));
+}
+
+static void
+test_vec_walk(void **state)
+{
+  int err;
+
+  err = vec_walk(*state, walk_cbk, NULL);
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal(walk_count, 4);
+
+  walk_count = 0;
+  err = vec_walk(*state, walk_cbk, "1");
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal(walk_count, 2);
+}
+
+static void
+test_vec_reserve_shrink(void **state)
+{
+  int err;
+
+  err = vec_reserve(*state, 64);
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal(vec_capacity(*state), 64);
+  /* reserve never shrinks */
+  err = vec_reserve(*state, 8);
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal(vec_capacity(*state), 64);
+
+  err = vec_shrink(*state);
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal(vec_capacity(*state), 4);
+  assert_string_equal(vec_get(*state, 3), "3");
+}
+
+static void
+test_vec_argparse(void **state)
+{
+  const char *names[] = {"a", "b", "c"};
+  vec_iter_struct_t iter;
+  int err, i;
+
+  /* options are pushed and then looked up with an iterator */
+  for (i = 0; i < 3; i++) {
+    err = vec_push(*state, (void *)names[i]);
+    assert_int_equal(err, UTILS_OK);
+  }
+  i = 2;
+  for (vec_iter_init(*state, &iter); !vec_iter_end(&iter);
+       vec_iter_next(&iter))
+    assert_ptr_equal(vec_iter_data(&iter), names[i--]);
+  assert_int_equal(i, -1);
+  assert_null(vec_iter_data(&iter));
+
+  /* the subcommand stack pops the last pushed parser */
+  err = vec_push(*state, "d");
+  assert_int_equal(err, UTILS_OK);
+  assert_string_equal(vec_pop(*state), "d");
+  for (i = 2; i >= 0; i--)
+    assert_ptr_equal(vec_pop(*state), names[i]);
+  assert_null(vec_pop(*state));
+  vec_iter_init(*state, &iter);
+  assert_true(vec_iter_end(&iter));
+}
+
+static void
+test_vec_destroy(void **state)
+{
+  int err;
+
+  err = vec_destroy(*state);
+  assert_int_equal(err, UTILS_OK);
+  assert_int_equal(dtor_count, 4);
+}
+
+int
+main(int argc, char *argv[])
+{
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test(test_vec_inv_hnd),
+    cmocka_unit_test_setup_teardown(test_vec_append_get,
+				    setup_vec_empty,
+				    teardown_vec),
+    cmocka_unit_test_setup_teardown(test_vec_insert,
+				    setup_vec_empty,
+				    teardown_vec),
+    cmocka_unit_test_setup_teardown(test_vec_remove,
+				    setup_vec_3,
+				    teardown_vec),
+    cmocka_unit_test_setup_teardown(test_vec_indexof,
+				    setup_vec_3,
+				    teardown_vec),
+    cmocka_unit_test_setup_teardown(test_vec_walk,
+				    setup_vec_3,
+				    teardown_vec),
+    cmocka_unit_test_setup_teardown(test_vec_reserve_shrink,
+				    setup_vec_3,
+				    teardown_vec),
+    cmocka_unit_test_setup_teardown(test_vec_argparse,
+				    setup_vec_empty,
+				    teardown_vec),
+    cmocka_unit_test_setup(test_vec_destroy, setup_vec_3),
+  };
+  return cmocka_run_group_tests(tests, NULL, NULL);
+}